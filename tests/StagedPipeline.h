@@ -0,0 +1,81 @@
+#pragma once
+#include "ReadbackPipeline.h"
+#include "TestCommon.h"
+#include <cstring>
+
+// 分步参考实现: 裁剪 -> 转换 -> 缩小 -> 统计, 每步写出完整中间图
+// test_readback_pipeline 用它校验融合内核, bench_pipeline 用它作为耗时基线
+struct StagedBuffers
+{
+    std::vector<uint8_t> cropped;
+    std::vector<uint8_t> converted;
+    std::vector<uint8_t> scaled;
+};
+
+inline void RunStaged(const FrameView& source, const PipelineLayout& layout, int format, int scale,
+    bool stats, StagedBuffers& buffers, FrameStatistics* out)
+{
+    const FrameRect& crop = layout.crop;
+    const int channels = layout.channels;
+
+    buffers.cropped.resize(static_cast<size_t>(crop.width) * crop.height * 4);
+    for (int y = 0; y < crop.height; y++) {
+        memcpy(buffers.cropped.data() + static_cast<size_t>(y) * crop.width * 4,
+            source.Row(crop.y + y) + static_cast<size_t>(crop.x) * 4, static_cast<size_t>(crop.width) * 4);
+    }
+
+    buffers.converted.resize(static_cast<size_t>(crop.width) * crop.height * channels);
+    const size_t pixels = static_cast<size_t>(crop.width) * crop.height;
+    const uint8_t* src = buffers.cropped.data();
+    uint8_t* dst = buffers.converted.data();
+    if (format == PipelineBGRA) {
+        memcpy(dst, src, pixels * 4);
+    } else if (format == PipelineBGR) {
+        for (size_t i = 0; i < pixels; i++) memcpy(dst + i * 3, src + i * 4, 3);
+    } else {
+        ConvertRowToLuma(src, dst, static_cast<int>(pixels));
+    }
+
+    const uint8_t* image = buffers.converted.data();
+    if (scale > 1) {
+        buffers.scaled.resize(static_cast<size_t>(layout.width) * layout.height * channels);
+        const int area = scale * scale;
+        for (int y = 0; y < layout.height; y++) {
+            for (int x = 0; x < layout.width; x++) {
+                for (int c = 0; c < channels; c++) {
+                    int sum = 0;
+                    for (int ky = 0; ky < scale; ky++) {
+                        const uint8_t* row = image + (static_cast<size_t>(y * scale + ky) * crop.width + x * scale) * channels;
+                        for (int kx = 0; kx < scale; kx++) sum += row[kx * channels + c];
+                    }
+                    buffers.scaled[(static_cast<size_t>(y) * layout.width + x) * channels + c] =
+                        static_cast<uint8_t>((sum + area / 2) / area);
+                }
+            }
+        }
+        image = buffers.scaled.data();
+    }
+
+    if (!stats) return;
+    *out = FrameStatistics();
+    const size_t outPixels = static_cast<size_t>(layout.width) * layout.height;
+    for (size_t i = 0; i < outPixels; i++) {
+        for (int c = 0; c < channels; c++) out->histogram[c][image[i * channels + c]]++;
+    }
+    for (int c = 0; c < channels; c++) {
+        out->minValue[c] = 255;
+        for (int v = 0; v < 256; v++) {
+            uint32_t n = out->histogram[c][v];
+            if (!n) continue;
+            out->sum[c] += static_cast<uint64_t>(n) * v;
+            out->minValue[c] = std::min<uint8_t>(out->minValue[c], static_cast<uint8_t>(v));
+            out->maxValue[c] = static_cast<uint8_t>(v);
+        }
+    }
+    out->pixelCount = outPixels;
+}
+
+inline const uint8_t* StagedOutput(const StagedBuffers& buffers, int scale)
+{
+    return scale > 1 ? buffers.scaled.data() : buffers.converted.data();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "FrameView.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// 不依赖测试框架: 每个测试是独立的可执行文件, 失败时打印位置并以非 0 退出
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+    do { \
+        double checkA_ = (a), checkB_ = (b); \
+        if (!(checkA_ - checkB_ <= (eps) && checkB_ - checkA_ <= (eps))) { \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR failed: %s = %g, %s = %g\n", \
+                __FILE__, __LINE__, #a, checkA_, #b, checkB_); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+// 紧凑 BGRA 测试图像
+struct TestImage
+{
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> pixels;
+
+    TestImage() = default;
+    TestImage(int w, int h, uint8_t fill = 0) : width(w), height(h), pixels(static_cast<size_t>(w) * h * 4, fill) {}
+
+    uint8_t* At(int x, int y) { return pixels.data() + (static_cast<size_t>(y) * width + x) * 4; }
+    const uint8_t* At(int x, int y) const { return pixels.data() + (static_cast<size_t>(y) * width + x) * 4; }
+
+    void Set(int x, int y, uint8_t b, uint8_t g, uint8_t r, uint8_t a = 255)
+    {
+        uint8_t* p = At(x, y);
+        p[0] = b;
+        p[1] = g;
+        p[2] = r;
+        p[3] = a;
+    }
+
+    void FillRandom(std::mt19937& rng)
+    {
+        for (auto& v : pixels) v = static_cast<uint8_t>(rng());
+    }
+
+    FrameView View() const
+    {
+        FrameView view;
+        view.data = pixels.data();
+        view.width = width;
+        view.height = height;
+        view.stride = static_cast<size_t>(width) * 4;
+        return view;
+    }
+};
+
+inline uint32_t TestLuma(const uint8_t* bgra)
+{
+    return (bgra[0] * 29u + bgra[1] * 150u + bgra[2] * 77u) >> 8;
+}
+
+// 基准计时: 返回每次调用的平均毫秒数
+template <typename Fn>
+double BenchMs(int iterations, Fn&& fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
@@ -0,0 +1,36 @@
+#include "HdrConvert.h"
+#include "TestCommon.h"
+
+// 1080p R16G16B16A16Float -> BGRA 的逐帧耗时, 向量路径与标量路径对比
+int main()
+{
+    const int width = 1920;
+    const int height = 1080;
+    std::mt19937 rng(29);
+    std::vector<uint16_t> frame(static_cast<size_t>(width) * height * 4);
+    for (auto& h : frame) h = static_cast<uint16_t>(((rng() % 17) << 10) | (rng() & 0x3FF));
+    std::vector<uint8_t> out(static_cast<size_t>(width) * height * 4);
+
+    const char* names[] = { "clamp", "reinhard", "aces" };
+    std::printf("SIMD support: %s\n", HdrConverter::HasSimdSupport() ? "yes" : "no");
+    for (int op = ToneMapClamp; op <= ToneMapAces; op++) {
+        ToneMapParams params;
+        params.op = op;
+        HdrConverter converter(params);
+        const size_t srcStride = static_cast<size_t>(width) * 4;
+        const size_t dstStride = static_cast<size_t>(width) * 4;
+
+        double fast = BenchMs(20, [&] {
+            for (int y = 0; y < height; y++) {
+                converter.ConvertRow(frame.data() + y * srcStride, out.data() + y * dstStride, width, 4);
+            }
+        });
+        double scalar = BenchMs(5, [&] {
+            for (int y = 0; y < height; y++) {
+                converter.ConvertRowScalar(frame.data() + y * srcStride, out.data() + y * dstStride, width, 4);
+            }
+        });
+        std::printf("%-9s ConvertRow %7.2f ms  scalar %7.2f ms  (%.1fx)\n", names[op], fast, scalar, scalar / fast);
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "IntegralImage.h"
+#include "TestCommon.h"
+
+// 1080p 帧上的积分图维护与查询耗时: 整帧重建, 逐行比较的增量更新, 已知脏矩形的增量更新, 批量查询
+int main()
+{
+    const int width = 1920;
+    const int height = 1080;
+    std::mt19937 rng(39);
+    TestImage frame(width, height);
+    frame.FillRandom(rng);
+
+    IntegralImage integral;
+    double rebuild = BenchMs(20, [&] {
+        integral.Clear();
+        integral.Update(frame.View());
+    });
+
+    // 每帧只有光标大小的区域变化
+    const FrameRect dirty{ 900, 500, 32, 32 };
+    uint8_t value = 0;
+    auto touch = [&] {
+        value++;
+        for (int y = dirty.y; y < dirty.y + dirty.height; y++) {
+            for (int x = dirty.x; x < dirty.x + dirty.width; x++) frame.Set(x, y, value, value, value);
+        }
+    };
+
+    int diffBands = 0;
+    double diff = BenchMs(50, [&] {
+        touch();
+        diffBands = integral.Update(frame.View());
+    });
+    int dirtyBands = 0;
+    double dirtyRect = BenchMs(200, [&] {
+        touch();
+        dirtyBands = integral.Update(frame.View(), &dirty, 1);
+    });
+
+    std::vector<FrameRect> rects(64);
+    for (auto& r : rects) {
+        r.x = static_cast<int>(rng() % (width - 200));
+        r.y = static_cast<int>(rng() % (height - 200));
+        r.width = static_cast<int>(rng() % 200) + 1;
+        r.height = static_cast<int>(rng() % 200) + 1;
+    }
+    std::vector<float> means(rects.size()), variances(rects.size());
+    double query = BenchMs(10000, [&] {
+        integral.QueryBatch(rects.data(), rects.size(), means.data(), variances.data());
+    });
+
+    std::printf("full rebuild          %8.3f ms\n", rebuild);
+    std::printf("diff update (%2d band) %8.3f ms\n", diffBands, diff);
+    std::printf("dirty rect  (%2d band) %8.3f ms\n", dirtyBands, dirtyRect);
+    std::printf("%zu queries           %8.3f us\n", rects.size(), query * 1000);
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "CaptureScheduler.h"
+#include "TestCommon.h"
+#include <map>
+#include <set>
+
+namespace
+{
+    // 模拟后端: 恢复后的下一次 TryGrab 交付一帧, static 目标永远没有新帧
+    class FakeBackend : public ICaptureBackend
+    {
+    public:
+        std::set<int> resumed;
+        std::set<int> staticTargets;
+        std::vector<int> resumeOrder;
+        int maxResumed = 0;
+        int width = 8;
+        int height = 4;
+        std::map<int, int> heights; // 按目标覆盖帧高度
+
+        bool Resume(int targetId) override
+        {
+            resumed.insert(targetId);
+            resumeOrder.push_back(targetId);
+            maxResumed = std::max(maxResumed, static_cast<int>(resumed.size()));
+            return true;
+        }
+
+        void Pause(int targetId) override { resumed.erase(targetId); }
+
+        bool TryGrab(int targetId, FrameSlot& slot) override
+        {
+            CHECK(resumed.count(targetId));
+            if (staticTargets.count(targetId)) return false;
+            auto it = heights.find(targetId);
+            slot.height = it != heights.end() ? it->second : height;
+            slot.width = width;
+            slot.data.assign(static_cast<size_t>(slot.width) * slot.height * 4, static_cast<uint8_t>(targetId));
+            return true;
+        }
+    };
+
+    void TestPriorityAndConcurrency()
+    {
+        FakeBackend backend;
+        CaptureScheduler scheduler(backend);
+        SchedulerBudget budget;
+        budget.maxConcurrent = 1;
+        scheduler.SetBudget(budget);
+
+        scheduler.AddTarget(1, 100, 0, 0);
+        scheduler.AddTarget(2, 100, 5, 0);
+        scheduler.AddTarget(3, 100, 1, 0);
+
+        for (int64_t t = 0; t < 10; t++) scheduler.Tick(t);
+
+        CHECK(backend.maxResumed == 1);
+        CHECK(backend.resumeOrder.size() >= 3);
+        CHECK(backend.resumeOrder[0] == 2);
+        CHECK(backend.resumeOrder[1] == 3);
+        CHECK(backend.resumeOrder[2] == 1);
+
+        FrameSlot slot;
+        CHECK(scheduler.CopyFrame(2, slot));
+        CHECK(slot.width == 8 && slot.height == 4);
+        CHECK(slot.data[0] == 2);
+        CHECK(slot.sequence == 1);
+        CHECK(!scheduler.CopyFrame(99, slot));
+    }
+
+    void TestIntervals()
+    {
+        FakeBackend backend;
+        CaptureScheduler scheduler(backend);
+        scheduler.AddTarget(1, 100, 0, 0);
+        scheduler.AddTarget(2, 250, 0, 0);
+
+        for (int64_t t = 0; t <= 1000; t += 5) scheduler.Tick(t);
+
+        size_t grabs1 = std::count(backend.resumeOrder.begin(), backend.resumeOrder.end(), 1);
+        size_t grabs2 = std::count(backend.resumeOrder.begin(), backend.resumeOrder.end(), 2);
+        CHECK(grabs1 >= 10 && grabs1 <= 11);
+        CHECK(grabs2 >= 4 && grabs2 <= 5);
+        // 最后一次恢复可能还未取帧
+        uint64_t grabs = scheduler.Stats().grabs;
+        CHECK(grabs <= grabs1 + grabs2 && grabs + 2 >= grabs1 + grabs2);
+    }
+
+    void TestCopyBudget()
+    {
+        FakeBackend backend;
+        CaptureScheduler scheduler(backend);
+        SchedulerBudget budget;
+        budget.maxCopiesPerSec = 10;
+        scheduler.SetBudget(budget);
+        for (int id = 1; id <= 4; id++) scheduler.AddTarget(id, 10, 0, 0);
+
+        for (int64_t t = 0; t <= 2000; t += 5) scheduler.Tick(t);
+
+        // 初始满桶 10 次 + 2 秒补充 20 次
+        SchedulerStats stats = scheduler.Stats();
+        CHECK(stats.grabs <= 31);
+        CHECK(stats.grabs >= 28);
+        CHECK(stats.throttled > 0);
+    }
+
+    void TestFrameLargerThanByteBudget()
+    {
+        // 目标 1 每帧 2048 字节, 超过每秒 1000 字节的桶容量; 不应永久卡住, 也不应挡住低优先级的目标 2
+        // 目标 1 每 5 秒一帧, 平均约 410 字节/秒, 其余配额留给目标 2
+        FakeBackend backend;
+        backend.heights[1] = 64;
+        CaptureScheduler scheduler(backend);
+        SchedulerBudget budget;
+        budget.maxBytesPerSec = 1000;
+        budget.maxConcurrent = 1;
+        scheduler.SetBudget(budget);
+        scheduler.AddTarget(1, 5000, 5, 0);
+        scheduler.AddTarget(2, 100, 0, 0);
+
+        for (int64_t t = 0; t <= 10000; t += 5) scheduler.Tick(t);
+
+        size_t grabs1 = std::count(backend.resumeOrder.begin(), backend.resumeOrder.end(), 1);
+        size_t grabs2 = std::count(backend.resumeOrder.begin(), backend.resumeOrder.end(), 2);
+        CHECK(grabs1 >= 2);
+        CHECK(grabs2 >= 20);
+
+        // 长期速率仍受预算限制: 初始满桶 + 10 秒补充, 最多透支一帧
+        SchedulerStats stats = scheduler.Stats();
+        CHECK(stats.bytes <= 1000 + 10 * 1000 + 2048);
+        CHECK(stats.bytes >= 10 * 1000 - 2048);
+        CHECK(stats.throttled > 0);
+    }
+
+    void TestTimeoutForStaticWindow()
+    {
+        FakeBackend backend;
+        backend.staticTargets.insert(1);
+        CaptureScheduler scheduler(backend);
+        SchedulerBudget budget;
+        budget.grabTimeoutMs = 50;
+        scheduler.SetBudget(budget);
+        scheduler.AddTarget(1, 100, 0, 0);
+
+        scheduler.Tick(0);
+        CHECK(scheduler.IsActive(1));
+        scheduler.Tick(49);
+        CHECK(scheduler.IsActive(1));
+        scheduler.Tick(50);
+        CHECK(!scheduler.IsActive(1));
+        CHECK(backend.resumed.empty());
+        CHECK(scheduler.Stats().timeouts == 1);
+
+        FrameSlot slot;
+        CHECK(!scheduler.CopyFrame(1, slot));
+    }
+
+    void TestRemoveActiveTarget()
+    {
+        FakeBackend backend;
+        backend.staticTargets.insert(1);
+        CaptureScheduler scheduler(backend);
+        scheduler.AddTarget(1, 100, 0, 0);
+        scheduler.Tick(0);
+        CHECK(backend.resumed.count(1));
+
+        scheduler.RemoveTarget(1);
+        CHECK(backend.resumed.empty());
+        CHECK(!scheduler.HasTarget(1));
+    }
+}
+
+int main()
+{
+    TestPriorityAndConcurrency();
+    TestIntervals();
+    TestCopyBudget();
+    TestFrameLargerThanByteBudget();
+    TestTimeoutForStaticWindow();
+    TestRemoveActiveTarget();
+    std::puts("test_capture_scheduler: ok");
+    return 0;
+}
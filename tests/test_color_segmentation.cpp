@@ -0,0 +1,251 @@
+#include "ColorSegmentation.h"
+#include "TestCommon.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    bool InRange(const uint8_t* values, const ColorRange& r, bool hueWraps)
+    {
+        for (int c = 0; c < 3; c++) {
+            if (c == 0 && hueWraps && r.lower[0] > r.upper[0]) {
+                if (values[0] < r.lower[0] && values[0] > r.upper[0]) return false;
+            } else if (values[c] < r.lower[c] || values[c] > r.upper[c]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> ReferenceMask(const TestImage& image, const FrameRect& roi, int colorSpace,
+        const std::vector<ColorRange>& ranges)
+    {
+        std::vector<uint8_t> mask(static_cast<size_t>(roi.width) * roi.height, 0);
+        for (int y = 0; y < roi.height; y++) {
+            for (int x = 0; x < roi.width; x++) {
+                uint8_t values[3];
+                const uint8_t* p = image.At(roi.x + x, roi.y + y);
+                if (colorSpace == ColorSpaceHSV) {
+                    BgraToHsv(p, values);
+                } else {
+                    memcpy(values, p, 3);
+                }
+                for (const ColorRange& r : ranges) {
+                    if (InRange(values, r, colorSpace == ColorSpaceHSV)) mask[static_cast<size_t>(y) * roi.width + x] = 255;
+                }
+            }
+        }
+        return mask;
+    }
+
+    // 显式栈的洪水填充
+    std::vector<ColorBlob> ReferenceBlobs(const std::vector<uint8_t>& mask, const FrameRect& roi,
+        int connectivity, int minArea)
+    {
+        std::vector<ColorBlob> blobs;
+        std::vector<uint8_t> visited(mask.size(), 0);
+        std::vector<std::pair<int, int>> stack;
+
+        for (int sy = 0; sy < roi.height; sy++) {
+            for (int sx = 0; sx < roi.width; sx++) {
+                size_t start = static_cast<size_t>(sy) * roi.width + sx;
+                if (!mask[start] || visited[start]) continue;
+
+                int minX = sx, maxX = sx, minY = sy, maxY = sy;
+                int64_t area = 0, sumX = 0, sumY = 0;
+                visited[start] = 1;
+                stack.push_back({ sx, sy });
+                while (!stack.empty()) {
+                    auto [x, y] = stack.back();
+                    stack.pop_back();
+                    area++;
+                    sumX += roi.x + x;
+                    sumY += roi.y + y;
+                    minX = std::min(minX, x);
+                    maxX = std::max(maxX, x);
+                    minY = std::min(minY, y);
+                    maxY = std::max(maxY, y);
+
+                    for (int dy = -1; dy <= 1; dy++) {
+                        for (int dx = -1; dx <= 1; dx++) {
+                            if ((dx == 0 && dy == 0) || (connectivity == 4 && dx != 0 && dy != 0)) continue;
+                            int nx = x + dx, ny = y + dy;
+                            if (nx < 0 || ny < 0 || nx >= roi.width || ny >= roi.height) continue;
+                            size_t n = static_cast<size_t>(ny) * roi.width + nx;
+                            if (!mask[n] || visited[n]) continue;
+                            visited[n] = 1;
+                            stack.push_back({ nx, ny });
+                        }
+                    }
+                }
+
+                if (area < minArea) continue;
+                ColorBlob blob;
+                blob.x = roi.x + minX;
+                blob.y = roi.y + minY;
+                blob.width = maxX - minX + 1;
+                blob.height = maxY - minY + 1;
+                blob.area = static_cast<int>(area);
+                blob.centroidX = static_cast<float>(static_cast<double>(sumX) / area);
+                blob.centroidY = static_cast<float>(static_cast<double>(sumY) / area);
+                blobs.push_back(blob);
+            }
+        }
+
+        std::sort(blobs.begin(), blobs.end(), [](const ColorBlob& a, const ColorBlob& b) {
+            if (a.area != b.area) return a.area > b.area;
+            if (a.y != b.y) return a.y < b.y;
+            return a.x < b.x;
+        });
+        return blobs;
+    }
+
+    void CheckAgainstReference(const TestImage& image, const FrameRect& roi, int colorSpace,
+        const std::vector<ColorRange>& ranges, int connectivity, int minArea)
+    {
+        FrameRect r = roi.ClampTo(image.width, image.height);
+        std::vector<uint8_t> expectedMask = ReferenceMask(image, r, colorSpace, ranges);
+        std::vector<ColorBlob> expected = ReferenceBlobs(expectedMask, r, connectivity, minArea);
+
+        std::vector<ColorBlob> blobs;
+        std::vector<uint8_t> mask;
+        FindColorBlobs(image.View(), roi, colorSpace, ranges.data(), static_cast<int>(ranges.size()),
+            minArea, connectivity, blobs, &mask);
+
+        CHECK(mask == expectedMask);
+        CHECK(blobs.size() == expected.size());
+        for (size_t i = 0; i < blobs.size(); i++) {
+            CHECK(blobs[i].x == expected[i].x);
+            CHECK(blobs[i].y == expected[i].y);
+            CHECK(blobs[i].width == expected[i].width);
+            CHECK(blobs[i].height == expected[i].height);
+            CHECK(blobs[i].area == expected[i].area);
+            CHECK_NEAR(blobs[i].centroidX, expected[i].centroidX, 1e-3);
+            CHECK_NEAR(blobs[i].centroidY, expected[i].centroidY, 1e-3);
+        }
+    }
+
+    // 目标色 (纯红附近) 按给定密度散布, 其余为随机颜色
+    TestImage RandomScene(int width, int height, int densityPercent, std::mt19937& rng)
+    {
+        TestImage image(width, height);
+        image.FillRandom(rng);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (static_cast<int>(rng() % 100) < densityPercent) {
+                    image.Set(x, y, static_cast<uint8_t>(rng() % 40), static_cast<uint8_t>(rng() % 40),
+                        static_cast<uint8_t>(200 + rng() % 56));
+                }
+            }
+        }
+        return image;
+    }
+
+    void TestBgrAgainstFloodFill()
+    {
+        std::mt19937 rng(33);
+        const std::vector<ColorRange> red = { { { 0, 0, 200 }, { 39, 39, 255 } } };
+        const std::vector<ColorRange> twoRanges = { { { 0, 0, 200 }, { 39, 39, 255 } },
+            { { 100, 100, 100 }, { 160, 160, 160 } } };
+        const FrameRect rois[] = { FrameRect{}, FrameRect{ 5, 3, 70, 41 }, FrameRect{ -10, -10, 40, 30 } };
+
+        for (int density : { 20, 45, 60 }) {
+            TestImage image = RandomScene(97, 61, density, rng);
+            for (const FrameRect& roi : rois) {
+                for (int connectivity : { 4, 8 }) {
+                    CheckAgainstReference(image, roi, ColorSpaceBGR, red, connectivity, 1);
+                    CheckAgainstReference(image, roi, ColorSpaceBGR, red, connectivity, 5);
+                    CheckAgainstReference(image, roi, ColorSpaceBGR, twoRanges, connectivity, 1);
+                }
+            }
+        }
+    }
+
+    void TestHsvAgainstFloodFill()
+    {
+        std::mt19937 rng(34);
+        // 色相跨越 0 的红色区间
+        const std::vector<ColorRange> red = { { { 170, 100, 100 }, { 10, 255, 255 } } };
+        TestImage image = RandomScene(83, 53, 40, rng);
+        for (int connectivity : { 4, 8 }) {
+            CheckAgainstReference(image, FrameRect{}, ColorSpaceHSV, red, connectivity, 3);
+        }
+    }
+
+    // 8 位 HSV 与浮点公式 (OpenCV 定义) 相差不超过 1
+    void TestBgraToHsv()
+    {
+        std::mt19937 rng(35);
+        for (int i = 0; i < 20000; i++) {
+            uint8_t bgra[4] = { static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), 255 };
+            uint8_t hsv[3];
+            BgraToHsv(bgra, hsv);
+
+            double b = bgra[0], g = bgra[1], r = bgra[2];
+            double v = std::max({ b, g, r });
+            double diff = v - std::min({ b, g, r });
+            double s = v > 0 ? diff * 255.0 / v : 0;
+            double h = 0;
+            if (diff > 0) {
+                if (v == r) h = 60.0 * (g - b) / diff;
+                else if (v == g) h = 120.0 + 60.0 * (b - r) / diff;
+                else h = 240.0 + 60.0 * (r - g) / diff;
+                if (h < 0) h += 360.0;
+            }
+
+            CHECK_NEAR(hsv[2], v, 0);
+            CHECK_NEAR(hsv[1], s, 1);
+            CHECK(hsv[0] < 180);
+            double dh = std::fabs(hsv[0] - h / 2);
+            CHECK(std::min(dh, 180 - dh) <= 1.0);
+        }
+
+        uint8_t hsv[3];
+        const uint8_t red[4] = { 0, 0, 255, 255 }, green[4] = { 0, 255, 0, 255 }, blue[4] = { 255, 0, 0, 255 };
+        BgraToHsv(red, hsv);
+        CHECK(hsv[0] == 0 && hsv[1] == 255 && hsv[2] == 255);
+        BgraToHsv(green, hsv);
+        CHECK(hsv[0] == 60);
+        BgraToHsv(blue, hsv);
+        CHECK(hsv[0] == 120);
+    }
+
+    void TestShapes()
+    {
+        // 对角相邻的两个像素: 4 连通为两个连通域, 8 连通为一个
+        TestImage image(16, 16);
+        image.Set(3, 3, 0, 0, 255);
+        image.Set(4, 4, 0, 0, 255);
+        // U 形: 单遍标记需要合并两支
+        for (int y = 8; y < 14; y++) {
+            image.Set(8, y, 0, 0, 255);
+            image.Set(12, y, 0, 0, 255);
+        }
+        for (int x = 8; x <= 12; x++) image.Set(x, 14, 0, 0, 255);
+
+        const ColorRange red = { { 0, 0, 200 }, { 10, 10, 255 } };
+        std::vector<ColorBlob> blobs;
+        FindColorBlobs(image.View(), FrameRect{}, ColorSpaceBGR, &red, 1, 1, 4, blobs);
+        CHECK(blobs.size() == 3);
+        CHECK(blobs[0].area == 17);
+        CHECK(blobs[0].x == 8 && blobs[0].y == 8 && blobs[0].width == 5 && blobs[0].height == 7);
+
+        FindColorBlobs(image.View(), FrameRect{}, ColorSpaceBGR, &red, 1, 1, 8, blobs);
+        CHECK(blobs.size() == 2);
+        CHECK(blobs[1].area == 2);
+        CHECK_NEAR(blobs[1].centroidX, 3.5, 1e-6);
+
+        FindColorBlobs(image.View(), FrameRect{ 100, 100, 5, 5 }, ColorSpaceBGR, &red, 1, 1, 8, blobs);
+        CHECK(blobs.empty());
+    }
+}
+
+int main()
+{
+    TestBgrAgainstFloodFill();
+    TestHsvAgainstFloodFill();
+    TestBgraToHsv();
+    TestShapes();
+    std::puts("test_color_segmentation: ok");
+    return 0;
+}
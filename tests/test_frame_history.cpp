@@ -0,0 +1,177 @@
+#include "FrameHistory.h"
+#include "TestCommon.h"
+#include <cstring>
+
+namespace
+{
+    // 大部分像素不变, 每帧改动一小块, 模拟差分帧占多数的录制
+    TestImage MakeFrame(int index)
+    {
+        TestImage image(64, 48);
+        for (int y = 0; y < image.height; y++) {
+            for (int x = 0; x < image.width; x++) {
+                image.Set(x, y, static_cast<uint8_t>(x * 4), static_cast<uint8_t>(y * 5), 40);
+            }
+        }
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+                image.Set((index * 3 + x) % image.width, (index + y) % image.height,
+                    static_cast<uint8_t>(index), static_cast<uint8_t>(index * 7), 200);
+            }
+        }
+        return image;
+    }
+
+    void TestCodecRoundTrip()
+    {
+        std::mt19937 rng(3);
+        TestImage reference = MakeFrame(0);
+        TestImage noisy(64, 48);
+        noisy.FillRandom(rng);
+        size_t pixelCount = static_cast<size_t>(reference.width) * reference.height;
+
+        for (const TestImage* image : { &reference, &noisy }) {
+            std::vector<uint8_t> encoded;
+            EncodeFrame(image->pixels.data(), nullptr, pixelCount, encoded);
+            std::vector<uint8_t> decoded(pixelCount * 4);
+            CHECK(DecodeFrame(encoded.data(), encoded.size(), nullptr, decoded.data(), pixelCount));
+            CHECK(decoded == image->pixels);
+        }
+
+        TestImage next = MakeFrame(1);
+        std::vector<uint8_t> delta;
+        EncodeFrame(next.pixels.data(), reference.pixels.data(), pixelCount, delta);
+        CHECK(delta.size() < pixelCount);
+        // 差分帧原地更新参考帧
+        std::vector<uint8_t> decoded = reference.pixels;
+        CHECK(DecodeFrame(delta.data(), delta.size(), decoded.data(), decoded.data(), pixelCount));
+        CHECK(decoded == next.pixels);
+    }
+
+    void TestWindowCoverage()
+    {
+        FrameHistoryOptions options;
+        options.windowMs = 1000;
+        options.keyframeInterval = 10;
+        options.maxFps = 0;
+        FrameHistory history(options);
+
+        // 每 100ms 一帧, 每组 10 帧 (1 秒)
+        const int frameCount = 57;
+        for (int i = 0; i < frameCount; i++) {
+            history.Submit(MakeFrame(i).View(), i * 100);
+            history.Flush();
+
+            int64_t oldest = 0, newest = 0;
+            CHECK(history.GetTimeRange(&oldest, &newest));
+            CHECK(newest == i * 100);
+            // 窗口内的帧必须全部保留, 淘汰后最多多出一组
+            CHECK(oldest <= std::max<int64_t>(0, newest - options.windowMs));
+            CHECK(oldest >= newest - options.windowMs - 100 * options.keyframeInterval);
+        }
+
+        int64_t newest = (frameCount - 1) * 100;
+        FrameHistory::Range range;
+        CHECK(history.Snapshot(newest - options.windowMs, newest, 0, range));
+        CHECK(range.FrameCount() == 11);
+        CHECK(range.width == 64 && range.height == 48);
+
+        std::vector<int64_t> timestamps;
+        CHECK(FrameHistory::Decode(range, [&](const FrameView& frame, int64_t timestampMs) {
+            TestImage expected = MakeFrame(static_cast<int>(timestampMs / 100));
+            CHECK(frame.width == 64 && frame.height == 48);
+            CHECK(memcmp(frame.data, expected.pixels.data(), expected.pixels.size()) == 0);
+            timestamps.push_back(timestampMs);
+            return true;
+        }));
+        CHECK(timestamps.size() == 11);
+        CHECK(timestamps.front() == newest - options.windowMs && timestamps.back() == newest);
+    }
+
+    void TestChunkedExtract()
+    {
+        FrameHistoryOptions options;
+        options.windowMs = 100000;
+        options.keyframeInterval = 7;
+        options.maxFps = 0;
+        FrameHistory history(options);
+
+        for (int i = 0; i < 40; i++) {
+            history.Submit(MakeFrame(i).View(), i * 100);
+            history.Flush();
+        }
+
+        // 每段最多 6 帧, 从上一段最后一帧之后继续; 段内条目只包含所需的关键帧链与请求的帧
+        std::vector<int64_t> timestamps;
+        int64_t start = 250;
+        const int64_t end = 3050;
+        FrameHistory::Range range;
+        while (history.Snapshot(start, end, 6, range)) {
+            CHECK(range.FrameCount() <= 6);
+            CHECK(range.entries.size() <= range.FrameCount() + options.keyframeInterval - 1);
+            CHECK(range.entries.front().keyframe);
+            CHECK(FrameHistory::Decode(range, [&](const FrameView& frame, int64_t timestampMs) {
+                TestImage expected = MakeFrame(static_cast<int>(timestampMs / 100));
+                CHECK(memcmp(frame.data, expected.pixels.data(), expected.pixels.size()) == 0);
+                timestamps.push_back(timestampMs);
+                return true;
+            }));
+            start = timestamps.back() + 1;
+        }
+        CHECK(timestamps.size() == 28);
+        for (size_t i = 0; i < timestamps.size(); i++) CHECK(timestamps[i] == 300 + static_cast<int64_t>(i) * 100);
+
+        // 访问者可提前停止
+        int visited = 0;
+        CHECK(history.Snapshot(0, end, 0, range));
+        CHECK(FrameHistory::Decode(range, [&](const FrameView&, int64_t) { return ++visited < 3; }));
+        CHECK(visited == 3);
+
+        // 解码不持有环的锁: 解码期间压缩线程可继续入环, 清空后已取出的段仍可解码
+        CHECK(history.Snapshot(1000, 1500, 0, range));
+        bool first = true;
+        CHECK(FrameHistory::Decode(range, [&](const FrameView&, int64_t) {
+            if (first) {
+                history.Submit(MakeFrame(40).View(), 4000);
+                history.Flush();
+                history.Clear();
+                first = false;
+            }
+            return true;
+        }));
+        CHECK(history.FrameCount() == 0);
+        CHECK(!history.Snapshot(0, end, 0, range));
+    }
+
+    void TestMemoryBudget()
+    {
+        FrameHistoryOptions options;
+        options.windowMs = 1000000;
+        options.keyframeInterval = 4;
+        options.maxFps = 0;
+        options.memoryBudget = 64 * 1024;
+        FrameHistory history(options);
+
+        std::mt19937 rng(4);
+        for (int i = 0; i < 40; i++) {
+            TestImage image(64, 48);
+            image.FillRandom(rng);
+            history.Submit(image.View(), i * 10);
+            history.Flush();
+        }
+        // 超出预算时至少保留最新一组
+        CHECK(history.MemoryUsage() <= options.memoryBudget + 4 * 64 * 48 * 5);
+        CHECK(history.FrameCount() < 40);
+        CHECK(history.FrameCount() >= 1);
+    }
+}
+
+int main()
+{
+    TestCodecRoundTrip();
+    TestWindowCoverage();
+    TestChunkedExtract();
+    TestMemoryBudget();
+    std::puts("test_frame_history: ok");
+    return 0;
+}
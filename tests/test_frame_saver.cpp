@@ -0,0 +1,113 @@
+#include "FrameSaver.h"
+#include "TestCommon.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    TestImage RandomImage(int width, int height, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        TestImage image(width, height);
+        image.FillRandom(rng);
+        return image;
+    }
+
+    void TestSaveAndCallback(const std::filesystem::path& dir)
+    {
+        FrameSaver saver(2, 4);
+        std::atomic<int> callbacks{ 0 };
+        std::atomic<int> failures{ 0 };
+        saver.SetCallback([&](int, bool success) {
+            callbacks++;
+            if (!success) failures++;
+        });
+
+        TestImage image = RandomImage(160, 140, 40);
+        std::vector<int> pngJobs, qoiJobs;
+        for (int i = 0; i < 6; i++) {
+            std::vector<uint8_t> pixels = saver.AcquireBuffer(image.pixels.size());
+            CHECK(pixels.size() == image.pixels.size());
+            std::copy(image.pixels.begin(), image.pixels.end(), pixels.begin());
+            bool png = i % 2 == 0;
+            std::string path = (dir / ("frame" + std::to_string(i) + (png ? ".png" : ".qoi"))).string();
+            int id = saver.Submit(std::move(pixels), image.width, image.height, path,
+                png ? ImageFormatPng : ImageFormatQoi, false);
+            CHECK(id > 0);
+            (png ? pngJobs : qoiJobs).push_back(id);
+        }
+
+        for (int id : pngJobs) CHECK(saver.Wait(id, 10000) == SaveStatusDone);
+        for (int id : qoiJobs) CHECK(saver.Wait(id, -1) == SaveStatusDone);
+        CHECK(saver.Status(pngJobs[0]) == SaveStatusDone);
+
+        // 写盘内容与同步编码一致
+        std::vector<uint8_t> expectedPng, expectedQoi;
+        EncodePng(image.View(), false, 4, expectedPng);
+        EncodeQoi(image.View(), false, expectedQoi);
+        CHECK(ReadFile(dir / "frame0.png") == expectedPng);
+        CHECK(ReadFile(dir / "frame1.qoi") == expectedQoi);
+
+        // 回调在状态更新之后调用
+        for (int i = 0; i < 1000 && callbacks < 6; i++) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        CHECK(callbacks == 6);
+        CHECK(failures == 0);
+    }
+
+    void TestFailures(const std::filesystem::path& dir)
+    {
+        FrameSaver saver(1, 2);
+        TestImage image(8, 8, 1);
+
+        int badFormat = saver.Submit(image.pixels, 8, 8, (dir / "bad.bin").string(), 7, false);
+        CHECK(saver.Wait(badFormat, 5000) == SaveStatusFailed);
+
+        int badPath = saver.Submit(image.pixels, 8, 8, (dir / "missing" / "x.png").string(), ImageFormatPng, false);
+        CHECK(saver.Wait(badPath, 5000) == SaveStatusFailed);
+
+        int badSize = saver.Submit(image.pixels, 0, 8, (dir / "empty.png").string(), ImageFormatPng, false);
+        CHECK(saver.Wait(badSize, 5000) == SaveStatusFailed);
+
+        CHECK(saver.Status(12345) == SaveStatusUnknown);
+        CHECK(saver.Wait(12345, 10) == SaveStatusUnknown);
+    }
+
+    void TestPendingOnDestruction(const std::filesystem::path& dir)
+    {
+        // 析构时已提交的任务仍会写完
+        TestImage image = RandomImage(256, 256, 41);
+        {
+            FrameSaver saver(1, 2);
+            for (int i = 0; i < 4; i++) {
+                saver.Submit(image.pixels, image.width, image.height,
+                    (dir / ("pending" + std::to_string(i) + ".png")).string(), ImageFormatPng, true);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            CHECK(std::filesystem::file_size(dir / ("pending" + std::to_string(i) + ".png")) > 0);
+        }
+    }
+}
+
+int main()
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path() /
+        ("wgc_frame_saver_" + std::to_string(std::random_device()()));
+    std::filesystem::create_directories(dir);
+
+    TestSaveAndCallback(dir);
+    TestFailures(dir);
+    TestPendingOnDestruction(dir);
+
+    std::filesystem::remove_all(dir);
+    std::puts("test_frame_saver: ok");
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "FrameStats.h"
+#include "TestCommon.h"
+#include <cstring>
+
+namespace
+{
+    FrameStatistics Reference(const TestImage& image, const FrameRect& roi)
+    {
+        FrameStatistics out;
+        FrameRect r = roi.ClampTo(image.width, image.height);
+        for (int c = 0; c < 4; c++) {
+            out.minValue[c] = 255;
+            out.maxValue[c] = 0;
+        }
+        for (int y = r.y; y < r.y + r.height; y++) {
+            for (int x = r.x; x < r.x + r.width; x++) {
+                const uint8_t* p = image.At(x, y);
+                for (int c = 0; c < 4; c++) {
+                    out.histogram[c][p[c]]++;
+                    out.sum[c] += p[c];
+                    out.minValue[c] = std::min(out.minValue[c], p[c]);
+                    out.maxValue[c] = std::max(out.maxValue[c], p[c]);
+                }
+                out.pixelCount++;
+            }
+        }
+        return out;
+    }
+
+    void CheckMatches(const TestImage& image, const FrameRect& roi, int flags)
+    {
+        FrameStatistics expected = Reference(image, roi);
+        FrameStatistics actual;
+        ComputeFrameStats(image.View(), roi, flags, actual);
+
+        CHECK(actual.pixelCount == expected.pixelCount);
+        if (flags & FrameStatsHistogram) {
+            CHECK(memcmp(actual.histogram, expected.histogram, sizeof(expected.histogram)) == 0);
+        }
+        if (flags & (FrameStatsHistogram | FrameStatsSums)) {
+            for (int c = 0; c < 4; c++) CHECK(actual.sum[c] == expected.sum[c]);
+        }
+        if (flags & (FrameStatsHistogram | FrameStatsMinMax)) {
+            for (int c = 0; c < 4; c++) {
+                CHECK(actual.minValue[c] == expected.minValue[c]);
+                CHECK(actual.maxValue[c] == expected.maxValue[c]);
+            }
+        }
+    }
+
+    void TestAgainstReference()
+    {
+        std::mt19937 rng(2);
+        // 奇数宽度覆盖 SIMD 尾部与直方图交替写入的尾部
+        TestImage image(131, 47);
+        image.FillRandom(rng);
+
+        const FrameRect rois[] = {
+            FrameRect{},
+            FrameRect{ 3, 5, 61, 17 },
+            FrameRect{ 130, 46, 10, 10 },
+            FrameRect{ -4, -4, 9, 9 },
+        };
+        const int flagSets[] = {
+            FrameStatsHistogram,
+            FrameStatsSums,
+            FrameStatsMinMax,
+            FrameStatsSums | FrameStatsMinMax,
+            FrameStatsHistogram | FrameStatsSums | FrameStatsMinMax,
+        };
+        for (const FrameRect& roi : rois) {
+            for (int flags : flagSets) CheckMatches(image, roi, flags);
+        }
+    }
+
+    void TestPixelCountOnly()
+    {
+        // 只请求像素数 (flags 为 0) 时仍需计数
+        TestImage image(40, 30, 7);
+        FrameStatistics stats;
+        ComputeFrameStats(image.View(), FrameRect{ 5, 5, 10, 6 }, 0, stats);
+        CHECK(stats.pixelCount == 60);
+        CHECK(stats.sum[0] == 0);
+    }
+
+    void TestEmptyRoi()
+    {
+        TestImage image(16, 16, 9);
+        FrameStatistics stats;
+        ComputeFrameStats(image.View(), FrameRect{ 20, 20, 5, 5 }, FrameStatsSums, stats);
+        CHECK(stats.pixelCount == 0);
+        CHECK(stats.sum[0] == 0);
+    }
+}
+
+int main()
+{
+    TestAgainstReference();
+    TestPixelCountOnly();
+    TestEmptyRoi();
+    std::puts("test_frame_stats: ok");
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "HdrConvert.h"
+#include "TestCommon.h"
+#include <cmath>
+
+namespace
+{
+    double DecodeHalf(uint16_t h)
+    {
+        int sign = (h & 0x8000) ? -1 : 1;
+        int exponent = (h >> 10) & 0x1F;
+        int mantissa = h & 0x3FF;
+        if (exponent == 31) return mantissa ? NAN : sign * INFINITY;
+        if (exponent == 0) return sign * std::ldexp(mantissa, -24);
+        return sign * std::ldexp(1024 + mantissa, exponent - 25);
+    }
+
+    double ReferenceToneMap(double v, const ToneMapParams& params)
+    {
+        double x = v * params.exposure;
+        if (!(x > 0.0)) x = 0.0;
+        if (std::isinf(x)) return 1.0;
+        if (params.op == ToneMapReinhard) {
+            double w2 = static_cast<double>(params.whitePoint) * params.whitePoint;
+            x = x * (1.0 + x / w2) / (1.0 + x);
+        } else if (params.op == ToneMapAces) {
+            x = (x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14);
+        }
+        return std::min(x, 1.0);
+    }
+
+    int ReferenceSrgb(double linear)
+    {
+        double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+        return static_cast<int>(std::clamp(srgb * 255.0 + 0.5, 0.0, 255.0));
+    }
+
+    // 正值为主, 指数覆盖非规格化数到 ~16, 另加负值/NaN/无穷
+    std::vector<uint16_t> RandomRow(std::mt19937& rng, int width)
+    {
+        std::vector<uint16_t> row(static_cast<size_t>(width) * 4);
+        for (size_t i = 0; i < row.size(); i++) {
+            uint16_t exponent = static_cast<uint16_t>(rng() % 19);
+            uint16_t h = static_cast<uint16_t>((exponent << 10) | (rng() & 0x3FF));
+            if (i % 4 == 3 && rng() % 2) h = 0x3C00; // alpha 常见为 1.0
+            row[i] = h;
+        }
+        const uint16_t specials[] = { 0x0000, 0x8000, 0xBC00, 0x7C00, 0xFC00, 0x7E00, 0x3C00, 0x0001 };
+        for (size_t i = 0; i < std::size(specials) && i < row.size(); i++) row[i * 5 % row.size()] = specials[i];
+        return row;
+    }
+
+    void TestHalfToFloat()
+    {
+        for (uint32_t h = 0; h <= 0xFFFF; h++) {
+            double expected = DecodeHalf(static_cast<uint16_t>(h));
+            float actual = HalfToFloat(static_cast<uint16_t>(h));
+            if (std::isnan(expected)) {
+                CHECK(std::isnan(actual));
+            } else {
+                CHECK(static_cast<double>(actual) == expected);
+            }
+        }
+    }
+
+    void CheckRow(const HdrConverter& converter, const std::vector<uint16_t>& row, const uint8_t* dst,
+        int width, int channels)
+    {
+        for (int x = 0; x < width; x++) {
+            const uint16_t* p = row.data() + x * 4;
+            const uint8_t* d = dst + x * channels;
+            for (int c = 0; c < 3; c++) {
+                int expected = ReferenceSrgb(ReferenceToneMap(DecodeHalf(p[2 - c]), converter.Params()));
+                // 14 位 sRGB 查找表量化误差不超过 1 级
+                CHECK(std::abs(d[c] - expected) <= 1);
+            }
+            if (channels == 4) {
+                double a = DecodeHalf(p[3]);
+                a = a > 0.0 ? std::min(a, 1.0) : 0.0;
+                CHECK(std::abs(d[3] - static_cast<int>(a * 255.0 + 0.5)) <= 1);
+            }
+        }
+    }
+
+    void TestAgainstReference()
+    {
+        std::mt19937 rng(29);
+        // 奇数宽度覆盖向量路径的尾部
+        const int width = 257;
+        const ToneMapParams params[] = {
+            { ToneMapClamp, 1.0f, 4.0f },
+            { ToneMapReinhard, 1.0f, 4.0f },
+            { ToneMapReinhard, 2.5f, 10.0f },
+            { ToneMapAces, 0.6f, 4.0f },
+        };
+
+        for (const ToneMapParams& p : params) {
+            HdrConverter converter(p);
+            for (int channels : { 3, 4 }) {
+                for (int trial = 0; trial < 8; trial++) {
+                    std::vector<uint16_t> row = RandomRow(rng, width);
+                    std::vector<uint8_t> fast(static_cast<size_t>(width) * channels);
+                    std::vector<uint8_t> scalar(fast.size());
+                    converter.ConvertRow(row.data(), fast.data(), width, channels);
+                    converter.ConvertRowScalar(row.data(), scalar.data(), width, channels);
+                    CheckRow(converter, row, scalar.data(), width, channels);
+                    CheckRow(converter, row, fast.data(), width, channels);
+                }
+            }
+        }
+    }
+
+    void TestInvalidParams()
+    {
+        ToneMapParams p;
+        p.exposure = 0.0f;
+        p.whitePoint = NAN;
+        HdrConverter converter(p);
+        CHECK(converter.Params().exposure == 1.0f);
+        CHECK(converter.Params().whitePoint == 1.0f);
+    }
+}
+
+int main()
+{
+    std::printf("HdrConverter SIMD: %s\n", HdrConverter::HasSimdSupport() ? "yes" : "no");
+    TestHalfToFloat();
+    TestAgainstReference();
+    TestInvalidParams();
+    std::puts("test_hdr_convert: ok");
+    return 0;
+}
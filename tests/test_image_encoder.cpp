@@ -0,0 +1,447 @@
+#include "ImageEncoder.h"
+#include "TestCommon.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    uint32_t GetBE32(const uint8_t* p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+    }
+
+    // 按 QOI 规范解码为 BGRA
+    bool DecodeQoi(const std::vector<uint8_t>& data, TestImage& image, int& channels)
+    {
+        if (data.size() < 22 || memcmp(data.data(), "qoif", 4) != 0) return false;
+        image = TestImage(static_cast<int>(GetBE32(&data[4])), static_cast<int>(GetBE32(&data[8])));
+        channels = data[12];
+
+        struct Rgba { uint8_t r, g, b, a; };
+        Rgba index[64] = {};
+        Rgba px = { 0, 0, 0, 255 };
+        size_t p = 14;
+        size_t end = data.size() - 8;
+        int run = 0;
+        size_t pixels = static_cast<size_t>(image.width) * image.height;
+
+        for (size_t i = 0; i < pixels; i++) {
+            if (run > 0) {
+                run--;
+            } else {
+                if (p >= end) return false;
+                uint8_t b1 = data[p++];
+                if (b1 == 0xFE) {
+                    px.r = data[p++];
+                    px.g = data[p++];
+                    px.b = data[p++];
+                } else if (b1 == 0xFF) {
+                    px.r = data[p++];
+                    px.g = data[p++];
+                    px.b = data[p++];
+                    px.a = data[p++];
+                } else if ((b1 & 0xC0) == 0x00) {
+                    px = index[b1];
+                } else if ((b1 & 0xC0) == 0x40) {
+                    px.r = static_cast<uint8_t>(px.r + ((b1 >> 4) & 3) - 2);
+                    px.g = static_cast<uint8_t>(px.g + ((b1 >> 2) & 3) - 2);
+                    px.b = static_cast<uint8_t>(px.b + (b1 & 3) - 2);
+                } else if ((b1 & 0xC0) == 0x80) {
+                    uint8_t b2 = data[p++];
+                    int dg = (b1 & 0x3F) - 32;
+                    px.r = static_cast<uint8_t>(px.r + dg - 8 + ((b2 >> 4) & 0x0F));
+                    px.g = static_cast<uint8_t>(px.g + dg);
+                    px.b = static_cast<uint8_t>(px.b + dg - 8 + (b2 & 0x0F));
+                } else {
+                    run = b1 & 0x3F;
+                }
+                index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+            }
+            image.Set(static_cast<int>(i % image.width), static_cast<int>(i / image.width), px.b, px.g, px.r, px.a);
+        }
+
+        static const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+        return p == end && memcmp(data.data() + end, padding, 8) == 0;
+    }
+
+    // 只支持存储块与固定 Huffman 块的 inflate, 覆盖 DeflateFixed 的全部输出
+    class Inflater
+    {
+    public:
+        Inflater(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        bool Run(std::vector<uint8_t>& out)
+        {
+            for (;;) {
+                int final = Bits(1);
+                int type = Bits(2);
+                if (m_error) return false;
+                if (type == 0) {
+                    m_bitCount = 0;
+                    if (m_pos + 4 > m_size) return false;
+                    int len = m_data[m_pos] | (m_data[m_pos + 1] << 8);
+                    int nlen = m_data[m_pos + 2] | (m_data[m_pos + 3] << 8);
+                    m_pos += 4;
+                    if ((len ^ 0xFFFF) != nlen || m_pos + len > m_size) return false;
+                    out.insert(out.end(), m_data + m_pos, m_data + m_pos + len);
+                    m_pos += len;
+                } else if (type == 1) {
+                    if (!FixedBlock(out)) return false;
+                } else {
+                    return false;
+                }
+                if (final) return true;
+            }
+        }
+
+        size_t Consumed() const { return m_pos; }
+
+    private:
+        int Bits(int n)
+        {
+            int v = 0;
+            for (int i = 0; i < n; i++) {
+                if (m_bitCount == 0) {
+                    if (m_pos >= m_size) {
+                        m_error = true;
+                        return 0;
+                    }
+                    m_byte = m_data[m_pos++];
+                    m_bitCount = 8;
+                }
+                v |= (m_byte & 1) << i;
+                m_byte >>= 1;
+                m_bitCount--;
+            }
+            return v;
+        }
+
+        // Huffman 码从最高位开始逐位读入
+        int Code(int n, int prefix)
+        {
+            for (int i = 0; i < n; i++) prefix = (prefix << 1) | Bits(1);
+            return prefix;
+        }
+
+        int LiteralSymbol()
+        {
+            int code = Code(7, 0);
+            if (code <= 0x17) return 256 + code;
+            code = Code(1, code);
+            if (code >= 0x30 && code <= 0xBF) return code - 0x30;
+            if (code >= 0xC0 && code <= 0xC7) return 280 + code - 0xC0;
+            code = Code(1, code);
+            return 144 + code - 0x190;
+        }
+
+        bool FixedBlock(std::vector<uint8_t>& out)
+        {
+            static const int lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+            static const int lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+            static const int distBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+            static const int distExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+            for (;;) {
+                int symbol = LiteralSymbol();
+                if (m_error || symbol > 285) return false;
+                if (symbol < 256) {
+                    out.push_back(static_cast<uint8_t>(symbol));
+                } else if (symbol == 256) {
+                    return true;
+                } else {
+                    int ls = symbol - 257;
+                    int length = lengthBase[ls] + Bits(lengthExtra[ls]);
+                    int ds = Code(5, 0);
+                    if (ds >= 30) return false;
+                    size_t distance = static_cast<size_t>(distBase[ds] + Bits(distExtra[ds]));
+                    if (m_error || distance > out.size()) return false;
+                    size_t from = out.size() - distance;
+                    for (int i = 0; i < length; i++) out.push_back(out[from + i]);
+                }
+            }
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_pos = 0;
+        int m_byte = 0;
+        int m_bitCount = 0;
+        bool m_error = false;
+    };
+
+    uint8_t Paeth(int a, int b, int c)
+    {
+        int p = a + b - c;
+        int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+        return static_cast<uint8_t>(pb <= pc ? b : c);
+    }
+
+    // 校验块结构/CRC/zlib 头/adler32 后还原为 BGRA
+    bool DecodePng(const std::vector<uint8_t>& png, TestImage& image, bool& withAlpha, int* idatCount = nullptr)
+    {
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if (png.size() < 8 || memcmp(png.data(), signature, 8) != 0) return false;
+
+        std::vector<uint8_t> zlib;
+        int width = 0, height = 0, colorType = -1, idats = 0;
+        bool ended = false;
+        size_t p = 8;
+        while (p + 12 <= png.size() && !ended) {
+            uint32_t length = GetBE32(&png[p]);
+            if (p + 12 + length > png.size()) return false;
+            const uint8_t* type = &png[p + 4];
+            const uint8_t* body = type + 4;
+            if (Crc32(0, type, length + 4) != GetBE32(body + length)) return false;
+
+            if (memcmp(type, "IHDR", 4) == 0) {
+                width = static_cast<int>(GetBE32(body));
+                height = static_cast<int>(GetBE32(body + 4));
+                if (body[8] != 8) return false;
+                colorType = body[9];
+            } else if (memcmp(type, "IDAT", 4) == 0) {
+                zlib.insert(zlib.end(), body, body + length);
+                idats++;
+            } else if (memcmp(type, "IEND", 4) == 0) {
+                ended = true;
+            }
+            p += 12 + length;
+        }
+        if (!ended || p != png.size() || (colorType != 2 && colorType != 6)) return false;
+        if (idatCount) *idatCount = idats;
+
+        if (zlib.size() < 6 || ((zlib[0] << 8) | zlib[1]) % 31 != 0 || (zlib[0] & 0x0F) != 8) return false;
+        std::vector<uint8_t> raw;
+        Inflater inflater(zlib.data() + 2, zlib.size() - 2);
+        if (!inflater.Run(raw)) return false;
+        if (inflater.Consumed() + 2 + 4 != zlib.size()) return false;
+        if (Adler32(1, raw.data(), raw.size()) != GetBE32(&zlib[zlib.size() - 4])) return false;
+
+        withAlpha = colorType == 6;
+        int bpp = withAlpha ? 4 : 3;
+        size_t rowBytes = static_cast<size_t>(width) * bpp;
+        if (raw.size() != (rowBytes + 1) * height) return false;
+
+        image = TestImage(width, height);
+        std::vector<uint8_t> previous(rowBytes, 0), current(rowBytes);
+        for (int y = 0; y < height; y++) {
+            const uint8_t* line = raw.data() + y * (rowBytes + 1);
+            int filter = line[0];
+            for (size_t i = 0; i < rowBytes; i++) {
+                int a = i >= static_cast<size_t>(bpp) ? current[i - bpp] : 0;
+                int b = previous[i];
+                int c = i >= static_cast<size_t>(bpp) ? previous[i - bpp] : 0;
+                int v = line[1 + i];
+                switch (filter) {
+                case 0: break;
+                case 1: v += a; break;
+                case 2: v += b; break;
+                case 3: v += (a + b) / 2; break;
+                case 4: v += Paeth(a, b, c); break;
+                default: return false;
+                }
+                current[i] = static_cast<uint8_t>(v);
+            }
+            for (int x = 0; x < width; x++) {
+                const uint8_t* px = current.data() + x * bpp;
+                image.Set(x, y, px[2], px[1], px[0], withAlpha ? px[3] : 255);
+            }
+            previous.swap(current);
+        }
+        return true;
+    }
+
+    // 随机噪声 + 平坦区域 + 渐变, 覆盖 QOI 的所有操作码与 deflate 的长短匹配
+    TestImage Scene(int width, int height, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        TestImage image(width, height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                if (y < height / 3) {
+                    image.Set(x, y, static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()),
+                        static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()));
+                } else if (y < 2 * height / 3) {
+                    image.Set(x, y, 30, 60, 90, (x / 16) % 2 ? 255 : 128);
+                } else {
+                    image.Set(x, y, static_cast<uint8_t>(x), static_cast<uint8_t>(x + y),
+                        static_cast<uint8_t>(y * 3 + rng() % 3), 255);
+                }
+            }
+        }
+        return image;
+    }
+
+    void CheckSamePixels(const TestImage& actual, const TestImage& expected, bool withAlpha)
+    {
+        CHECK(actual.width == expected.width && actual.height == expected.height);
+        for (int y = 0; y < expected.height; y++) {
+            for (int x = 0; x < expected.width; x++) {
+                const uint8_t* a = actual.At(x, y);
+                const uint8_t* e = expected.At(x, y);
+                CHECK(a[0] == e[0] && a[1] == e[1] && a[2] == e[2]);
+                CHECK(a[3] == (withAlpha ? e[3] : 255));
+            }
+        }
+    }
+
+    void TestChecksums()
+    {
+        const uint8_t text[] = "123456789";
+        CHECK(Crc32(0, text, 9) == 0xCBF43926u);
+        CHECK(Adler32(1, text, 9) == 0x091E01DEu);
+
+        std::mt19937 rng(37);
+        std::vector<uint8_t> data(200000);
+        for (auto& v : data) v = static_cast<uint8_t>(rng());
+        for (size_t split : { size_t(0), size_t(1), size_t(5552), size_t(123457), data.size() }) {
+            uint32_t a = Adler32(1, data.data(), split);
+            uint32_t b = Adler32(1, data.data() + split, data.size() - split);
+            CHECK(Adler32Combine(a, b, data.size() - split) == Adler32(1, data.data(), data.size()));
+        }
+    }
+
+    void TestDeflateRoundTrip()
+    {
+        std::mt19937 rng(38);
+        std::vector<uint8_t> data(100000);
+        // 随机段与重复段交替, 包含超过 32K 窗口的距离
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (i / 4096) % 2 ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>("abcabcabd"[i % 9]);
+        }
+
+        // 两段非最终块 + 一段最终块直接拼接
+        std::vector<uint8_t> stream;
+        DeflateFixed(data.data(), 30000, false, stream);
+        DeflateFixed(data.data() + 30000, 50000, false, stream);
+        DeflateFixed(data.data() + 80000, data.size() - 80000, true, stream);
+
+        std::vector<uint8_t> out;
+        Inflater inflater(stream.data(), stream.size());
+        CHECK(inflater.Run(out));
+        CHECK(inflater.Consumed() == stream.size());
+        CHECK(out == data);
+
+        std::vector<uint8_t> empty;
+        DeflateFixed(nullptr, 0, true, empty);
+        out.clear();
+        CHECK(Inflater(empty.data(), empty.size()).Run(out));
+        CHECK(out.empty());
+    }
+
+    void TestQoiRoundTrip()
+    {
+        for (bool withAlpha : { false, true }) {
+            TestImage image = Scene(97, 64, withAlpha ? 1 : 2);
+            std::vector<uint8_t> encoded;
+            EncodeQoi(image.View(), withAlpha, encoded);
+
+            TestImage decoded;
+            int channels = 0;
+            CHECK(DecodeQoi(encoded, decoded, channels));
+            CHECK(channels == (withAlpha ? 4 : 3));
+            CheckSamePixels(decoded, image, withAlpha);
+        }
+
+        // 长游程 (超过 62) 与首像素等于初始值
+        TestImage flat(300, 2, 0);
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 300; x++) flat.Set(x, y, 0, 0, 0, 255);
+        }
+        std::vector<uint8_t> encoded;
+        EncodeQoi(flat.View(), true, encoded);
+        TestImage decoded;
+        int channels = 0;
+        CHECK(DecodeQoi(encoded, decoded, channels));
+        CheckSamePixels(decoded, flat, true);
+        CHECK(encoded.size() < 14 + 16 + 8);
+    }
+
+    void TestPngRoundTrip()
+    {
+        StripeWorkerPool pool(3);
+        for (bool withAlpha : { false, true }) {
+            TestImage image = Scene(131, 150, withAlpha ? 3 : 4);
+
+            std::vector<uint8_t> serial, pooled, single;
+            EncodePng(image.View(), withAlpha, 4, serial);
+            EncodePng(image.View(), withAlpha, 4, pooled, &pool);
+            EncodePng(image.View(), withAlpha, 1, single, &pool);
+            // 条带划分决定输出, 与是否并行无关
+            CHECK(serial == pooled);
+
+            TestImage decoded;
+            bool alpha = false;
+            int idats = 0;
+            CHECK(DecodePng(pooled, decoded, alpha, &idats));
+            CHECK(alpha == withAlpha);
+            CHECK(idats == 4);
+            CheckSamePixels(decoded, image, withAlpha);
+
+            CHECK(DecodePng(single, decoded, alpha, &idats));
+            CHECK(idats == 1);
+            CheckSamePixels(decoded, image, withAlpha);
+        }
+
+        // 条带数受最小行数限制
+        TestImage thin = Scene(40, 40, 5);
+        std::vector<uint8_t> png;
+        EncodePng(thin.View(), false, 16, png, &pool);
+        TestImage decoded;
+        bool alpha = false;
+        int idats = 0;
+        CHECK(DecodePng(png, decoded, alpha, &idats));
+        CHECK(idats == 1);
+        CheckSamePixels(decoded, thin, false);
+    }
+
+    void TestStripePool()
+    {
+        StripeWorkerPool pool(2);
+        // 多个线程同时提交, 每个下标恰好执行一次
+        std::vector<std::thread> callers;
+        std::vector<std::vector<int>> counts(4, std::vector<int>(50, 0));
+        for (int t = 0; t < 4; t++) {
+            callers.emplace_back([&, t] {
+                for (int round = 0; round < 20; round++) {
+                    pool.Run(50, [&, t](int i) { counts[t][i]++; });
+                }
+            });
+        }
+        for (auto& caller : callers) caller.join();
+        for (const auto& c : counts) {
+            for (int v : c) CHECK(v == 20);
+        }
+
+        bool thrown = false;
+        try {
+            pool.Run(8, [](int i) {
+                if (i == 5) throw std::runtime_error("stripe failed");
+            });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+
+        // 没有池线程时在调用线程上依次执行
+        StripeWorkerPool inline0(0);
+        std::vector<int> order;
+        inline0.Run(5, [&](int i) { order.push_back(i); });
+        CHECK((order == std::vector<int>{ 0, 1, 2, 3, 4 }));
+    }
+}
+
+int main()
+{
+    TestChecksums();
+    TestDeflateRoundTrip();
+    TestQoiRoundTrip();
+    TestPngRoundTrip();
+    TestStripePool();
+    std::puts("test_image_encoder: ok");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "ImagePyramid.h"
+#include "TestCommon.h"
+#include <cstring>
+
+namespace
+{
+    // 逐层 2x2 均值 (四舍五入), 奇数尺寸丢弃最后一行/列
+    TestImage ReferenceHalf(const TestImage& src)
+    {
+        TestImage dst(src.width / 2, src.height / 2);
+        for (int y = 0; y < dst.height; y++) {
+            for (int x = 0; x < dst.width; x++) {
+                for (int c = 0; c < 4; c++) {
+                    int sum = src.At(x * 2, y * 2)[c] + src.At(x * 2 + 1, y * 2)[c] +
+                        src.At(x * 2, y * 2 + 1)[c] + src.At(x * 2 + 1, y * 2 + 1)[c];
+                    dst.At(x, y)[c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+        return dst;
+    }
+
+    void CheckPyramid(int width, int height, int levels, bool includeFull, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        TestImage image(width, height);
+        image.FillRandom(rng);
+
+        PyramidLayout layout = ComputePyramidLayout(width, height, levels, includeFull);
+        std::vector<uint8_t> output(layout.totalBytes, 0xCD);
+        PyramidBuilder builder(layout, output.data());
+        for (int y = 0; y < height; y++) builder.AddRow(image.At(0, y));
+
+        if (includeFull) {
+            CHECK(layout.offset[0] == 0);
+            CHECK(memcmp(output.data(), image.pixels.data(), image.pixels.size()) == 0);
+        } else {
+            CHECK(layout.offset[0] == -1);
+        }
+
+        TestImage expected = image;
+        size_t bytes = includeFull ? image.pixels.size() : 0;
+        for (int level = 1; level <= layout.levels; level++) {
+            expected = ReferenceHalf(expected);
+            CHECK(layout.width[level] == expected.width);
+            CHECK(layout.height[level] == expected.height);
+            CHECK(layout.offset[level] == static_cast<int64_t>(bytes));
+            CHECK(memcmp(output.data() + layout.offset[level], expected.pixels.data(), expected.pixels.size()) == 0);
+            bytes += expected.pixels.size();
+        }
+        CHECK(layout.totalBytes == bytes);
+    }
+
+    void TestAgainstReference()
+    {
+        // 奇数宽高覆盖 SIMD 尾部与丢弃的末行/列
+        CheckPyramid(64, 48, 3, true, 1);
+        CheckPyramid(131, 77, 3, true, 2);
+        CheckPyramid(131, 77, 3, false, 3);
+        CheckPyramid(37, 19, 2, false, 4);
+        CheckPyramid(10, 10, 1, true, 5);
+    }
+
+    void TestLayoutLimits()
+    {
+        // 层数上限, 以及缩到 0 时截止
+        PyramidLayout layout = ComputePyramidLayout(100, 100, 10, false);
+        CHECK(layout.levels == kMaxPyramidLevels);
+
+        layout = ComputePyramidLayout(5, 100, 3, true);
+        CHECK(layout.levels == 2);
+        CHECK(layout.width[2] == 1 && layout.height[2] == 25);
+        CHECK(layout.totalBytes == (5 * 100 + 2 * 50 + 1 * 25) * 4u);
+
+        layout = ComputePyramidLayout(1, 1, 3, false);
+        CHECK(layout.levels == 0);
+        CHECK(layout.totalBytes == 0);
+    }
+
+    void TestExtraRowsIgnored()
+    {
+        PyramidLayout layout = ComputePyramidLayout(8, 4, 2, false);
+        std::vector<uint8_t> output(layout.totalBytes + 16, 0xAB);
+        PyramidBuilder builder(layout, output.data());
+        TestImage image(8, 6, 7);
+        for (int y = 0; y < 6; y++) builder.AddRow(image.At(0, y));
+        for (size_t i = 0; i < layout.totalBytes; i++) CHECK(output[i] == 7);
+        for (size_t i = layout.totalBytes; i < output.size(); i++) CHECK(output[i] == 0xAB);
+    }
+}
+
+int main()
+{
+    TestAgainstReference();
+    TestLayoutLimits();
+    TestExtraRowsIgnored();
+    std::puts("test_image_pyramid: ok");
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "IntegralImage.h"
+#include "TestCommon.h"
+
+namespace
+{
+    // 直接在亮度图上逐像素累加的参考实现
+    struct BruteForce
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> luma;
+
+        explicit BruteForce(const TestImage& image) : width(image.width), height(image.height)
+        {
+            luma.resize(static_cast<size_t>(width) * height);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    luma[static_cast<size_t>(y) * width + x] = static_cast<uint8_t>(TestLuma(image.At(x, y)));
+                }
+            }
+        }
+
+        bool Query(const FrameRect& rect, double* mean, double* variance) const
+        {
+            FrameRect r = rect.ClampTo(width, height);
+            if (r.IsEmpty()) return false;
+            uint64_t sum = 0, sumSq = 0;
+            for (int y = r.y; y < r.y + r.height; y++) {
+                for (int x = r.x; x < r.x + r.width; x++) {
+                    uint64_t v = luma[static_cast<size_t>(y) * width + x];
+                    sum += v;
+                    sumSq += v * v;
+                }
+            }
+            double n = static_cast<double>(r.width) * r.height;
+            *mean = sum / n;
+            *variance = std::max(0.0, sumSq / n - *mean * *mean);
+            return true;
+        }
+
+        // 与 previous 相比亮度有变化的条带数
+        int ChangedBands(const BruteForce& previous) const
+        {
+            int count = 0;
+            for (int y0 = 0; y0 < height; y0 += IntegralImage::kBandRows) {
+                int y1 = std::min(y0 + IntegralImage::kBandRows, height);
+                size_t begin = static_cast<size_t>(y0) * width;
+                size_t end = static_cast<size_t>(y1) * width;
+                if (!std::equal(luma.begin() + begin, luma.begin() + end, previous.luma.begin() + begin)) count++;
+            }
+            return count;
+        }
+    };
+
+    FrameRect RandomRect(std::mt19937& rng, int width, int height)
+    {
+        // 允许越界与负坐标, 覆盖裁剪路径
+        FrameRect r;
+        r.x = static_cast<int>(rng() % (width + 20)) - 10;
+        r.y = static_cast<int>(rng() % (height + 20)) - 10;
+        r.width = static_cast<int>(rng() % (width + 10)) + 1;
+        r.height = static_cast<int>(rng() % (height + 10)) + 1;
+        return r;
+    }
+
+    void CheckMatches(const IntegralImage& integral, const BruteForce& expected, std::mt19937& rng, int queries)
+    {
+        CHECK(integral.Width() == expected.width);
+        CHECK(integral.Height() == expected.height);
+
+        std::vector<FrameRect> rects = {
+            FrameRect{},                                          // 整帧
+            FrameRect{ 0, 0, 1, 1 },
+            FrameRect{ expected.width - 1, expected.height - 1, 5, 5 },
+            FrameRect{ 3, IntegralImage::kBandRows - 1, 7, 2 },   // 跨条带边界
+            FrameRect{ expected.width, 0, 4, 4 },                 // 完全在帧外
+            FrameRect{ -8, -8, 8, 8 },
+        };
+        for (int i = 0; i < queries; i++) rects.push_back(RandomRect(rng, expected.width, expected.height));
+
+        std::vector<float> means(rects.size(), -1), variances(rects.size(), -1);
+        integral.QueryBatch(rects.data(), rects.size(), means.data(), variances.data());
+
+        for (size_t i = 0; i < rects.size(); i++) {
+            double mean = 0, variance = 0, expectedMean = 0, expectedVariance = 0;
+            bool ok = integral.Query(rects[i], &mean, &variance);
+            CHECK(ok == expected.Query(rects[i], &expectedMean, &expectedVariance));
+            CHECK_NEAR(mean, expectedMean, 1e-9);
+            CHECK_NEAR(variance, expectedVariance, 1e-6);
+            CHECK_NEAR(means[i], expectedMean, 1e-3);
+            CHECK_NEAR(variances[i], expectedVariance, 1e-1);
+        }
+    }
+
+    // 在随机位置写入随机色块, 返回写入区域
+    FrameRect Scribble(TestImage& image, std::mt19937& rng)
+    {
+        FrameRect r;
+        r.x = static_cast<int>(rng() % image.width);
+        r.y = static_cast<int>(rng() % image.height);
+        r.width = std::min(static_cast<int>(rng() % 40) + 1, image.width - r.x);
+        r.height = std::min(static_cast<int>(rng() % 40) + 1, image.height - r.y);
+        for (int y = r.y; y < r.y + r.height; y++) {
+            for (int x = r.x; x < r.x + r.width; x++) {
+                image.Set(x, y, static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()));
+            }
+        }
+        return r;
+    }
+
+    void TestFullBuild()
+    {
+        std::mt19937 rng(39);
+        // 高度不是条带行数的整数倍
+        TestImage image(203, 77);
+        image.FillRandom(rng);
+
+        IntegralImage integral;
+        CHECK(integral.IsEmpty());
+        CHECK(!integral.Query(FrameRect{}, nullptr, nullptr));
+
+        CHECK(integral.Update(image.View()) == (77 + IntegralImage::kBandRows - 1) / IntegralImage::kBandRows);
+        CheckMatches(integral, BruteForce(image), rng, 300);
+
+        // 相同内容不重算
+        CHECK(integral.Update(image.View()) == 0);
+        CHECK(integral.Update(FrameView()) == 0);
+
+        integral.Clear();
+        CHECK(integral.IsEmpty());
+        CHECK(!integral.Query(FrameRect{}, nullptr, nullptr));
+    }
+
+    void TestDiffUpdate()
+    {
+        std::mt19937 rng(40);
+        TestImage image(160, 100);
+        image.FillRandom(rng);
+
+        IntegralImage integral;
+        integral.Update(image.View());
+        BruteForce previous(image);
+
+        for (int frame = 0; frame < 40; frame++) {
+            int patches = static_cast<int>(rng() % 4);
+            for (int i = 0; i < patches; i++) Scribble(image, rng);
+
+            BruteForce expected(image);
+            CHECK(integral.Update(image.View()) == expected.ChangedBands(previous));
+            CheckMatches(integral, expected, rng, 40);
+            previous = std::move(expected);
+        }
+
+        // 尺寸变化时整帧重建
+        TestImage resized(96, 40);
+        resized.FillRandom(rng);
+        CHECK(integral.Update(resized.View()) == 3);
+        CheckMatches(integral, BruteForce(resized), rng, 100);
+    }
+
+    void TestDirtyRectUpdate()
+    {
+        std::mt19937 rng(41);
+        TestImage image(150, 90);
+        image.FillRandom(rng);
+
+        IntegralImage integral;
+        FrameRect none;
+        // 首帧忽略脏矩形, 整帧构建
+        CHECK(integral.Update(image.View(), &none, 0) == 6);
+
+        for (int frame = 0; frame < 40; frame++) {
+            std::vector<FrameRect> dirty;
+            int patches = static_cast<int>(rng() % 4);
+            for (int i = 0; i < patches; i++) dirty.push_back(Scribble(image, rng));
+            // 空矩形与越界部分被忽略
+            dirty.push_back(FrameRect{ 5, 5, 0, 0 });
+            dirty.push_back(FrameRect{ image.width - 3, image.height - 3, 50, 50 });
+
+            int bands = integral.Update(image.View(), dirty.data(), dirty.size());
+            CHECK(bands >= 1 && bands <= 6);
+            CheckMatches(integral, BruteForce(image), rng, 40);
+        }
+
+        CHECK(integral.Update(image.View(), &none, 0) == 0);
+    }
+
+    void TestLargeArea()
+    {
+        // 面积超过 uint32 取模和可精确还原的上限 (2^32 / 255 像素), 查询需拆分
+        const int width = 4200;
+        const int height = 4100;
+        TestImage image(width, height, 255);
+        for (int y = height / 2; y < height; y++) {
+            std::fill(image.pixels.begin() + static_cast<size_t>(y) * width * 4,
+                image.pixels.begin() + static_cast<size_t>(y + 1) * width * 4, 0);
+        }
+
+        IntegralImage integral;
+        integral.Update(image.View());
+
+        double mean = 0, variance = 0;
+        CHECK(integral.Query(FrameRect{}, &mean, &variance));
+        CHECK_NEAR(mean, 127.5, 1e-9);
+        CHECK_NEAR(variance, 127.5 * 127.5, 1e-6);
+
+        CHECK(integral.Query(FrameRect{ 0, 0, width, height / 2 }, &mean, &variance));
+        CHECK_NEAR(mean, 255, 1e-9);
+        CHECK_NEAR(variance, 0, 1e-6);
+
+        CHECK(integral.Query(FrameRect{ 17, height / 2 - 1, width - 17, 2 }, &mean, &variance));
+        CHECK_NEAR(mean, 127.5, 1e-9);
+    }
+}
+
+int main()
+{
+    TestFullBuild();
+    TestDiffUpdate();
+    TestDirtyRectUpdate();
+    TestLargeArea();
+    std::puts("test_integral_image: ok");
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "PerceptualHash.h"
+#include "TestCommon.h"
+
+namespace
+{
+    // 水平渐变: 每行亮度从左到右递减, 所有相邻格子比较结果为 1
+    TestImage Gradient(int width, int height, bool descending)
+    {
+        TestImage image(width, height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                uint8_t v = static_cast<uint8_t>(descending ? 255 - x * 255 / width : x * 255 / width);
+                image.Set(x, y, v, v, v);
+            }
+        }
+        return image;
+    }
+
+    void TestGradients()
+    {
+        CHECK(ComputeDHash(Gradient(360, 240, true).View()) == ~0ull);
+        CHECK(ComputeDHash(Gradient(360, 240, false).View()) == 0);
+        CHECK(ComputeDHash(TestImage(64, 64, 128).View()) == 0);
+        CHECK(ComputeDHash(FrameView()) == 0);
+    }
+
+    void TestRobustToScaleAndNoise()
+    {
+        std::mt19937 rng(1);
+        TestImage base(320, 200);
+        // 大块随机亮度, 缩放与轻微噪声不应改变格子间的大小关系
+        for (int y = 0; y < base.height; y++) {
+            for (int x = 0; x < base.width; x++) {
+                uint32_t seed = static_cast<uint32_t>((x / 40) * 131 + (y / 25) * 7919);
+                uint8_t v = static_cast<uint8_t>((seed * 2654435761u) >> 24);
+                base.Set(x, y, v, v, v);
+            }
+        }
+        uint64_t h0 = ComputeDHash(base.View());
+
+        TestImage doubled(base.width * 2, base.height * 2);
+        for (int y = 0; y < doubled.height; y++) {
+            for (int x = 0; x < doubled.width; x++) {
+                const uint8_t* p = base.At(x / 2, y / 2);
+                int noise = static_cast<int>(rng() % 5) - 2;
+                uint8_t v = static_cast<uint8_t>(std::min(255, std::max(0, p[0] + noise)));
+                doubled.Set(x, y, v, v, v);
+            }
+        }
+        CHECK(HammingDistance(h0, ComputeDHash(doubled.View())) <= 4);
+
+        TestImage other(320, 200);
+        other.FillRandom(rng);
+        CHECK(HammingDistance(h0, ComputeDHash(other.View())) > 10);
+    }
+
+    void TestHashIndex()
+    {
+        HashIndex index;
+        int distance = 0;
+        CHECK(index.FindNearest(0, &distance) == -1);
+        CHECK(distance == -1);
+
+        index.Add("menu", 0x00FF00FF00FF00FFull);
+        index.Add("battle", 0xFFFFFFFF00000000ull);
+        index.Add("menu", 0x00FF00FF00FF00FEull);
+        CHECK(index.Size() == 3);
+
+        int best = index.FindNearest(0x00FF00FF00FF00FCull, &distance);
+        CHECK(index.LabelAt(best) == "menu");
+        CHECK(distance == 1);
+
+        best = index.FindNearest(0xFFFFFFFF00000001ull, &distance);
+        CHECK(index.LabelAt(best) == "battle");
+        CHECK(distance == 1);
+
+        CHECK(index.Remove("menu") == 2);
+        CHECK(index.Size() == 1);
+        index.Clear();
+        CHECK(index.Size() == 0);
+    }
+}
+
+int main()
+{
+    TestGradients();
+    TestRobustToScaleAndNoise();
+    TestHashIndex();
+    std::puts("test_perceptual_hash: ok");
+    return 0;
+}
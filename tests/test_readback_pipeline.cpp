@@ -0,0 +1,188 @@
+#include "StagedPipeline.h"
+
+namespace
+{
+    constexpr int kFormats[] = { PipelineBGRA, PipelineBGR, PipelineGray };
+    constexpr int kScales[] = { 1, 2, 4 };
+
+    // 带行填充的源帧, 模拟映射后的暂存纹理; pixelBytes 为 8 时是 RGBA16F
+    struct PaddedFrame
+    {
+        std::vector<uint8_t> bytes;
+        FrameView view;
+
+        PaddedFrame(int width, int height, size_t pixelBytes, size_t padding)
+        {
+            view.width = width;
+            view.height = height;
+            view.stride = static_cast<size_t>(width) * pixelBytes + padding;
+            bytes.resize(view.stride * height);
+            view.data = bytes.data();
+        }
+    };
+
+    // 宽高为奇数, 不是 2/4 的整数倍
+    PaddedFrame RandomFrame(std::mt19937& rng, int width, int height)
+    {
+        PaddedFrame frame(width, height, 4, 52);
+        for (auto& v : frame.bytes) v = static_cast<uint8_t>(rng());
+        return frame;
+    }
+
+    // 线性值约 [0, 8) 的半精度像素, alpha 为 1.0
+    PaddedFrame RandomHdrFrame(std::mt19937& rng, int width, int height)
+    {
+        PaddedFrame frame(width, height, 8, 24);
+        for (int y = 0; y < height; y++) {
+            uint16_t* row = reinterpret_cast<uint16_t*>(frame.bytes.data() + y * frame.view.stride);
+            for (int x = 0; x < width * 4; x++) {
+                row[x] = x % 4 == 3 ? 0x3C00 : static_cast<uint16_t>(((rng() % 18) << 10) | (rng() & 0x3FF));
+            }
+        }
+        return frame;
+    }
+
+    void CheckStatsEqual(const FrameStatistics& fused, const FrameStatistics& staged, int channels)
+    {
+        CHECK(fused.pixelCount == staged.pixelCount);
+        for (int c = 0; c < channels; c++) {
+            CHECK(memcmp(fused.histogram[c], staged.histogram[c], sizeof(fused.histogram[c])) == 0);
+            CHECK(fused.sum[c] == staged.sum[c]);
+            CHECK(fused.minValue[c] == staged.minValue[c]);
+            CHECK(fused.maxValue[c] == staged.maxValue[c]);
+        }
+    }
+
+    // 融合内核输出与分步参考逐字节一致; reference 为 8 位 BGRA 的等价源 (HDR 时为整帧色调映射结果)
+    void CheckMatchesStaged(const FrameView& source, const HdrConverter* hdr, const FrameView& reference,
+        const PipelineRequest& request)
+    {
+        PipelineLayout layout;
+        if (!ComputePipelineLayout(source.width, source.height, request, layout)) {
+            // 裁剪后不足一个缩放块
+            FrameRect crop = request.crop.ClampTo(source.width, source.height);
+            CHECK(crop.width < request.scale || crop.height < request.scale);
+            return;
+        }
+        CHECK(layout.crop.x + layout.crop.width <= source.width);
+        CHECK(layout.crop.y + layout.crop.height <= source.height);
+
+        // 输出缓冲多留一段哨兵, 检查内核不越界写
+        std::vector<uint8_t> output(layout.bytes + 64, 0xCD);
+        FrameStatistics fused, staged;
+        StagedBuffers buffers;
+        RunPipeline(source, hdr, request, layout, output.data(), request.stats ? &fused : nullptr);
+        RunStaged(reference, layout, request.format, request.scale, request.stats, buffers, &staged);
+
+        CHECK(memcmp(output.data(), StagedOutput(buffers, request.scale), layout.bytes) == 0);
+        for (size_t i = layout.bytes; i < output.size(); i++) CHECK(output[i] == 0xCD);
+        if (request.stats) CheckStatsEqual(fused, staged, layout.channels);
+    }
+
+    std::vector<FrameRect> EdgeCrops(int width, int height)
+    {
+        return {
+            FrameRect{},                                   // 整帧, 奇数宽高留下不足一块的边缘
+            FrameRect{ 1, 1, width - 2, height - 2 },
+            FrameRect{ 3, 5, 97, 61 },                     // 奇数起点与尺寸
+            FrameRect{ width - 37, height - 23, 100, 100 }, // 越过右下边缘, 被截断
+            FrameRect{ -5, -7, 50, 41 },                   // 负坐标
+            FrameRect{ width - 1, 0, 1, height },          // 最右一列
+            FrameRect{ 0, height - 3, width, 3 },          // 底部三行, 缩小 4 倍时为空
+            FrameRect{ 10, 10, 3, 3 },
+        };
+    }
+
+    void TestAllKernels()
+    {
+        std::mt19937 rng(36);
+        PaddedFrame frame = RandomFrame(rng, 203, 149);
+        const FrameView& source = frame.view;
+
+        std::vector<FrameRect> crops = EdgeCrops(source.width, source.height);
+        for (int i = 0; i < 20; i++) {
+            FrameRect r;
+            r.x = static_cast<int>(rng() % source.width);
+            r.y = static_cast<int>(rng() % source.height);
+            r.width = static_cast<int>(rng() % source.width) + 1;
+            r.height = static_cast<int>(rng() % source.height) + 1;
+            crops.push_back(r);
+        }
+
+        // 3 种格式 x 3 种缩放 x 是否统计 = 18 个特化内核
+        int kernels = 0;
+        for (int format : kFormats) {
+            for (int scale : kScales) {
+                for (bool stats : { false, true }) {
+                    for (const FrameRect& crop : crops) {
+                        PipelineRequest request;
+                        request.crop = crop;
+                        request.format = format;
+                        request.scale = scale;
+                        request.stats = stats;
+                        CheckMatchesStaged(source, nullptr, source, request);
+                    }
+                    kernels++;
+                }
+            }
+        }
+        CHECK(kernels == 18);
+    }
+
+    void TestHdrSource()
+    {
+        std::mt19937 rng(37);
+        PaddedFrame frame = RandomHdrFrame(rng, 141, 77);
+        const FrameView& source = frame.view;
+
+        ToneMapParams params;
+        params.op = ToneMapAces;
+        params.exposure = 1.5f;
+        HdrConverter hdr(params);
+
+        // 参考: 先把整帧色调映射为 8 位 BGRA, 再走分步流程
+        TestImage mapped(source.width, source.height);
+        for (int y = 0; y < source.height; y++) {
+            hdr.ConvertRow(reinterpret_cast<const uint16_t*>(source.Row(y)), mapped.At(0, y), source.width, 4);
+        }
+
+        for (int format : kFormats) {
+            for (int scale : kScales) {
+                for (const FrameRect& crop : EdgeCrops(source.width, source.height)) {
+                    PipelineRequest request;
+                    request.crop = crop;
+                    request.format = format;
+                    request.scale = scale;
+                    request.stats = true;
+                    CheckMatchesStaged(source, &hdr, mapped.View(), request);
+                }
+            }
+        }
+    }
+
+    void TestRejectsInvalidRequests()
+    {
+        PipelineLayout layout;
+        PipelineRequest request;
+        CHECK(ComputePipelineLayout(64, 48, request, layout));
+        CHECK(layout.width == 64 && layout.height == 48 && layout.channels == 4 && layout.bytes == 64 * 48 * 4);
+
+        request.scale = 3;
+        CHECK(!ComputePipelineLayout(64, 48, request, layout));
+        request.scale = 1;
+        request.format = 3;
+        CHECK(!ComputePipelineLayout(64, 48, request, layout));
+        request.format = PipelineGray;
+        request.crop = FrameRect{ 100, 100, 10, 10 };
+        CHECK(!ComputePipelineLayout(64, 48, request, layout));
+    }
+}
+
+int main()
+{
+    TestAllKernels();
+    TestHdrSource();
+    TestRejectsInvalidRequests();
+    std::puts("test_readback_pipeline: ok");
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include "ScrollDetector.h"
+#include "TestCommon.h"
+#include <cstring>
+
+namespace
+{
+    constexpr int kWidth = 128;
+    constexpr int kHeader = 20;   // 固定标题栏, 不在 ROI 内
+    constexpr int kViewport = 160;
+    const FrameRect kRoi{ 0, kHeader, kWidth, kViewport };
+
+    // 长页面在视口中向下滚动 offset 行: 标题栏固定, ROI 显示页面的 [offset, offset + kViewport) 行
+    TestImage Viewport(const TestImage& page, const TestImage& header, int offset)
+    {
+        TestImage frame(kWidth, kHeader + kViewport);
+        memcpy(frame.pixels.data(), header.pixels.data(), header.pixels.size());
+        memcpy(frame.At(0, kHeader), page.At(0, offset), static_cast<size_t>(kWidth) * kViewport * 4);
+        return frame;
+    }
+
+    TestImage RandomImage(int width, int height, std::mt19937& rng)
+    {
+        TestImage image(width, height);
+        image.FillRandom(rng);
+        return image;
+    }
+
+    bool PixelsEqual(const std::vector<uint8_t>& pixels, int width, int height, const TestImage& page, int firstRow, int rows)
+    {
+        if (width != kWidth || height != rows) return false;
+        return memcmp(pixels.data(), page.At(0, firstRow), pixels.size()) == 0;
+    }
+
+    bool StitchedEquals(const ScrollTracker& tracker, const TestImage& page, int firstRow, int rows)
+    {
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        if (!tracker.CopyStitched(pixels, &width, &height)) return false;
+        return PixelsEqual(pixels, width, height, page, firstRow, rows);
+    }
+
+    bool TakeEquals(ScrollTracker& tracker, const TestImage& page, int firstRow, int rows)
+    {
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        if (!tracker.TakeStitched(pixels, &width, &height)) return false;
+        return PixelsEqual(pixels, width, height, page, firstRow, rows);
+    }
+
+    void TestDetectVertical()
+    {
+        std::mt19937 rng(1);
+        TestImage page = RandomImage(kWidth, 600, rng);
+        TestImage header = RandomImage(kWidth, kHeader, rng);
+
+        TestImage a = Viewport(page, header, 100);
+        TestImage b = Viewport(page, header, 113);
+        ScrollResult down = DetectScroll(a.View(), b.View(), kRoi, ScrollAxisVertical);
+        CHECK(down.dx == 0);
+        CHECK(down.dy == 13);
+        CHECK(down.confidence > 0.9f);
+        CHECK(down.newBand.x == 0 && down.newBand.width == kWidth);
+        CHECK(down.newBand.y == kHeader + kViewport - 13 && down.newBand.height == 13);
+
+        ScrollResult up = DetectScroll(b.View(), a.View(), kRoi, ScrollAxisVertical);
+        CHECK(up.dy == -13);
+        CHECK(up.newBand.y == kHeader && up.newBand.height == 13);
+
+        ScrollResult none = DetectScroll(a.View(), a.View(), kRoi, ScrollAxisVertical);
+        CHECK(none.dx == 0 && none.dy == 0);
+        CHECK(none.confidence > 0.9f);
+        CHECK(none.newBand.IsEmpty());
+
+        // 内容整体替换时无法对齐
+        TestImage other = Viewport(RandomImage(kWidth, 600, rng), header, 0);
+        CHECK(DetectScroll(a.View(), other.View(), kRoi, ScrollAxisVertical).confidence == 0);
+    }
+
+    void TestDetectHorizontal()
+    {
+        std::mt19937 rng(2);
+        TestImage page = RandomImage(600, 96, rng);
+        auto view = [&](int offset) {
+            TestImage frame(kViewport, page.height);
+            for (int y = 0; y < page.height; y++) {
+                memcpy(frame.At(0, y), page.At(offset, y), static_cast<size_t>(kViewport) * 4);
+            }
+            return frame;
+        };
+
+        TestImage a = view(30);
+        TestImage b = view(48);
+        FrameRect roi{ 0, 0, kViewport, page.height };
+        ScrollResult right = DetectScroll(a.View(), b.View(), roi, ScrollAxisHorizontal);
+        CHECK(right.dx == 18 && right.dy == 0);
+        CHECK(right.newBand.x == kViewport - 18 && right.newBand.width == 18);
+        CHECK(right.newBand.y == 0 && right.newBand.height == page.height);
+
+        ScrollResult left = DetectScroll(b.View(), a.View(), roi, ScrollAxisBoth);
+        CHECK(left.dx == -18 && left.dy == 0);
+        CHECK(left.newBand.x == 0 && left.newBand.width == 18);
+    }
+
+    void TestTrackerStitch()
+    {
+        std::mt19937 rng(3);
+        TestImage page = RandomImage(kWidth, 800, rng);
+        TestImage header = RandomImage(kWidth, kHeader, rng);
+
+        // 从 100 行开始, 先向上滚到 60, 再逐步向下滚到 420; 中间重复帧表示静止
+        ScrollTracker tracker(kRoi, ScrollAxisVertical, true, 64ull * 1024 * 1024);
+        const int offsets[] = { 100, 80, 60, 60, 75, 120, 200, 290, 290, 360, 420 };
+        int64_t time = 0;
+        for (int offset : offsets) {
+            tracker.Submit(Viewport(page, header, offset).View(), time += 16);
+        }
+
+        ScrollState state = tracker.State();
+        CHECK(state.totalX == 0);
+        CHECK(state.totalY == 420 - 100);
+        CHECK(state.last.dy == 60);
+        CHECK(state.lostFrames == 0);
+        CHECK(state.restarts == 0);
+        CHECK(state.timestampMs == time);
+        CHECK(StitchedEquals(tracker, page, 60, 420 + kViewport - 60));
+    }
+
+    void TestTrackerLostFrames()
+    {
+        std::mt19937 rng(4);
+        TestImage page = RandomImage(kWidth, 600, rng);
+        TestImage next = RandomImage(kWidth, 600, rng);
+        TestImage header = RandomImage(kWidth, kHeader, rng);
+        auto noise = [&]() { return Viewport(RandomImage(kWidth, kViewport, rng), header, 0); };
+
+        ScrollTracker tracker(kRoi, ScrollAxisVertical, true, 64ull * 1024 * 1024, 3);
+        tracker.Submit(Viewport(page, header, 0).View(), 1);
+        tracker.Submit(Viewport(page, header, 10).View(), 2);
+
+        // 少于上限的丢失帧 (过渡动画) 保留参考帧, 之后仍能与其对齐
+        tracker.Submit(noise().View(), 3);
+        tracker.Submit(noise().View(), 4);
+        ScrollState state = tracker.State();
+        CHECK(state.lostFrames == 2);
+        CHECK(state.last.confidence == 0);
+        CHECK(state.totalY == 10);
+
+        tracker.Submit(Viewport(page, header, 25).View(), 5);
+        state = tracker.State();
+        CHECK(state.lostFrames == 0);
+        CHECK(state.last.dy == 15);
+        CHECK(state.totalY == 25);
+        CHECK(state.restarts == 0);
+        CHECK(StitchedEquals(tracker, page, 0, 25 + kViewport));
+
+        // 页面跳转: 连续 3 帧无法对齐后以第 3 帧为新的参考帧, 偏移与画布重新开始
+        tracker.Submit(Viewport(next, header, 0).View(), 6);
+        tracker.Submit(Viewport(next, header, 40).View(), 7);
+        CHECK(tracker.State().lostFrames == 2);
+        tracker.Submit(Viewport(next, header, 100).View(), 8);
+        state = tracker.State();
+        CHECK(state.restarts == 1);
+        CHECK(state.lostFrames == 0);
+        CHECK(state.totalY == 0);
+        CHECK(state.timestampMs == 8);
+        CHECK(StitchedEquals(tracker, next, 100, kViewport));
+        // 重新开始前的画布保留到被取走
+        CHECK(state.canvasPending && !state.canvasTruncated && state.canvasResets == 0);
+
+        tracker.Submit(Viewport(next, header, 109).View(), 9);
+        state = tracker.State();
+        CHECK(state.last.dy == 9);
+        CHECK(state.totalY == 9);
+        CHECK(state.restarts == 1);
+        CHECK(StitchedEquals(tracker, next, 100, 9 + kViewport));
+
+        CHECK(TakeEquals(tracker, page, 0, 25 + kViewport));
+        CHECK(!tracker.State().canvasPending);
+        // 取走后返回当前画布, 且不释放它
+        CHECK(TakeEquals(tracker, next, 100, 9 + kViewport));
+        CHECK(TakeEquals(tracker, next, 100, 9 + kViewport));
+
+        // ROI 尺寸变化 (窗口缩小) 同样计为一次重新开始
+        TestImage small(kWidth, kHeader + 100);
+        memcpy(small.pixels.data(), page.pixels.data(), small.pixels.size());
+        tracker.Submit(small.View(), 10);
+        state = tracker.State();
+        CHECK(state.restarts == 2);
+        CHECK(state.totalY == 0);
+        CHECK(state.canvasPending && state.canvasResets == 0);
+
+        // 保留的画布未取走时再次重新开始, 较旧的一张被丢弃
+        tracker.Submit(Viewport(page, header, 0).View(), 11);
+        state = tracker.State();
+        CHECK(state.restarts == 3);
+        CHECK(state.canvasPending && state.canvasResets == 1);
+        std::vector<uint8_t> pixels;
+        int width = 0, height = 0;
+        CHECK(tracker.TakeStitched(pixels, &width, &height));
+        CHECK(width == kWidth && height == 100);
+        CHECK(memcmp(pixels.data(), small.At(0, kHeader), pixels.size()) == 0);
+        CHECK(TakeEquals(tracker, page, 0, kViewport));
+    }
+
+    void TestTrackerTruncated()
+    {
+        std::mt19937 rng(5);
+        TestImage page = RandomImage(kWidth, 600, rng);
+        TestImage next = RandomImage(kWidth, 600, rng);
+        TestImage header = RandomImage(kWidth, kHeader, rng);
+
+        // 画布上限只比视口多 40 行
+        const size_t maxBytes = static_cast<size_t>(kWidth) * (kViewport + 40) * 4;
+        ScrollTracker tracker(kRoi, ScrollAxisVertical, true, maxBytes, 1);
+        tracker.Submit(Viewport(page, header, 0).View(), 1);
+        tracker.Submit(Viewport(page, header, 30).View(), 2);
+        CHECK(!tracker.State().canvasTruncated);
+
+        // 超出上限的新露出区域无法写入, 偏移仍继续累计
+        tracker.Submit(Viewport(page, header, 60).View(), 3);
+        ScrollState state = tracker.State();
+        CHECK(state.totalY == 60);
+        CHECK(state.canvasTruncated);
+        CHECK(StitchedEquals(tracker, page, 0, kViewport + 30));
+
+        // 截断标记随画布保留, 直到画布被取走
+        tracker.Submit(Viewport(next, header, 0).View(), 4);
+        state = tracker.State();
+        CHECK(state.restarts == 1);
+        CHECK(state.canvasPending && state.canvasTruncated);
+        CHECK(TakeEquals(tracker, page, 0, kViewport + 30));
+        state = tracker.State();
+        CHECK(!state.canvasPending && !state.canvasTruncated);
+    }
+}
+
+int main()
+{
+    TestDetectVertical();
+    TestDetectHorizontal();
+    TestTrackerStitch();
+    TestTrackerLostFrames();
+    TestTrackerTruncated();
+    std::puts("test_scroll_detector: ok");
+    return 0;
+}
@@ -0,0 +1,187 @@
+#include "SessionPool.h"
+#include "TestCommon.h"
+
+namespace
+{
+    struct FakeSession
+    {
+        static int alive;
+
+        uint64_t key;
+        size_t bytes;
+        bool paused = false;
+        bool valid = true;   // 模拟窗口关闭或句柄被复用
+        int resumes = 0;
+
+        FakeSession(uint64_t k, size_t b) : key(k), bytes(b) { alive++; }
+        ~FakeSession() { alive--; }
+
+        void PauseCapture() { paused = true; }
+        void ResumeCapture()
+        {
+            paused = false;
+            resumes++;
+        }
+        size_t EstimatedMemoryBytes() const { return bytes; }
+    };
+
+    int FakeSession::alive = 0;
+
+    constexpr size_t kSessionBytes = 1000;
+
+    struct Fixture
+    {
+        int created = 0;
+        bool failNext = false;
+        SessionPool<FakeSession> pool{ [this](uint64_t key, std::string* outError) -> std::unique_ptr<FakeSession> {
+            if (failNext) {
+                failNext = false;
+                if (outError) *outError = "window gone";
+                return nullptr;
+            }
+            created++;
+            return std::make_unique<FakeSession>(key, kSessionBytes);
+        }, [](uint64_t key, FakeSession& session) { return session.valid && session.key == key; } };
+    };
+
+    void TestPrewarmAndTake()
+    {
+        Fixture f;
+        CHECK(f.pool.Prewarm(1));
+        CHECK(f.pool.Prewarm(1)); // 已预热时只刷新 LRU
+        CHECK(f.created == 1);
+        CHECK(f.pool.Contains(1));
+        CHECK(f.pool.MemoryUsage() == kSessionBytes);
+
+        auto session = f.pool.Take(1);
+        CHECK(session && session->key == 1);
+        CHECK(!session->paused && session->resumes == 1);
+        CHECK(!f.pool.Contains(1));
+        CHECK(f.pool.MemoryUsage() == 0);
+
+        auto fresh = f.pool.Take(2);
+        CHECK(fresh && fresh->key == 2);
+        CHECK(f.created == 2);
+
+        SessionPoolStats stats = f.pool.Stats();
+        CHECK(stats.hits == 1 && stats.misses == 1 && stats.evictions == 0);
+
+        // 放回时暂停, 活动会话不计入预算
+        f.pool.Put(1, std::move(session));
+        CHECK(f.pool.Contains(1));
+        CHECK(f.pool.Size() == 1);
+        CHECK(FakeSession::alive == 2);
+    }
+
+    void TestFactoryFailure()
+    {
+        Fixture f;
+        std::string error;
+        f.failNext = true;
+        CHECK(!f.pool.Prewarm(5, &error));
+        CHECK(error == "window gone");
+        f.failNext = true;
+        CHECK(!f.pool.Take(5, &error));
+        CHECK(f.pool.Stats().misses == 0);
+        CHECK(f.pool.Size() == 0);
+    }
+
+    void TestStaleSessionRebuilt()
+    {
+        Fixture f;
+        f.pool.Prewarm(3);
+        auto stale = f.pool.Take(3);
+        stale->valid = false;
+        FakeSession* raw = stale.get();
+        f.pool.Put(3, std::move(stale));
+
+        // 命中失效会话: 丢弃后重建, 计为淘汰 + 未命中
+        auto taken = f.pool.Take(3);
+        CHECK(taken && taken.get() != raw && taken->valid);
+        CHECK(f.created == 2);
+        CHECK(FakeSession::alive == 1);
+        SessionPoolStats stats = f.pool.Stats();
+        CHECK(stats.hits == 1 && stats.misses == 1 && stats.evictions == 1);
+
+        // 预热同样替换失效会话
+        taken->valid = false;
+        f.pool.Put(3, std::move(taken));
+        CHECK(f.pool.Prewarm(3));
+        CHECK(f.created == 3);
+        CHECK(f.pool.Size() == 1 && f.pool.MemoryUsage() == kSessionBytes);
+        CHECK(f.pool.Take(3)->valid);
+
+        // 重建失败时失效会话也不会留在池中
+        auto last = f.pool.Take(4);
+        last->valid = false;
+        f.pool.Put(4, std::move(last));
+        f.failNext = true;
+        std::string error;
+        CHECK(!f.pool.Take(4, &error));
+        CHECK(error == "window gone");
+        CHECK(!f.pool.Contains(4) && f.pool.Size() == 0 && f.pool.MemoryUsage() == 0);
+        CHECK(FakeSession::alive == 0);
+    }
+
+    void TestLruEviction()
+    {
+        Fixture f;
+        SessionPoolBudget budget;
+        budget.maxSessions = 3;
+        budget.maxBytes = 100 * kSessionBytes;
+        f.pool.SetBudget(budget);
+
+        for (uint64_t key = 1; key <= 3; key++) f.pool.Prewarm(key);
+        // 访问 1 后 2 成为最久未用
+        f.pool.Prewarm(1);
+        f.pool.Prewarm(4);
+        CHECK(f.pool.Size() == 3);
+        CHECK(!f.pool.Contains(2));
+        CHECK(f.pool.Contains(1) && f.pool.Contains(3) && f.pool.Contains(4));
+        CHECK(f.pool.Stats().evictions == 1);
+
+        // 按显存预算淘汰
+        budget.maxBytes = 2 * kSessionBytes;
+        f.pool.SetBudget(budget);
+        CHECK(f.pool.Size() == 2);
+        CHECK(!f.pool.Contains(3));
+        CHECK(f.pool.MemoryUsage() == 2 * kSessionBytes);
+        CHECK(FakeSession::alive == 2);
+
+        f.pool.Clear();
+        CHECK(f.pool.Size() == 0 && f.pool.MemoryUsage() == 0);
+        CHECK(FakeSession::alive == 0);
+    }
+
+    void TestPutReplacesSameKey()
+    {
+        Fixture f;
+        f.pool.Prewarm(7);
+        auto replacement = std::make_unique<FakeSession>(7, 3 * kSessionBytes);
+        FakeSession* raw = replacement.get();
+        f.pool.Put(7, std::move(replacement));
+        CHECK(f.pool.Size() == 1);
+        CHECK(f.pool.MemoryUsage() == 3 * kSessionBytes);
+        CHECK(raw->paused);
+
+        auto taken = f.pool.Take(7);
+        CHECK(taken.get() == raw);
+        CHECK(f.pool.Remove(7) == false);
+
+        f.pool.Put(8, nullptr);
+        CHECK(f.pool.Size() == 0);
+    }
+}
+
+int main()
+{
+    TestPrewarmAndTake();
+    CHECK(FakeSession::alive == 0);
+    TestFactoryFailure();
+    TestStaleSessionRebuilt();
+    TestLruEviction();
+    TestPutReplacesSameKey();
+    CHECK(FakeSession::alive == 0);
+    std::puts("test_session_pool: ok");
+    return 0;
+}
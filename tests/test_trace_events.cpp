@@ -0,0 +1,152 @@
+#include "TraceEvents.h"
+#include "TestCommon.h"
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    constexpr uint64_t kCapacity = 1 << 14;
+
+    struct ParsedEvent
+    {
+        int64_t ts;
+        int64_t dur;
+    };
+
+    // 只解析 SerializeChromeTrace 自身的输出格式
+    std::vector<ParsedEvent> ParseEvents(const std::string& json, const char* name)
+    {
+        std::vector<ParsedEvent> events;
+        std::string key = std::string("{\"name\":\"") + name + "\",\"cat\":\"wgc\",\"ph\":\"X\"";
+        size_t pos = 0;
+        while ((pos = json.find(key, pos)) != std::string::npos) {
+            size_t ts = json.find("\"ts\":", pos);
+            size_t dur = json.find("\"dur\":", pos);
+            CHECK(ts != std::string::npos && dur != std::string::npos);
+            events.push_back({ std::atoll(json.c_str() + ts + 5), std::atoll(json.c_str() + dur + 6) });
+            pos = dur;
+        }
+        return events;
+    }
+
+    void TestRecordAndClear()
+    {
+        SetTraceEnabled(true);
+        ClearTrace();
+        for (int i = 0; i < 5; i++) TraceRecord("basic", i * 10, i);
+
+        std::string json = SerializeChromeTrace();
+        CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+        CHECK(json.find("\"thread_name\"") != std::string::npos);
+        std::vector<ParsedEvent> events = ParseEvents(json, "basic");
+        CHECK(events.size() == 5);
+        for (int i = 0; i < 5; i++) {
+            CHECK(events[i].ts == i * 10);
+            CHECK(events[i].dur == i);
+        }
+
+        ClearTrace();
+        CHECK(ParseEvents(SerializeChromeTrace(), "basic").empty());
+    }
+
+    void TestWrapAround()
+    {
+        ClearTrace();
+        const uint64_t total = kCapacity * 2 + 100;
+        for (uint64_t i = 0; i < total; i++) TraceRecord("wrap", static_cast<int64_t>(i), 0);
+
+        // 缓冲已满时最旧的槽位视为可能正被覆盖, 少导出一个事件
+        std::vector<ParsedEvent> events = ParseEvents(SerializeChromeTrace(), "wrap");
+        CHECK(events.size() == kCapacity - 1);
+        CHECK(events.front().ts == static_cast<int64_t>(total - kCapacity + 1));
+        CHECK(events.back().ts == static_cast<int64_t>(total - 1));
+    }
+
+    void TestConcurrentWriter()
+    {
+        ClearTrace();
+        std::atomic<bool> stop{ false };
+        // 每个事件 ts == dur, 导出到撕裂的事件时两者不一致
+        std::thread writer([&] {
+            for (int64_t i = 0; !stop.load(std::memory_order_relaxed); i++) TraceRecord("race", i, i);
+        });
+
+        for (int round = 0; round < 200; round++) {
+            std::vector<ParsedEvent> events = ParseEvents(SerializeChromeTrace(), "race");
+            CHECK(events.size() < kCapacity);
+            for (size_t i = 0; i < events.size(); i++) {
+                CHECK(events[i].ts == events[i].dur);
+                if (i > 0) CHECK(events[i].ts == events[i - 1].ts + 1);
+            }
+        }
+
+        stop = true;
+        writer.join();
+    }
+
+    void TestShortLivedThreads()
+    {
+        ClearTrace();
+        TraceRecord("main", 0, 0);
+        CHECK(TraceThreadBufferCount() == 1);
+
+        // 线程池上的回调线程不断更替: 已退出线程的缓冲数有上限, 最近退出的线程的事件仍可导出
+        for (int i = 0; i < 100; i++) {
+            std::thread([i] { TraceRecord("worker", i, 0); }).join();
+        }
+        CHECK(TraceThreadBufferCount() <= 1 + 16);
+        std::vector<ParsedEvent> events = ParseEvents(SerializeChromeTrace(), "worker");
+        CHECK(!events.empty() && events.size() <= 16);
+        CHECK(std::any_of(events.begin(), events.end(), [](const ParsedEvent& e) { return e.ts == 99; }));
+
+        // ClearTrace 释放已退出线程的缓冲, 存活线程的缓冲保留
+        std::atomic<bool> recorded{ false };
+        std::atomic<bool> stop{ false };
+        std::thread live([&] {
+            TraceRecord("live", 1, 0);
+            recorded = true;
+            while (!stop) std::this_thread::yield();
+            TraceRecord("live", 2, 0);
+        });
+        while (!recorded) std::this_thread::yield();
+        ClearTrace();
+        CHECK(TraceThreadBufferCount() == 2);
+        stop = true;
+        live.join();
+
+        events = ParseEvents(SerializeChromeTrace(), "live");
+        CHECK(events.size() == 1 && events[0].ts == 2);
+        CHECK(ParseEvents(SerializeChromeTrace(), "main").empty());
+        ClearTrace();
+        CHECK(TraceThreadBufferCount() == 1);
+    }
+
+    void TestScope()
+    {
+        ClearTrace();
+        SetTraceEnabled(false);
+        {
+            WGC_TRACE_SCOPE("scope");
+        }
+        CHECK(ParseEvents(SerializeChromeTrace(), "scope").empty());
+
+        SetTraceEnabled(true);
+        {
+            WGC_TRACE_SCOPE("scope");
+        }
+        std::vector<ParsedEvent> events = ParseEvents(SerializeChromeTrace(), "scope");
+        CHECK(events.size() == 1);
+        CHECK(events[0].dur >= 0);
+    }
+}
+
+int main()
+{
+    TestRecordAndClear();
+    TestWrapAround();
+    TestConcurrentWriter();
+    TestShortLivedThreads();
+    TestScope();
+    std::puts("test_trace_events: ok");
+    return 0;
+}
@@ -0,0 +1,340 @@
+#include "TriggerEngine.h"
+#include "TestCommon.h"
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    TestImage Copy(const TestImage& image, const FrameRect& r)
+    {
+        TestImage out(r.width, r.height);
+        for (int y = 0; y < r.height; y++) {
+            for (int x = 0; x < r.width; x++) {
+                const uint8_t* p = image.At(r.x + x, r.y + y);
+                out.Set(x, y, p[0], p[1], p[2], p[3]);
+            }
+        }
+        return out;
+    }
+
+    void Fill(TestImage& image, const FrameRect& r, uint8_t v)
+    {
+        for (int y = r.y; y < r.y + r.height; y++) {
+            for (int x = r.x; x < r.x + r.width; x++) image.Set(x, y, v, v, v);
+        }
+    }
+
+    void TestRegionMae()
+    {
+        std::mt19937 rng(34);
+        // 带行填充的子区域, 奇数宽度覆盖 SIMD 尾部
+        TestImage a(53, 20), b(61, 20);
+        a.FillRandom(rng);
+        b.FillRandom(rng);
+        const int width = 37, height = 13;
+
+        uint64_t total = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < 3; c++) total += std::abs(a.At(x + 2, y + 1)[c] - b.At(x + 5, y + 3)[c]);
+            }
+        }
+        double expected = static_cast<double>(total) / (width * height * 3);
+        double actual = RegionMae(a.At(2, 1), a.width * 4u, b.At(5, 3), b.width * 4u, width, height);
+        CHECK_NEAR(actual, expected, 1e-9);
+
+        // alpha 不参与比较
+        TestImage c(9, 3, 100), d(9, 3, 100);
+        for (int x = 0; x < 9; x++) d.At(x, 1)[3] = 0;
+        CHECK(RegionMae(c.At(0, 0), 36, d.At(0, 0), 36, 9, 3) == 0);
+        CHECK(RegionMae(c.At(0, 0), 36, d.At(0, 0), 36, 0, 3) == 0);
+    }
+
+    void TestRegionSsim()
+    {
+        std::mt19937 rng(35);
+        std::vector<uint8_t> a(64 * 40), b(a.size());
+        for (auto& v : a) v = static_cast<uint8_t>(rng());
+        CHECK_NEAR(RegionSsim(a.data(), a.data(), 64, 40), 1.0, 1e-9);
+
+        for (size_t i = 0; i < a.size(); i++) b[i] = static_cast<uint8_t>(255 - a[i]);
+        CHECK(RegionSsim(a.data(), b.data(), 64, 40) < 0);
+
+        for (size_t i = 0; i < a.size(); i++) b[i] = static_cast<uint8_t>(std::min(255, a[i] + static_cast<int>(rng() % 8)));
+        double s = RegionSsim(a.data(), b.data(), 64, 40);
+        CHECK(s > 0.9 && s < 1.0);
+    }
+
+    void TestInvalidSpecs()
+    {
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = 7;
+        CHECK(engine.Add(spec) == 0);
+
+        spec.kind = TriggerMatch;
+        spec.referenceWidth = 4;
+        spec.referenceHeight = 4;
+        spec.reference.resize(4 * 4 * 4 - 1);
+        CHECK(engine.Add(spec) == 0);
+        CHECK(engine.Size() == 0);
+    }
+
+    void TestMatch(int metric, double threshold)
+    {
+        std::mt19937 rng(36);
+        TestImage target(80, 60), other(80, 60);
+        target.FillRandom(rng);
+        other.FillRandom(rng);
+        const FrameRect roi{ 10, 8, 32, 24 };
+        TestImage reference = Copy(target, roi);
+
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerMatch;
+        spec.roi = roi;
+        spec.metric = metric;
+        spec.threshold = threshold;
+        spec.oneShot = false;
+        spec.reference = reference.pixels;
+        spec.referenceWidth = reference.width;
+        spec.referenceHeight = reference.height;
+        int id = engine.Add(spec);
+        CHECK(id > 0);
+
+        TriggerEvent event;
+        engine.Evaluate(other.View(), 1);
+        CHECK(!engine.Poll(id, event));
+
+        // 进入相符状态时触发一次, 保持相符不重复触发
+        engine.Evaluate(target.View(), 2);
+        CHECK(engine.Poll(id, event));
+        CHECK(event.id == id && event.timestampMs == 2);
+        if (metric == TriggerMetricMae) CHECK(event.score == 0);
+        else CHECK_NEAR(event.score, 1.0, 1e-9);
+        engine.Evaluate(target.View(), 3);
+        CHECK(!engine.Poll(id, event));
+
+        engine.Evaluate(other.View(), 4);
+        engine.Evaluate(target.View(), 5);
+        CHECK(engine.Poll(0, event));
+        CHECK(event.timestampMs == 5);
+
+        // ROI 被帧裁剪后尺寸不符, 不会误判
+        TestImage small(20, 20);
+        engine.Evaluate(small.View(), 6);
+        CHECK(!engine.Poll(id, event));
+        CHECK(engine.Size() == 1);
+    }
+
+    void TestChanged()
+    {
+        TestImage frame(64, 48, 50);
+        const FrameRect roi{ 8, 8, 16, 16 };
+
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerChanged;
+        spec.roi = roi;
+        spec.threshold = 10;
+        spec.oneShot = true;
+        int id = engine.Add(spec);
+
+        TriggerEvent event;
+        engine.Evaluate(frame.View(), 1);
+        engine.Evaluate(frame.View(), 2);
+        CHECK(!engine.Poll(id, event));
+
+        // ROI 外的变化与低于阈值的变化都不触发
+        Fill(frame, FrameRect{ 40, 30, 10, 10 }, 255);
+        Fill(frame, FrameRect{ 8, 8, 16, 2 }, 90); // MAE = 40 * 2 / 16 = 5
+        engine.Evaluate(frame.View(), 3);
+        CHECK(!engine.Poll(id, event));
+
+        Fill(frame, roi, 80);
+        engine.Evaluate(frame.View(), 4);
+        CHECK(engine.Poll(id, event));
+        CHECK(event.timestampMs == 4);
+        CHECK_NEAR(event.score, 30, 1e-9);
+        // oneShot 触发后移除
+        CHECK(engine.Size() == 0);
+        CHECK(!engine.Wait(id, 1000, event));
+    }
+
+    // 模拟读回线程: 只把收集到的区域从 source 复制到其余为随机内容的帧
+    TestImage CopyRegions(const TestImage& source, const std::vector<FrameRect>& regions, std::mt19937& rng)
+    {
+        TestImage frame(source.width, source.height);
+        frame.FillRandom(rng);
+        for (const FrameRect& region : regions) {
+            FrameRect r = region.ClampTo(source.width, source.height);
+            for (int y = r.y; y < r.y + r.height; y++) {
+                memcpy(frame.At(r.x, y), source.At(r.x, y), static_cast<size_t>(r.width) * 4);
+            }
+        }
+        return frame;
+    }
+
+    void TestCollectedRegions()
+    {
+        std::mt19937 rng(37);
+        TestImage source(96, 64, 50);
+
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerChanged;
+        spec.threshold = 10;
+        spec.oneShot = false;
+        spec.roi = FrameRect{ 4, 4, 16, 8 };
+        int a = engine.Add(spec);
+        spec.roi = FrameRect{ 80, 50, 40, 40 }; // 超出帧的部分在复制时裁剪
+        int b = engine.Add(spec);
+
+        std::vector<FrameRect> regions;
+        engine.CollectRegions(regions);
+        CHECK(regions.size() == 2);
+        CHECK(regions[0].x == 4 && regions[1].x == 80);
+
+        // 收集之后登记的条件 ROI 未被复制, 本帧不参与评估, 否则会以随机内容为基准
+        spec.roi = FrameRect{ 40, 20, 16, 16 };
+        int c = engine.Add(spec);
+
+        TriggerEvent event;
+        for (int64_t t = 1; t <= 3; t++) engine.Evaluate(CopyRegions(source, regions, rng).View(), t, 0, true);
+        CHECK(!engine.Poll(0, event));
+
+        // c 此时才建立基准; 与 source 一致时三个条件都不触发
+        regions.clear();
+        engine.CollectRegions(regions);
+        CHECK(regions.size() == 3);
+        engine.Evaluate(CopyRegions(source, regions, rng).View(), 4, 0, true);
+        engine.Evaluate(CopyRegions(source, regions, rng).View(), 5, 0, true);
+        CHECK(!engine.Poll(0, event));
+
+        Fill(source, FrameRect{ 40, 20, 16, 16 }, 200);
+        engine.Evaluate(CopyRegions(source, regions, rng).View(), 6, 0, true);
+        CHECK(engine.Poll(0, event));
+        CHECK(event.id == c && event.timestampMs == 6);
+        CHECK(!engine.Poll(a, event) && !engine.Poll(b, event));
+    }
+
+    void TestStable()
+    {
+        // 时间戳取在真实时钟之后, Poll 内部按真实时钟 Tick 时不会提前触发
+        const int64_t t0 = CaptureClockMs() + 3600 * 1000;
+        TestImage frame(32, 32, 10);
+
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerStable;
+        spec.threshold = 2;
+        spec.durationMs = 100;
+        spec.oneShot = false;
+        int id = engine.Add(spec);
+
+        TriggerEvent event;
+        engine.Evaluate(frame.View(), t0);
+        engine.Evaluate(frame.View(), t0 + 50);
+        CHECK(!engine.Poll(id, event));
+
+        // 变化重新计时
+        Fill(frame, FrameRect{ 0, 0, 32, 32 }, 40);
+        engine.Evaluate(frame.View(), t0 + 60);
+        engine.Tick(t0 + 150);
+        CHECK(!engine.Poll(id, event));
+
+        // 没有新帧时由 Tick 按时间判定, 只触发一次
+        engine.Tick(t0 + 160);
+        CHECK(engine.Poll(id, event));
+        CHECK(event.timestampMs == t0 + 160);
+        engine.Tick(t0 + 400);
+        engine.Evaluate(frame.View(), t0 + 410);
+        CHECK(!engine.Poll(id, event));
+
+        // 变化后可再次触发
+        Fill(frame, FrameRect{ 0, 0, 32, 32 }, 90);
+        engine.Evaluate(frame.View(), t0 + 500);
+        engine.Evaluate(frame.View(), t0 + 600);
+        CHECK(engine.Poll(id, event));
+        CHECK(event.timestampMs == t0 + 600);
+    }
+
+    void TestWaitAndClear()
+    {
+        TestImage a(16, 16, 0), b(16, 16, 200);
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerChanged;
+        spec.threshold = 1;
+        int id = engine.Add(spec);
+        engine.Evaluate(a.View(), 1);
+
+        std::thread producer([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            engine.Evaluate(b.View(), 2);
+        });
+        TriggerEvent event;
+        CHECK(engine.Wait(id, 5000, event));
+        CHECK(event.id == id);
+        producer.join();
+
+        int64_t start = CaptureClockMs();
+        spec.oneShot = false;
+        int other = engine.Add(spec);
+        CHECK(!engine.Wait(other, 30, event));
+        CHECK(CaptureClockMs() - start >= 30);
+
+        // Clear 唤醒等待者并返回 false
+        std::thread clearer([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            engine.Clear();
+        });
+        start = CaptureClockMs();
+        CHECK(!engine.Wait(0, 5000, event));
+        CHECK(CaptureClockMs() - start < 4000);
+        clearer.join();
+        CHECK(engine.Size() == 0);
+    }
+
+    void TestQueueLimit()
+    {
+        TestImage a(8, 8, 0), b(8, 8, 100);
+        TriggerEngine engine;
+        TriggerSpec spec;
+        spec.kind = TriggerChanged;
+        spec.threshold = 1;
+        spec.oneShot = false;
+        engine.Add(spec);
+
+        engine.Evaluate(a.View(), 0);
+        for (int i = 1; i <= 300; i++) engine.Evaluate((i & 1 ? b : a).View(), i);
+
+        // 队列满时丢弃最旧的事件
+        TriggerEvent event;
+        int count = 0;
+        int64_t first = -1;
+        while (engine.Poll(0, event)) {
+            if (first < 0) first = event.timestampMs;
+            count++;
+        }
+        CHECK(count == 256);
+        CHECK(first == 300 - 256 + 1);
+    }
+}
+
+int main()
+{
+    TestRegionMae();
+    TestRegionSsim();
+    TestInvalidSpecs();
+    TestMatch(TriggerMetricMae, 1.0);
+    TestMatch(TriggerMetricSsim, 0.95);
+    TestChanged();
+    TestCollectedRegions();
+    TestStable();
+    TestWaitAndClear();
+    TestQueueLimit();
+    std::puts("test_trigger_engine: ok");
+    return 0;
+}
@@ -3,7 +3,10 @@ wgc-python - Windows Graphics Capture Python 绑定
 """
 import ctypes
 import os
-from typing import List, Tuple, Optional
+from typing import Iterator, List, Tuple, Optional
+
+_SAVE_CALLBACK = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_int)
+
 
 class _WGCDLL:
     def __init__(self):
@@ -56,6 +59,284 @@ class _WGCDLL:
         self._dll.IsPaused.argtypes = []
         self._dll.IsPaused.restype = ctypes.c_int
 
+        self._dll.PrewarmWindow.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+        self._dll.PrewarmWindow.restype = ctypes.c_int
+
+        self._dll.SwitchToWindow.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+        self._dll.SwitchToWindow.restype = ctypes.c_int
+
+        self._dll.SetSessionPoolBudget.argtypes = [ctypes.c_int, ctypes.c_int]
+        self._dll.SetSessionPoolBudget.restype = None
+
+        self._dll.ReleaseSessionPool.argtypes = []
+        self._dll.ReleaseSessionPool.restype = None
+
+        self._dll.GetSessionPoolInfo.argtypes = [
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_ulonglong),
+            ctypes.POINTER(ctypes.c_ulonglong),
+            ctypes.POINTER(ctypes.c_ulonglong)
+        ]
+        self._dll.GetSessionPoolInfo.restype = ctypes.c_int
+
+        self._dll.SetHdrCapture.argtypes = [ctypes.c_int]
+        self._dll.SetHdrCapture.restype = None
+
+        self._dll.IsHdrCapture.argtypes = []
+        self._dll.IsHdrCapture.restype = ctypes.c_int
+
+        self._dll.SetToneMapping.argtypes = [ctypes.c_int, ctypes.c_float, ctypes.c_float]
+        self._dll.SetToneMapping.restype = None
+
+        self._dll.GetLatestFrameBGR.argtypes = [
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.GetLatestFrameBGR.restype = ctypes.c_int
+
+        self._dll.GetLatestFramePyramid.argtypes = [
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.c_int,
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_longlong)
+        ]
+        self._dll.GetLatestFramePyramid.restype = ctypes.c_int
+
+        stats_outputs = [
+            ctypes.POINTER(ctypes.c_uint),
+            ctypes.POINTER(ctypes.c_ulonglong),
+            ctypes.POINTER(ctypes.c_ubyte),
+            ctypes.POINTER(ctypes.c_ubyte),
+            ctypes.POINTER(ctypes.c_ulonglong)
+        ]
+        roi_args = [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+
+        self._dll.GetFrameStats.argtypes = roi_args + stats_outputs
+        self._dll.GetFrameStats.restype = ctypes.c_int
+
+        self._dll.GetLatestFrameWithStats.argtypes = [
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ] + roi_args + stats_outputs
+        self._dll.GetLatestFrameWithStats.restype = ctypes.c_int
+
+        self._dll.GetLatestFrameProcessed.argtypes = roi_args + [
+            ctypes.c_int, ctypes.c_int,
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ] + stats_outputs
+        self._dll.GetLatestFrameProcessed.restype = ctypes.c_int
+
+        color_args = [ctypes.c_int, ctypes.c_char_p, ctypes.c_int] + roi_args
+        self._dll.FindColorBlobs.argtypes = color_args + [
+            ctypes.c_int, ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_float),
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.FindColorBlobs.restype = ctypes.c_int
+
+        self._dll.GetColorMask.argtypes = color_args + [
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.GetColorMask.restype = ctypes.c_int
+
+        self._dll.ComputeFrameHash.argtypes = [ctypes.POINTER(ctypes.c_ulonglong)]
+        self._dll.ComputeFrameHash.restype = ctypes.c_int
+
+        self._dll.ComputeImageHash.argtypes = [
+            ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_ulonglong)
+        ]
+        self._dll.ComputeImageHash.restype = ctypes.c_int
+
+        self._dll.AddReferenceHash.argtypes = [ctypes.c_char_p, ctypes.c_ulonglong]
+        self._dll.AddReferenceHash.restype = None
+
+        self._dll.RemoveReferenceHash.argtypes = [ctypes.c_char_p]
+        self._dll.RemoveReferenceHash.restype = ctypes.c_int
+
+        self._dll.ClearReferenceHashes.argtypes = []
+        self._dll.ClearReferenceHashes.restype = None
+
+        self._dll.GetReferenceHashCount.argtypes = []
+        self._dll.GetReferenceHashCount.restype = ctypes.c_int
+
+        self._dll.ClassifyFrame.argtypes = [
+            ctypes.c_char_p, ctypes.c_int, ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.ClassifyFrame.restype = ctypes.c_int
+
+        self._dll.GetCaptureClockMs.argtypes = []
+        self._dll.GetCaptureClockMs.restype = ctypes.c_longlong
+
+        self._dll.EnableFrameHistory.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        self._dll.EnableFrameHistory.restype = ctypes.c_int
+
+        self._dll.DisableFrameHistory.argtypes = []
+        self._dll.DisableFrameHistory.restype = None
+
+        self._dll.GetFrameHistoryInfo.argtypes = [
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_longlong)
+        ]
+        self._dll.GetFrameHistoryInfo.restype = ctypes.c_int
+
+        self._dll.ExtractFrameHistory.argtypes = [
+            ctypes.c_longlong, ctypes.c_longlong, ctypes.c_int,
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_longlong)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.ExtractFrameHistory.restype = ctypes.c_int
+
+        self._dll.AddMatchTrigger.argtypes = roi_args + [
+            ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_double, ctypes.c_int
+        ]
+        self._dll.AddMatchTrigger.restype = ctypes.c_int
+
+        self._dll.AddChangeTrigger.argtypes = roi_args + [ctypes.c_double, ctypes.c_int]
+        self._dll.AddChangeTrigger.restype = ctypes.c_int
+
+        self._dll.AddStableTrigger.argtypes = roi_args + [ctypes.c_double, ctypes.c_int, ctypes.c_int]
+        self._dll.AddStableTrigger.restype = ctypes.c_int
+
+        self._dll.RemoveTrigger.argtypes = [ctypes.c_int]
+        self._dll.RemoveTrigger.restype = ctypes.c_int
+
+        self._dll.ClearTriggers.argtypes = []
+        self._dll.ClearTriggers.restype = None
+
+        trigger_outputs = [
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_double)
+        ]
+        self._dll.WaitForTrigger.argtypes = [ctypes.c_int, ctypes.c_int] + trigger_outputs
+        self._dll.WaitForTrigger.restype = ctypes.c_int
+
+        self._dll.PollTrigger.argtypes = [ctypes.c_int] + trigger_outputs
+        self._dll.PollTrigger.restype = ctypes.c_int
+
+        self._dll.SchedulerAddTarget.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int]
+        self._dll.SchedulerAddTarget.restype = ctypes.c_int
+
+        self._dll.SchedulerRemoveTarget.argtypes = [ctypes.c_int]
+        self._dll.SchedulerRemoveTarget.restype = None
+
+        self._dll.SchedulerSetBudget.argtypes = [ctypes.c_double, ctypes.c_double, ctypes.c_int, ctypes.c_int]
+        self._dll.SchedulerSetBudget.restype = None
+
+        self._dll.SchedulerStart.argtypes = []
+        self._dll.SchedulerStart.restype = ctypes.c_int
+
+        self._dll.SchedulerStop.argtypes = []
+        self._dll.SchedulerStop.restype = None
+
+        self._dll.SchedulerRelease.argtypes = []
+        self._dll.SchedulerRelease.restype = None
+
+        self._dll.SchedulerGetFrame.argtypes = [
+            ctypes.c_int,
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_ulonglong)
+        ]
+        self._dll.SchedulerGetFrame.restype = ctypes.c_int
+
+        self._dll.SchedulerGetStats.argtypes = [ctypes.POINTER(ctypes.c_ulonglong)] * 4
+        self._dll.SchedulerGetStats.restype = ctypes.c_int
+
+        self._dll.SaveFrameAsync.argtypes = [ctypes.c_char_p, ctypes.c_int]
+        self._dll.SaveFrameAsync.restype = ctypes.c_int
+
+        self._dll.GetSaveStatus.argtypes = [ctypes.c_int]
+        self._dll.GetSaveStatus.restype = ctypes.c_int
+
+        self._dll.WaitForSave.argtypes = [ctypes.c_int, ctypes.c_int]
+        self._dll.WaitForSave.restype = ctypes.c_int
+
+        self._dll.SetSaveCallback.argtypes = [_SAVE_CALLBACK]
+        self._dll.SetSaveCallback.restype = None
+
+        self._dll.EnableScrollTracking.argtypes = roi_args + [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        self._dll.EnableScrollTracking.restype = ctypes.c_int
+
+        self._dll.DisableScrollTracking.argtypes = []
+        self._dll.DisableScrollTracking.restype = None
+
+        self._dll.GetScrollState.argtypes = [
+            ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_float), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_longlong),
+            ctypes.POINTER(ctypes.c_longlong), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.GetScrollState.restype = ctypes.c_int
+
+        self._dll.GetStitchedImage.argtypes = [
+            ctypes.POINTER(ctypes.POINTER(ctypes.c_ubyte)),
+            ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.GetStitchedImage.restype = ctypes.c_int
+
+        self._dll.DetectScrollOffset.argtypes = [
+            ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_int
+        ] + roi_args + [
+            ctypes.c_int, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_float), ctypes.POINTER(ctypes.c_int)
+        ]
+        self._dll.DetectScrollOffset.restype = ctypes.c_int
+
+        self._dll.EnableIntegralImage.argtypes = []
+        self._dll.EnableIntegralImage.restype = ctypes.c_int
+
+        self._dll.DisableIntegralImage.argtypes = []
+        self._dll.DisableIntegralImage.restype = None
+
+        self._dll.QueryRegionStats.argtypes = [
+            ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+            ctypes.POINTER(ctypes.c_float), ctypes.POINTER(ctypes.c_float),
+            ctypes.POINTER(ctypes.c_longlong)
+        ]
+        self._dll.QueryRegionStats.restype = ctypes.c_int
+
+        self._dll.GetIntegralImageInfo.argtypes = [
+            ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int),
+            ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_longlong)
+        ]
+        self._dll.GetIntegralImageInfo.restype = ctypes.c_int
+
+        self._dll.EnableTracing.argtypes = [ctypes.c_int]
+        self._dll.EnableTracing.restype = None
+
+        self._dll.IsTracing.argtypes = []
+        self._dll.IsTracing.restype = ctypes.c_int
+
+        self._dll.ResetTrace.argtypes = []
+        self._dll.ResetTrace.restype = None
+
+        self._dll.DumpTrace.argtypes = [ctypes.c_char_p]
+        self._dll.DumpTrace.restype = ctypes.c_int
+
         self._dll.GetLastErrorMsg.restype = ctypes.c_char_p
 
 _dll = _WGCDLL()
@@ -139,6 +420,671 @@ def is_paused() -> bool:
     """是否已暂停捕获"""
     return _dll._dll.IsPaused() != 0
 
+def prewarm_window(title: str, class_name: str) -> bool:
+    """为窗口预先创建暂停的捕获会话, 之后 switch_to_window 只需恢复"""
+    return _dll._dll.PrewarmWindow(title.encode('utf-8'), class_name.encode('utf-8')) != 0
+
+def switch_to_window(title: str, class_name: str) -> bool:
+    """切换捕获目标: 已预热时直接恢复, 原目标的会话暂停后放回池中"""
+    return _dll._dll.SwitchToWindow(title.encode('utf-8'), class_name.encode('utf-8')) != 0
+
+def set_session_pool_budget(max_sessions: int = -1, max_memory_mb: int = -1):
+    """设置会话池预算 (空闲会话数 / 显存估算 MB, 负数表示保持原值), 超出时按 LRU 淘汰"""
+    _dll._dll.SetSessionPoolBudget(max_sessions, max_memory_mb)
+
+def release_session_pool():
+    """释放池中所有空闲会话"""
+    _dll._dll.ReleaseSessionPool()
+
+def get_session_pool_info() -> Optional[dict]:
+    """返回会话池状态 {'sessions', 'memory_bytes', 'hits', 'misses', 'evictions'}"""
+    sessions = ctypes.c_int()
+    memory = ctypes.c_longlong()
+    hits = ctypes.c_ulonglong()
+    misses = ctypes.c_ulonglong()
+    evictions = ctypes.c_ulonglong()
+    if _dll._dll.GetSessionPoolInfo(ctypes.byref(sessions), ctypes.byref(memory), ctypes.byref(hits),
+                                    ctypes.byref(misses), ctypes.byref(evictions)) == 0:
+        return None
+    return {
+        'sessions': sessions.value,
+        'memory_bytes': memory.value,
+        'hits': hits.value,
+        'misses': misses.value,
+        'evictions': evictions.value,
+    }
+
+
+TONEMAP_CLAMP = 0
+TONEMAP_REINHARD = 1
+TONEMAP_ACES = 2
+
+def set_hdr_capture(enable: bool):
+    """HDR (FP16) 捕获开关, 下次 start_capture 时生效"""
+    _dll._dll.SetHdrCapture(1 if enable else 0)
+
+def is_hdr_capture() -> bool:
+    """当前会话是否为 HDR 捕获"""
+    return _dll._dll.IsHdrCapture() != 0
+
+def set_tone_mapping(operator: int = TONEMAP_REINHARD, exposure: float = 1.0, white_point: float = 4.0):
+    """设置 HDR 到 8 位的色调映射 (TONEMAP_CLAMP / TONEMAP_REINHARD / TONEMAP_ACES)"""
+    _dll._dll.SetToneMapping(operator, exposure, white_point)
+
+def get_frame_bgr() -> Optional[Tuple[bytes, int, int]]:
+    """获取最新帧 (BGR 3 通道), 返回 (数据, 宽度, 高度) 或 None"""
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+
+    if _dll._dll.GetLatestFrameBGR(ctypes.byref(image_data_ptr), ctypes.byref(width), ctypes.byref(height)) == 0:
+        return None
+
+    image_data = ctypes.string_at(image_data_ptr, width.value * height.value * 3)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    return image_data, width.value, height.value
+
+def get_frame_pyramid(levels: int = 3, include_full: bool = True) -> Optional[List[Optional[Tuple[bytes, int, int]]]]:
+    """获取最新帧及其 1/2, 1/4, 1/8 金字塔, 返回 [(数据, 宽度, 高度), ...], 下标 0 为原图 (未包含时为 None)"""
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    widths = (ctypes.c_int * 4)()
+    heights = (ctypes.c_int * 4)()
+    offsets = (ctypes.c_longlong * 4)()
+    total = ctypes.c_longlong()
+
+    if _dll._dll.GetLatestFramePyramid(ctypes.byref(image_data_ptr), levels, 1 if include_full else 0,
+                                       widths, heights, offsets, ctypes.byref(total)) == 0:
+        return None
+
+    buffer = ctypes.string_at(image_data_ptr, total.value)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    result = []
+    for i in range(4):
+        if offsets[i] < 0 or widths[i] <= 0:
+            result.append(None)
+            continue
+        size = widths[i] * heights[i] * 4
+        result.append((buffer[offsets[i]:offsets[i] + size], widths[i], heights[i]))
+
+    while len(result) > 1 and result[-1] is None:
+        result.pop()
+    return result
+
+def _stats_buffers(histogram: bool):
+    hist = (ctypes.c_uint * 1024)() if histogram else None
+    sums = (ctypes.c_ulonglong * 4)()
+    mins = (ctypes.c_ubyte * 4)()
+    maxs = (ctypes.c_ubyte * 4)()
+    count = ctypes.c_ulonglong()
+    return hist, sums, mins, maxs, count
+
+def _stats_result(hist, sums, mins, maxs, count) -> dict:
+    n = count.value
+    return {
+        'histogram': [list(hist[c * 256:(c + 1) * 256]) for c in range(4)] if hist is not None else None,
+        'sum': list(sums),
+        'mean': [v / n if n else 0.0 for v in sums],
+        'min': list(mins),
+        'max': list(maxs),
+        'pixel_count': n,
+    }
+
+def get_frame_stats(roi: Optional[Tuple[int, int, int, int]] = None, histogram: bool = True) -> Optional[dict]:
+    """计算最新帧 (或 ROI) 的 BGRA 各通道统计量, 不拷贝帧数据"""
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    hist, sums, mins, maxs, count = _stats_buffers(histogram)
+    if _dll._dll.GetFrameStats(x, y, w, h, hist, sums, mins, maxs, ctypes.byref(count)) == 0:
+        return None
+    return _stats_result(hist, sums, mins, maxs, count)
+
+def get_frame_with_stats(roi: Optional[Tuple[int, int, int, int]] = None,
+                         histogram: bool = True) -> Optional[Tuple[bytes, int, int, dict]]:
+    """获取最新帧, 并在同一遍拷贝中计算统计量, 返回 (数据, 宽度, 高度, 统计量) 或 None"""
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    hist, sums, mins, maxs, count = _stats_buffers(histogram)
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+
+    if _dll._dll.GetLatestFrameWithStats(ctypes.byref(image_data_ptr), ctypes.byref(width), ctypes.byref(height),
+                                         x, y, w, h, hist, sums, mins, maxs, ctypes.byref(count)) == 0:
+        return None
+
+    image_data = ctypes.string_at(image_data_ptr, width.value * height.value * 4)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    return image_data, width.value, height.value, _stats_result(hist, sums, mins, maxs, count)
+
+PIPELINE_BGRA = 0
+PIPELINE_BGR = 1
+PIPELINE_GRAY = 2
+
+def get_frame_processed(crop: Optional[Tuple[int, int, int, int]] = None, format: int = PIPELINE_BGRA,
+                        scale: int = 1, stats: bool = False,
+                        histogram: bool = True) -> Optional[Tuple[bytes, int, int, int, Optional[dict]]]:
+    """裁剪 -> 格式转换 -> 缩小 (1/2/4) -> 统计在一遍读回内完成
+
+    返回 (数据, 宽度, 高度, 通道数, 统计量或 None); 统计量针对输出图像
+    """
+    x, y, w, h = crop if crop else (0, 0, 0, 0)
+    if stats:
+        hist, sums, mins, maxs, count = _stats_buffers(histogram)
+        count_ref = ctypes.byref(count)
+    else:
+        hist = sums = mins = maxs = count_ref = None
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+    channels = ctypes.c_int()
+
+    if _dll._dll.GetLatestFrameProcessed(x, y, w, h, format, scale, ctypes.byref(image_data_ptr),
+                                         ctypes.byref(width), ctypes.byref(height), ctypes.byref(channels),
+                                         hist, sums, mins, maxs, count_ref) == 0:
+        return None
+
+    image_data = ctypes.string_at(image_data_ptr, width.value * height.value * channels.value)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    result = _stats_result(hist, sums, mins, maxs, count) if stats else None
+    return image_data, width.value, height.value, channels.value, result
+
+COLOR_BGR = 0
+COLOR_HSV = 1
+
+def _pack_color_ranges(ranges) -> Optional[bytes]:
+    packed = bytearray()
+    for lower, upper in ranges:
+        packed += bytes(lower[:3]) + bytes(upper[:3])
+    return bytes(packed) if packed else None
+
+def find_color_blobs(ranges, color_space: int = COLOR_HSV,
+                     roi: Optional[Tuple[int, int, int, int]] = None,
+                     min_area: int = 1, connectivity: int = 8, max_blobs: int = 256) -> Optional[List[dict]]:
+    """在最新帧 (或 ROI) 中按颜色区间分割并标记连通域
+
+    ranges 为 [(lower, upper), ...], 每项 3 个分量, 多个区间取并集;
+    HSV 下 H 为 0-179, lower H > upper H 表示跨越 0 (如红色).
+    返回按面积降序的 [{'x', 'y', 'width', 'height', 'area', 'cx', 'cy'}, ...]
+    """
+    packed = _pack_color_ranges(ranges)
+    if packed is None:
+        return None
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    boxes = (ctypes.c_int * (max_blobs * 5))()
+    centroids = (ctypes.c_float * (max_blobs * 2))()
+    count = ctypes.c_int()
+
+    if _dll._dll.FindColorBlobs(color_space, packed, len(packed) // 6, x, y, w, h, min_area, connectivity,
+                                boxes, centroids, max_blobs, ctypes.byref(count)) == 0:
+        return None
+
+    return [{
+        'x': boxes[i * 5], 'y': boxes[i * 5 + 1],
+        'width': boxes[i * 5 + 2], 'height': boxes[i * 5 + 3], 'area': boxes[i * 5 + 4],
+        'cx': centroids[i * 2], 'cy': centroids[i * 2 + 1],
+    } for i in range(min(count.value, max_blobs))]
+
+def get_color_mask(ranges, color_space: int = COLOR_HSV,
+                   roi: Optional[Tuple[int, int, int, int]] = None) -> Optional[Tuple[bytes, int, int]]:
+    """获取颜色区间的单通道掩码 (命中为 255), 返回 (数据, 宽度, 高度) 或 None"""
+    packed = _pack_color_ranges(ranges)
+    if packed is None:
+        return None
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    mask_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+
+    if _dll._dll.GetColorMask(color_space, packed, len(packed) // 6, x, y, w, h,
+                              ctypes.byref(mask_ptr), ctypes.byref(width), ctypes.byref(height)) == 0:
+        return None
+
+    mask = ctypes.string_at(mask_ptr, width.value * height.value)
+    _dll._dll.FreeImageData(mask_ptr)
+    return mask, width.value, height.value
+
+def compute_frame_hash() -> Optional[int]:
+    """计算最新帧的 64 位感知哈希 (dHash)"""
+    value = ctypes.c_ulonglong()
+    if _dll._dll.ComputeFrameHash(ctypes.byref(value)) == 0:
+        return None
+    return value.value
+
+def compute_image_hash(data: bytes, width: int, height: int) -> Optional[int]:
+    """计算 BGRA 图像数据的 64 位感知哈希"""
+    if len(data) < width * height * 4:
+        return None
+    value = ctypes.c_ulonglong()
+    if _dll._dll.ComputeImageHash(data, width, height, ctypes.byref(value)) == 0:
+        return None
+    return value.value
+
+def add_reference_hash(label: str, hash_value: int):
+    """添加带标签的参考哈希 (同一标签可添加多个)"""
+    _dll._dll.AddReferenceHash(label.encode('utf-8'), hash_value)
+
+def add_reference_image(label: str, data: bytes, width: int, height: int) -> bool:
+    """以 BGRA 参考截图添加参考哈希"""
+    hash_value = compute_image_hash(data, width, height)
+    if hash_value is None:
+        return False
+    add_reference_hash(label, hash_value)
+    return True
+
+def remove_reference_hash(label: str) -> int:
+    """删除指定标签的全部参考哈希, 返回删除数量"""
+    return _dll._dll.RemoveReferenceHash(label.encode('utf-8'))
+
+def clear_reference_hashes():
+    """清空参考哈希索引"""
+    _dll._dll.ClearReferenceHashes()
+
+def get_reference_hash_count() -> int:
+    """参考哈希数量"""
+    return _dll._dll.GetReferenceHashCount()
+
+def classify_frame(max_distance: int = 64) -> Optional[Tuple[str, int]]:
+    """识别最新帧对应的参考画面, 返回 (标签, 汉明距离) 或 None"""
+    label = ctypes.create_string_buffer(256)
+    distance = ctypes.c_int()
+    if _dll._dll.ClassifyFrame(label, len(label), ctypes.byref(distance)) == 0:
+        return None
+    if distance.value > max_distance:
+        return None
+    return label.value.decode('utf-8'), distance.value
+
+
+def get_capture_clock_ms() -> int:
+    """帧时间戳使用的单调时钟 (毫秒)"""
+    return _dll._dll.GetCaptureClockMs()
+
+def enable_frame_history(window_ms: int = 30000, memory_budget_mb: int = 256,
+                         keyframe_interval: int = 60, max_fps: int = 30) -> bool:
+    """启用最近 N 毫秒的压缩帧历史 (后台线程压缩, 不影响捕获)"""
+    return _dll._dll.EnableFrameHistory(window_ms, memory_budget_mb, keyframe_interval, max_fps) != 0
+
+def disable_frame_history():
+    """停用并释放帧历史"""
+    _dll._dll.DisableFrameHistory()
+
+def get_frame_history_info() -> Optional[dict]:
+    """帧历史状态: 帧数、时间范围、压缩后占用内存"""
+    count = ctypes.c_int()
+    oldest = ctypes.c_longlong()
+    newest = ctypes.c_longlong()
+    memory = ctypes.c_longlong()
+    if _dll._dll.GetFrameHistoryInfo(ctypes.byref(count), ctypes.byref(oldest),
+                                     ctypes.byref(newest), ctypes.byref(memory)) == 0:
+        return None
+    return {
+        'frame_count': count.value,
+        'oldest_ms': oldest.value,
+        'newest_ms': newest.value,
+        'memory_bytes': memory.value,
+    }
+
+def iter_frame_history(start_ms: int, end_ms: int, chunk_frames: int = 8) -> Iterator[Tuple[int, bytes, int, int]]:
+    """逐帧解码 [start_ms, end_ms] 内的历史帧, 依次产出 (时间戳, BGRA数据, 宽度, 高度)
+
+    每次从 DLL 取 chunk_frames 帧, 内存占用与区间长度无关
+    """
+    frames_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    times_ptr = ctypes.POINTER(ctypes.c_longlong)()
+    count = ctypes.c_int()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+
+    while start_ms <= end_ms:
+        if _dll._dll.ExtractFrameHistory(start_ms, end_ms, chunk_frames, ctypes.byref(frames_ptr),
+                                         ctypes.byref(times_ptr), ctypes.byref(count),
+                                         ctypes.byref(width), ctypes.byref(height)) == 0:
+            return
+
+        frame_size = width.value * height.value * 4
+        try:
+            chunk = [(times_ptr[i], ctypes.string_at(ctypes.addressof(frames_ptr.contents) + i * frame_size,
+                                                     frame_size))
+                     for i in range(count.value)]
+        finally:
+            _dll._dll.FreeImageData(frames_ptr)
+            _dll._dll.FreeImageData(ctypes.cast(times_ptr, ctypes.POINTER(ctypes.c_ubyte)))
+
+        for timestamp, data in chunk:
+            yield timestamp, data, width.value, height.value
+        if count.value < chunk_frames:
+            return
+        start_ms = chunk[-1][0] + 1
+
+def extract_frame_history(start_ms: int, end_ms: int,
+                          max_frames: int = 64) -> Optional[Tuple[List[Tuple[int, bytes]], int, int]]:
+    """解码 [start_ms, end_ms] 内最早的 max_frames 帧, 返回 ([(时间戳, BGRA数据)], 宽度, 高度) 或 None
+
+    区间较长时改用 iter_frame_history 逐帧处理
+    """
+    frames = []
+    size = None
+    for timestamp, data, width, height in iter_frame_history(start_ms, end_ms, max(1, min(max_frames, 8))):
+        # 区间内窗口尺寸变化时只返回变化前的帧
+        if size is not None and size != (width, height):
+            break
+        size = (width, height)
+        frames.append((timestamp, data))
+        if len(frames) >= max_frames:
+            break
+
+    if not frames:
+        return None
+    return frames, size[0], size[1]
+
+def extract_frames_around(timestamp_ms: int, before_ms: int = 5000, after_ms: int = 1000,
+                          max_frames: int = 64) -> Optional[Tuple[List[Tuple[int, bytes]], int, int]]:
+    """解码某一时刻前后的历史帧"""
+    return extract_frame_history(timestamp_ms - before_ms, timestamp_ms + after_ms, max_frames)
+
+
+TRIGGER_METRIC_MAE = 0
+TRIGGER_METRIC_SSIM = 1
+
+def add_match_trigger(roi: Tuple[int, int, int, int], reference: bytes, metric: int = TRIGGER_METRIC_MAE,
+                      threshold: float = 4.0, one_shot: bool = True) -> int:
+    """登记 "区域与参考图相符" 条件, reference 为 ROI 尺寸的 BGRA, 返回条件 ID (失败返回 0)
+
+    MAE 下 threshold 为允许的平均绝对误差 (0-255), SSIM 下为最低相似度 (如 0.95)
+    """
+    x, y, w, h = roi
+    if w <= 0 or h <= 0 or len(reference) < w * h * 4:
+        return 0
+    return _dll._dll.AddMatchTrigger(x, y, w, h, reference, w, h, metric, threshold, 1 if one_shot else 0)
+
+def add_change_trigger(roi: Optional[Tuple[int, int, int, int]] = None, threshold: float = 2.0,
+                       one_shot: bool = True) -> int:
+    """登记 "区域发生变化" 条件 (相对登记时/上次触发时的 MAE 超过 threshold)"""
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    return _dll._dll.AddChangeTrigger(x, y, w, h, threshold, 1 if one_shot else 0)
+
+def add_stable_trigger(duration_ms: int, roi: Optional[Tuple[int, int, int, int]] = None,
+                       threshold: float = 0.5, one_shot: bool = True) -> int:
+    """登记 "区域持续 duration_ms 未变化" 条件"""
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    return _dll._dll.AddStableTrigger(x, y, w, h, threshold, duration_ms, 1 if one_shot else 0)
+
+def remove_trigger(trigger_id: int) -> bool:
+    """移除条件"""
+    return _dll._dll.RemoveTrigger(trigger_id) != 0
+
+def clear_triggers():
+    """清空所有条件, 并唤醒正在等待的调用"""
+    _dll._dll.ClearTriggers()
+
+def _trigger_call(func, *args) -> Optional[Tuple[int, int, float]]:
+    fired_id = ctypes.c_int()
+    timestamp = ctypes.c_longlong()
+    score = ctypes.c_double()
+    if func(*args, ctypes.byref(fired_id), ctypes.byref(timestamp), ctypes.byref(score)) == 0:
+        return None
+    return fired_id.value, timestamp.value, score.value
+
+def wait_for_trigger(trigger_id: int = 0, timeout_ms: int = -1) -> Optional[Tuple[int, int, float]]:
+    """阻塞等待条件触发 (trigger_id 为 0 表示任意条件), 返回 (条件 ID, 时间戳毫秒, 度量值) 或 None
+
+    等待期间释放 GIL, 可在其他线程中调用
+    """
+    return _trigger_call(_dll._dll.WaitForTrigger, trigger_id, timeout_ms)
+
+async def wait_for_trigger_async(trigger_id: int = 0, timeout_ms: int = -1) -> Optional[Tuple[int, int, float]]:
+    """wait_for_trigger 的 asyncio 版本 (在线程池中等待)"""
+    import asyncio
+    loop = asyncio.get_running_loop()
+    return await loop.run_in_executor(None, wait_for_trigger, trigger_id, timeout_ms)
+
+def poll_trigger(trigger_id: int = 0) -> Optional[Tuple[int, int, float]]:
+    """非阻塞地取出一个已触发事件"""
+    return _trigger_call(_dll._dll.PollTrigger, trigger_id)
+
+
+def scheduler_add_target(title: str, class_name: str, interval_ms: int = 1000, priority: int = 0) -> int:
+    """添加分时调度目标窗口, 返回目标 ID (失败返回 0)"""
+    return _dll._dll.SchedulerAddTarget(title.encode('utf-8'), class_name.encode('utf-8'), interval_ms, priority)
+
+def scheduler_remove_target(target_id: int):
+    """移除调度目标并关闭其会话"""
+    _dll._dll.SchedulerRemoveTarget(target_id)
+
+def scheduler_set_budget(max_copies_per_sec: float = 0, max_bytes_per_sec: float = 0,
+                         max_concurrent: int = 4, grab_timeout_ms: int = 500):
+    """设置全局复制预算 (0 表示不限制)"""
+    _dll._dll.SchedulerSetBudget(max_copies_per_sec, max_bytes_per_sec, max_concurrent, grab_timeout_ms)
+
+def scheduler_start() -> bool:
+    """启动调度线程"""
+    return _dll._dll.SchedulerStart() != 0
+
+def scheduler_stop():
+    """停止调度线程, 保留目标与已取到的帧, 可再次 scheduler_start"""
+    _dll._dll.SchedulerStop()
+
+def scheduler_release():
+    """停止调度并关闭全部目标的会话"""
+    _dll._dll.SchedulerRelease()
+
+def scheduler_get_frame(target_id: int) -> Optional[Tuple[bytes, int, int, int, int]]:
+    """获取目标的最新帧, 返回 (数据, 宽度, 高度, 时间戳毫秒, 序号) 或 None"""
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+    timestamp = ctypes.c_longlong()
+    sequence = ctypes.c_ulonglong()
+
+    if _dll._dll.SchedulerGetFrame(target_id, ctypes.byref(image_data_ptr), ctypes.byref(width),
+                                   ctypes.byref(height), ctypes.byref(timestamp), ctypes.byref(sequence)) == 0:
+        return None
+
+    image_data = ctypes.string_at(image_data_ptr, width.value * height.value * 4)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    return image_data, width.value, height.value, timestamp.value, sequence.value
+
+def scheduler_get_stats() -> Optional[dict]:
+    """调度统计: 取帧次数、超时次数、复制字节数、因预算推迟次数"""
+    values = [ctypes.c_ulonglong() for _ in range(4)]
+    if _dll._dll.SchedulerGetStats(*[ctypes.byref(v) for v in values]) == 0:
+        return None
+    return dict(zip(('grabs', 'timeouts', 'bytes', 'throttled'), (v.value for v in values)))
+
+
+SAVE_QOI = 0
+SAVE_PNG = 1
+
+SAVE_STATUS_UNKNOWN = 0
+SAVE_STATUS_PENDING = 1
+SAVE_STATUS_DONE = 2
+SAVE_STATUS_FAILED = 3
+
+_save_callbacks = []
+
+def save_frame_async(path: str, format: int = SAVE_PNG) -> int:
+    """拷贝最新帧后立即返回任务 ID (失败返回 0), 编码与写盘在后台线程完成
+
+    format: SAVE_QOI (最快) 或 SAVE_PNG (按行条带并行压缩)
+    """
+    return _dll._dll.SaveFrameAsync(path.encode('utf-8'), format)
+
+def get_save_status(job_id: int) -> int:
+    """查询保存任务状态 (SAVE_STATUS_*)"""
+    return _dll._dll.GetSaveStatus(job_id)
+
+def wait_for_save(job_id: int, timeout_ms: int = -1) -> int:
+    """等待保存任务结束, 返回最终状态; 超时返回 SAVE_STATUS_PENDING"""
+    return _dll._dll.WaitForSave(job_id, timeout_ms)
+
+def set_save_callback(callback) -> None:
+    """设置保存完成回调 callback(job_id, success), 在后台线程上调用; 传 None 取消"""
+    if callback is None:
+        _dll._dll.SetSaveCallback(_SAVE_CALLBACK())
+        return
+    # 后台线程可能仍在调用旧回调, 所有回调对象都保持引用
+    wrapped = _SAVE_CALLBACK(lambda job_id, success: callback(job_id, bool(success)))
+    _save_callbacks.append(wrapped)
+    _dll._dll.SetSaveCallback(wrapped)
+
+
+SCROLL_VERTICAL = 1
+SCROLL_HORIZONTAL = 2
+SCROLL_BOTH = 3
+
+def enable_scroll_tracking(roi: Optional[Tuple[int, int, int, int]] = None, axes: int = SCROLL_VERTICAL,
+                           stitch: bool = False, max_stitch_mb: int = 0, max_lost_frames: int = 30) -> bool:
+    """逐帧检测滚动偏移 (行/列哈希匹配), 可选增量拼接长图
+
+    roi 应只覆盖滚动区域 (不含固定的标题栏/侧栏); 再次调用会重新开始
+    连续 max_lost_frames 帧无法对齐 (如页面跳转) 时以当前帧重新开始, 累计偏移与拼接画布随之重置
+    """
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    return _dll._dll.EnableScrollTracking(x, y, w, h, axes, 1 if stitch else 0, max_stitch_mb,
+                                          max_lost_frames) != 0
+
+def disable_scroll_tracking():
+    """停止滚动检测并释放拼接画布"""
+    _dll._dll.DisableScrollTracking()
+
+def get_scroll_state() -> Optional[dict]:
+    """获取最近一帧的滚动检测结果
+
+    当前帧 (x, y) 的内容对应上一帧 (x + dx, y + dy); dy > 0 表示向下滚动
+    返回 {'dx', 'dy', 'confidence', 'band': (x, y, w, h) 新露出区域, 'total_x', 'total_y',
+    'timestamp_ms', 'lost_frames', 'restarts' 重新开始次数, 'canvas_pending' 有保留的旧画布待取,
+    'canvas_truncated' 待取画布因内存上限缺失部分区域, 'canvas_resets' 未取走即被丢弃的画布数}; 未开启时返回 None
+    """
+    dx = ctypes.c_int()
+    dy = ctypes.c_int()
+    confidence = ctypes.c_float()
+    band = (ctypes.c_int * 4)()
+    total_x = ctypes.c_longlong()
+    total_y = ctypes.c_longlong()
+    timestamp = ctypes.c_longlong()
+    lost = ctypes.c_int()
+    restarts = ctypes.c_int()
+    pending = ctypes.c_int()
+    truncated = ctypes.c_int()
+    resets = ctypes.c_int()
+
+    if _dll._dll.GetScrollState(ctypes.byref(dx), ctypes.byref(dy), ctypes.byref(confidence), band,
+                                ctypes.byref(total_x), ctypes.byref(total_y),
+                                ctypes.byref(timestamp), ctypes.byref(lost), ctypes.byref(restarts),
+                                ctypes.byref(pending), ctypes.byref(truncated), ctypes.byref(resets)) == 0:
+        return None
+
+    return {
+        'dx': dx.value,
+        'dy': dy.value,
+        'confidence': confidence.value,
+        'band': tuple(band),
+        'total_x': total_x.value,
+        'total_y': total_y.value,
+        'timestamp_ms': timestamp.value,
+        'lost_frames': lost.value,
+        'restarts': restarts.value,
+        'canvas_pending': bool(pending.value),
+        'canvas_truncated': bool(truncated.value),
+        'canvas_resets': resets.value,
+    }
+
+def get_stitched_image() -> Optional[Tuple[bytes, int, int]]:
+    """获取拼接的长图 (BGRA), 返回 (数据, 宽度, 高度) 或 None
+
+    重新开始前保留的画布 (canvas_pending) 优先返回并释放, 之后再调用返回当前画布
+    """
+    image_data_ptr = ctypes.POINTER(ctypes.c_ubyte)()
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+
+    if _dll._dll.GetStitchedImage(ctypes.byref(image_data_ptr), ctypes.byref(width), ctypes.byref(height)) == 0:
+        return None
+
+    image_data = ctypes.string_at(image_data_ptr, width.value * height.value * 4)
+    _dll._dll.FreeImageData(image_data_ptr)
+
+    return image_data, width.value, height.value
+
+def detect_scroll_offset(previous: bytes, current: bytes, width: int, height: int,
+                         roi: Optional[Tuple[int, int, int, int]] = None,
+                         axes: int = SCROLL_BOTH) -> Optional[Tuple[int, int, float, Tuple[int, int, int, int]]]:
+    """检测两张同尺寸 BGRA 图之间的滚动偏移, 返回 (dx, dy, confidence, band); confidence 为 0 表示无法对齐"""
+    if len(previous) < width * height * 4 or len(current) < width * height * 4:
+        return None
+    x, y, w, h = roi if roi else (0, 0, 0, 0)
+    dx = ctypes.c_int()
+    dy = ctypes.c_int()
+    confidence = ctypes.c_float()
+    band = (ctypes.c_int * 4)()
+    if _dll._dll.DetectScrollOffset(previous, current, width, height, x, y, w, h, axes,
+                                    ctypes.byref(dx), ctypes.byref(dy), ctypes.byref(confidence), band) == 0:
+        return None
+    return dx.value, dy.value, confidence.value, tuple(band)
+
+
+def enable_integral_image() -> bool:
+    """开启积分图: 随帧增量维护亮度的和与平方和, 之后可用 query_region_stats 以 O(1) 查询区域均值/方差"""
+    return _dll._dll.EnableIntegralImage() != 0
+
+def disable_integral_image():
+    """关闭积分图"""
+    _dll._dll.DisableIntegralImage()
+
+def query_region_stats(rects: List[Tuple[int, int, int, int]]) -> Optional[Tuple[List[Tuple[float, float]], int]]:
+    """批量查询矩形区域的亮度均值与方差
+
+    rects: [(x, y, w, h), ...], 宽高 <= 0 表示整帧
+    返回 ([(均值, 方差), ...], 积分图对应帧的时间戳 ms); 未开启或尚无帧时返回 None
+    """
+    count = len(rects)
+    flat = (ctypes.c_int * (count * 4))(*[v for rect in rects for v in rect])
+    means = (ctypes.c_float * count)()
+    variances = (ctypes.c_float * count)()
+    timestamp = ctypes.c_longlong()
+
+    if _dll._dll.QueryRegionStats(flat, count, means, variances, ctypes.byref(timestamp)) == 0:
+        return None
+
+    return list(zip(means, variances)), timestamp.value
+
+def get_integral_image_info() -> Optional[dict]:
+    """获取积分图状态: {'width', 'height', 'updated_bands' (上一帧重算的 16 行条带数), 'timestamp_ms'}"""
+    width = ctypes.c_int()
+    height = ctypes.c_int()
+    bands = ctypes.c_int()
+    timestamp = ctypes.c_longlong()
+
+    if _dll._dll.GetIntegralImageInfo(ctypes.byref(width), ctypes.byref(height),
+                                      ctypes.byref(bands), ctypes.byref(timestamp)) == 0:
+        return None
+
+    return {
+        'width': width.value,
+        'height': height.value,
+        'updated_bands': bands.value,
+        'timestamp_ms': timestamp.value,
+    }
+
+
+def enable_tracing(enable: bool = True):
+    """开启/关闭捕获管线时间线追踪"""
+    _dll._dll.EnableTracing(1 if enable else 0)
+
+def is_tracing() -> bool:
+    """是否正在追踪"""
+    return _dll._dll.IsTracing() != 0
+
+def reset_trace():
+    """丢弃已记录的追踪事件"""
+    _dll._dll.ResetTrace()
+
+def dump_trace(path: str) -> bool:
+    """导出 Chrome/Perfetto trace JSON (chrome://tracing 或 ui.perfetto.dev 打开)"""
+    return _dll._dll.DumpTrace(path.encode('utf-8')) != 0
+
 
 __all__ = [
     'enumerate_windows',
@@ -150,5 +1096,87 @@ __all__ = [
     'get_last_error',
     'pause_capture',
     'resume_capture',
-    'is_paused'
+    'is_paused',
+    'prewarm_window',
+    'switch_to_window',
+    'set_session_pool_budget',
+    'release_session_pool',
+    'get_session_pool_info',
+    'TONEMAP_CLAMP',
+    'TONEMAP_REINHARD',
+    'TONEMAP_ACES',
+    'set_hdr_capture',
+    'is_hdr_capture',
+    'set_tone_mapping',
+    'get_frame_bgr',
+    'get_frame_pyramid',
+    'get_frame_stats',
+    'get_frame_with_stats',
+    'PIPELINE_BGRA',
+    'PIPELINE_BGR',
+    'PIPELINE_GRAY',
+    'get_frame_processed',
+    'COLOR_BGR',
+    'COLOR_HSV',
+    'find_color_blobs',
+    'get_color_mask',
+    'compute_frame_hash',
+    'compute_image_hash',
+    'add_reference_hash',
+    'add_reference_image',
+    'remove_reference_hash',
+    'clear_reference_hashes',
+    'get_reference_hash_count',
+    'classify_frame',
+    'get_capture_clock_ms',
+    'enable_frame_history',
+    'disable_frame_history',
+    'get_frame_history_info',
+    'iter_frame_history',
+    'extract_frame_history',
+    'extract_frames_around',
+    'TRIGGER_METRIC_MAE',
+    'TRIGGER_METRIC_SSIM',
+    'add_match_trigger',
+    'add_change_trigger',
+    'add_stable_trigger',
+    'remove_trigger',
+    'clear_triggers',
+    'wait_for_trigger',
+    'wait_for_trigger_async',
+    'poll_trigger',
+    'scheduler_add_target',
+    'scheduler_remove_target',
+    'scheduler_set_budget',
+    'scheduler_start',
+    'scheduler_stop',
+    'scheduler_release',
+    'scheduler_get_frame',
+    'scheduler_get_stats',
+    'SAVE_QOI',
+    'SAVE_PNG',
+    'SAVE_STATUS_UNKNOWN',
+    'SAVE_STATUS_PENDING',
+    'SAVE_STATUS_DONE',
+    'SAVE_STATUS_FAILED',
+    'save_frame_async',
+    'get_save_status',
+    'wait_for_save',
+    'set_save_callback',
+    'SCROLL_VERTICAL',
+    'SCROLL_HORIZONTAL',
+    'SCROLL_BOTH',
+    'enable_scroll_tracking',
+    'disable_scroll_tracking',
+    'get_scroll_state',
+    'get_stitched_image',
+    'detect_scroll_offset',
+    'enable_integral_image',
+    'disable_integral_image',
+    'query_region_stats',
+    'get_integral_image_info',
+    'enable_tracing',
+    'is_tracing',
+    'reset_trace',
+    'dump_trace'
 ]
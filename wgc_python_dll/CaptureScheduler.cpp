@@ -0,0 +1,166 @@
+#include "CaptureScheduler.h"
+#include <algorithm>
+
+CaptureScheduler::CaptureScheduler(ICaptureBackend& backend) : m_backend(backend)
+{
+}
+
+void CaptureScheduler::AddTarget(int targetId, int intervalMs, int priority, int64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Target& target = m_targets[targetId];
+    target.intervalMs = std::max(intervalMs, 1);
+    target.priority = priority;
+    target.nextDueMs = nowMs;
+}
+
+void CaptureScheduler::RemoveTarget(int targetId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_targets.find(targetId);
+    if (it == m_targets.end()) return;
+    if (it->second.active) m_backend.Pause(targetId);
+    m_targets.erase(it);
+}
+
+bool CaptureScheduler::HasTarget(int targetId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_targets.count(targetId) != 0;
+}
+
+void CaptureScheduler::SetBudget(const SchedulerBudget& budget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    if (m_budget.maxConcurrent < 1) m_budget.maxConcurrent = 1;
+    m_refillStarted = false;
+}
+
+void CaptureScheduler::Tick(int64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Refill(nowMs);
+    CollectActive(nowMs);
+    DispatchDue(nowMs);
+}
+
+void CaptureScheduler::Refill(int64_t nowMs)
+{
+    // 令牌桶容量为 1 秒的配额, 允许短时突发; 余额可以为负 (单帧超过 1 秒配额时先透支, 之后按速率偿还)
+    if (!m_refillStarted) {
+        m_copyTokens = m_budget.maxCopiesPerSec;
+        m_byteTokens = m_budget.maxBytesPerSec;
+        m_lastRefillMs = nowMs;
+        m_refillStarted = true;
+        return;
+    }
+
+    double seconds = (nowMs - m_lastRefillMs) / 1000.0;
+    m_lastRefillMs = nowMs;
+    if (seconds <= 0) return;
+
+    if (m_budget.maxCopiesPerSec > 0) {
+        m_copyTokens = std::min(m_copyTokens + seconds * m_budget.maxCopiesPerSec, m_budget.maxCopiesPerSec);
+    }
+    if (m_budget.maxBytesPerSec > 0) {
+        m_byteTokens = std::min(m_byteTokens + seconds * m_budget.maxBytesPerSec, m_budget.maxBytesPerSec);
+    }
+}
+
+int64_t CaptureScheduler::NextDeadline(const Target& target, int64_t nowMs)
+{
+    // 按固定节拍推进, 落后太多时从当前时间重新计时, 避免补发积压
+    int64_t next = target.nextDueMs + target.intervalMs;
+    return next < nowMs ? nowMs + target.intervalMs : next;
+}
+
+void CaptureScheduler::CollectActive(int64_t nowMs)
+{
+    for (auto& [id, target] : m_targets) {
+        if (!target.active) continue;
+
+        if (m_backend.TryGrab(id, target.slot)) {
+            m_backend.Pause(id);
+            target.active = false;
+            target.slot.timestampMs = nowMs;
+            target.slot.sequence = ++m_sequence;
+            target.lastFrameBytes = static_cast<uint64_t>(target.slot.width) * target.slot.height * 4;
+            target.nextDueMs = NextDeadline(target, nowMs);
+
+            m_stats.grabs++;
+            m_stats.bytes += target.lastFrameBytes;
+            if (m_budget.maxBytesPerSec > 0) m_byteTokens -= static_cast<double>(target.lastFrameBytes);
+        } else if (nowMs - target.resumedAtMs >= m_budget.grabTimeoutMs) {
+            // 窗口内容静止时 WGC 不会送来新帧, 超时后放弃本轮
+            m_backend.Pause(id);
+            target.active = false;
+            target.nextDueMs = NextDeadline(target, nowMs);
+            m_stats.timeouts++;
+        }
+    }
+}
+
+void CaptureScheduler::DispatchDue(int64_t nowMs)
+{
+    int activeCount = 0;
+    std::vector<std::pair<int, Target*>> due;
+    for (auto& [id, target] : m_targets) {
+        if (target.active) {
+            activeCount++;
+        } else if (target.nextDueMs <= nowMs) {
+            due.emplace_back(id, &target);
+        }
+    }
+
+    std::sort(due.begin(), due.end(), [](const auto& a, const auto& b) {
+        if (a.second->priority != b.second->priority) return a.second->priority > b.second->priority;
+        if (a.second->nextDueMs != b.second->nextDueMs) return a.second->nextDueMs < b.second->nextDueMs;
+        return a.first < b.first;
+    });
+
+    for (auto& [id, target] : due) {
+        if (activeCount >= m_budget.maxConcurrent) break;
+
+        // 余额为正即可调度, 再扣除本次开销: 若要求余额足够一整帧, 大于桶容量的帧将永远无法调度
+        bool copyBudget = m_budget.maxCopiesPerSec <= 0 || m_copyTokens > 0;
+        bool byteBudget = m_budget.maxBytesPerSec <= 0 || m_byteTokens > 0;
+        if (!copyBudget || !byteBudget) {
+            // 预算不足时不再调度优先级更低的目标, 保证高优先级先得到配额
+            m_stats.throttled++;
+            break;
+        }
+
+        if (!m_backend.Resume(id)) {
+            target->nextDueMs = NextDeadline(*target, nowMs);
+            continue;
+        }
+
+        if (m_budget.maxCopiesPerSec > 0) m_copyTokens -= 1.0;
+        target->active = true;
+        target->resumedAtMs = nowMs;
+        activeCount++;
+    }
+}
+
+bool CaptureScheduler::CopyFrame(int targetId, FrameSlot& out) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_targets.find(targetId);
+    if (it == m_targets.end() || it->second.slot.sequence == 0) return false;
+    out = it->second.slot;
+    return true;
+}
+
+bool CaptureScheduler::IsActive(int targetId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_targets.find(targetId);
+    return it != m_targets.end() && it->second.active;
+}
+
+SchedulerStats CaptureScheduler::Stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "FrameView.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+// 每个目标最新一帧的存放位置
+struct FrameSlot
+{
+    std::vector<uint8_t> data; // BGRA, 无行填充
+    int width = 0;
+    int height = 0;
+    int64_t timestampMs = 0;
+    uint64_t sequence = 0;     // 0 表示尚未取到帧
+};
+
+// 调度器操作的捕获后端, 真实实现基于 WGCWindowCapture, 测试时可替换为模拟源
+class ICaptureBackend
+{
+public:
+    virtual ~ICaptureBackend() = default;
+    virtual bool Resume(int targetId) = 0;
+    virtual void Pause(int targetId) = 0;
+    // 恢复后有新帧时写入 slot 的 data/width/height 并返回 true
+    virtual bool TryGrab(int targetId, FrameSlot& slot) = 0;
+};
+
+struct SchedulerBudget
+{
+    double maxCopiesPerSec = 0; // <= 0 表示不限制
+    double maxBytesPerSec = 0;  // <= 0 表示不限制
+    int maxConcurrent = 4;      // 同时处于恢复状态的目标数
+    int grabTimeoutMs = 500;    // 恢复后等待新帧的最长时间
+};
+
+struct SchedulerStats
+{
+    uint64_t grabs = 0;
+    uint64_t timeouts = 0;
+    uint64_t bytes = 0;
+    uint64_t throttled = 0;     // 因预算不足推迟的调度次数
+};
+
+// 分时调度多个捕获目标: 到期的目标按优先级高、截止时间早的顺序恢复,
+// 取到一帧后立即暂停; 全局以令牌桶限制每秒复制次数与字节数
+// 时间由调用方通过 Tick(nowMs) 驱动, 便于用模拟时钟测试
+class CaptureScheduler
+{
+public:
+    explicit CaptureScheduler(ICaptureBackend& backend);
+
+    void AddTarget(int targetId, int intervalMs, int priority, int64_t nowMs);
+    void RemoveTarget(int targetId);
+    bool HasTarget(int targetId) const;
+    void SetBudget(const SchedulerBudget& budget);
+
+    void Tick(int64_t nowMs);
+
+    // 复制目标的最新帧, 尚无帧时返回 false
+    bool CopyFrame(int targetId, FrameSlot& out) const;
+    bool IsActive(int targetId) const;
+    SchedulerStats Stats() const;
+
+private:
+    struct Target
+    {
+        int intervalMs = 1000;
+        int priority = 0;
+        int64_t nextDueMs = 0;
+        int64_t resumedAtMs = 0;
+        bool active = false;
+        uint64_t lastFrameBytes = 0;
+        FrameSlot slot;
+    };
+
+    ICaptureBackend& m_backend;
+    mutable std::mutex m_mutex;
+    std::map<int, Target> m_targets;
+    SchedulerBudget m_budget;
+    SchedulerStats m_stats;
+
+    double m_copyTokens = 0;
+    double m_byteTokens = 0;
+    int64_t m_lastRefillMs = 0;
+    bool m_refillStarted = false;
+    uint64_t m_sequence = 0;
+
+    void Refill(int64_t nowMs);
+    void CollectActive(int64_t nowMs);
+    void DispatchDue(int64_t nowMs);
+    static int64_t NextDeadline(const Target& target, int64_t nowMs);
+};
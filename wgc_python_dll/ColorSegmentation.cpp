@@ -0,0 +1,237 @@
+#include "ColorSegmentation.h"
+#include <algorithm>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    struct Run
+    {
+        int x0;
+        int x1; // 不含
+        int label;
+    };
+
+    struct Component
+    {
+        int parent;
+        int minX, minY, maxX, maxY;
+        int64_t area;
+        int64_t sumX;
+        int64_t sumY;
+    };
+
+    int FindRoot(std::vector<Component>& comps, int label)
+    {
+        int root = label;
+        while (comps[root].parent != root) root = comps[root].parent;
+        while (comps[label].parent != root) {
+            int next = comps[label].parent;
+            comps[label].parent = root;
+            label = next;
+        }
+        return root;
+    }
+
+    int Union(std::vector<Component>& comps, int a, int b)
+    {
+        a = FindRoot(comps, a);
+        b = FindRoot(comps, b);
+        if (a == b) return a;
+        if (b < a) std::swap(a, b);
+
+        Component& ca = comps[a];
+        const Component& cb = comps[b];
+        ca.minX = std::min(ca.minX, cb.minX);
+        ca.minY = std::min(ca.minY, cb.minY);
+        ca.maxX = std::max(ca.maxX, cb.maxX);
+        ca.maxY = std::max(ca.maxY, cb.maxY);
+        ca.area += cb.area;
+        ca.sumX += cb.sumX;
+        ca.sumY += cb.sumY;
+        comps[b].parent = a;
+        return a;
+    }
+
+    inline bool InHsvRange(const uint8_t* hsv, const ColorRange& r)
+    {
+        bool hue = r.lower[0] <= r.upper[0]
+            ? hsv[0] >= r.lower[0] && hsv[0] <= r.upper[0]
+            : hsv[0] >= r.lower[0] || hsv[0] <= r.upper[0];
+        return hue && hsv[1] >= r.lower[1] && hsv[1] <= r.upper[1] &&
+            hsv[2] >= r.lower[2] && hsv[2] <= r.upper[2];
+    }
+
+    inline bool InBgrRange(const uint8_t* p, const ColorRange& r)
+    {
+        return p[0] >= r.lower[0] && p[0] <= r.upper[0] &&
+            p[1] >= r.lower[1] && p[1] <= r.upper[1] &&
+            p[2] >= r.lower[2] && p[2] <= r.upper[2];
+    }
+
+    void ThresholdRowBgr(const uint8_t* bgra, uint8_t* mask, int width, const ColorRange& r)
+    {
+        int x = 0;
+#ifdef WGC_HAS_SSE2
+        // alpha 通道的区间取 [0, 255], 比较后 4 字节全为 0xFF 即像素命中
+        const __m128i lo = _mm_setr_epi8(
+            r.lower[0], r.lower[1], r.lower[2], 0, r.lower[0], r.lower[1], r.lower[2], 0,
+            r.lower[0], r.lower[1], r.lower[2], 0, r.lower[0], r.lower[1], r.lower[2], 0);
+        const __m128i hi = _mm_setr_epi8(
+            r.upper[0], r.upper[1], r.upper[2], -1, r.upper[0], r.upper[1], r.upper[2], -1,
+            r.upper[0], r.upper[1], r.upper[2], -1, r.upper[0], r.upper[1], r.upper[2], -1);
+        const __m128i ones = _mm_set1_epi32(-1);
+
+        for (; x + 4 <= width; x += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + x * 4));
+            __m128i geLo = _mm_cmpeq_epi8(_mm_max_epu8(px, lo), px);
+            __m128i leHi = _mm_cmpeq_epi8(_mm_min_epu8(px, hi), px);
+            __m128i hit = _mm_cmpeq_epi32(_mm_and_si128(geLo, leHi), ones);
+            __m128i packed = _mm_packs_epi16(_mm_packs_epi32(hit, hit), hit);
+            int bits = _mm_cvtsi128_si32(packed);
+            uint8_t* m = mask + x;
+            m[0] |= static_cast<uint8_t>(bits);
+            m[1] |= static_cast<uint8_t>(bits >> 8);
+            m[2] |= static_cast<uint8_t>(bits >> 16);
+            m[3] |= static_cast<uint8_t>(bits >> 24);
+        }
+#endif
+        for (; x < width; x++) {
+            if (InBgrRange(bgra + x * 4, r)) mask[x] = 255;
+        }
+    }
+}
+
+void BgraToHsv(const uint8_t* bgra, uint8_t* hsv)
+{
+    int b = bgra[0], g = bgra[1], r = bgra[2];
+    int v = std::max({ b, g, r });
+    int mn = std::min({ b, g, r });
+    int diff = v - mn;
+
+    hsv[2] = static_cast<uint8_t>(v);
+    hsv[1] = v ? static_cast<uint8_t>((diff * 255 + v / 2) / v) : 0;
+
+    if (diff == 0) {
+        hsv[0] = 0;
+        return;
+    }
+
+    // 色相按 0-360 计算后折半, 与 OpenCV 的 8 位 HSV 一致
+    int h;
+    if (v == r) {
+        h = (60 * (g - b)) * 2 / diff;
+    } else if (v == g) {
+        h = 240 + (60 * (b - r)) * 2 / diff;
+    } else {
+        h = 480 + (60 * (r - g)) * 2 / diff;
+    }
+    if (h < 0) h += 720;
+    hsv[0] = static_cast<uint8_t>(((h + 2) / 4) % 180);
+}
+
+void ThresholdRow(const uint8_t* bgra, uint8_t* mask, int width, int colorSpace,
+    const ColorRange* ranges, int rangeCount)
+{
+    std::fill(mask, mask + width, static_cast<uint8_t>(0));
+
+    if (colorSpace == ColorSpaceBGR) {
+        for (int i = 0; i < rangeCount; i++) ThresholdRowBgr(bgra, mask, width, ranges[i]);
+        return;
+    }
+
+    uint8_t hsv[3];
+    for (int x = 0; x < width; x++) {
+        BgraToHsv(bgra + x * 4, hsv);
+        for (int i = 0; i < rangeCount; i++) {
+            if (InHsvRange(hsv, ranges[i])) {
+                mask[x] = 255;
+                break;
+            }
+        }
+    }
+}
+
+void FindColorBlobs(const FrameView& frame, const FrameRect& roi, int colorSpace,
+    const ColorRange* ranges, int rangeCount, int minArea, int connectivity,
+    std::vector<ColorBlob>& blobs, std::vector<uint8_t>* mask)
+{
+    blobs.clear();
+    FrameRect r = roi.ClampTo(frame.width, frame.height);
+    if (r.IsEmpty() || rangeCount <= 0) return;
+
+    // 8 连通时上一行的行程向两侧各扩展一个像素判断相交
+    int reach = connectivity == 4 ? 0 : 1;
+
+    std::vector<uint8_t> rowMask(r.width);
+    if (mask) mask->assign(static_cast<size_t>(r.width) * r.height, 0);
+
+    std::vector<Component> comps;
+    std::vector<Run> previous, current;
+
+    for (int row = 0; row < r.height; row++) {
+        int y = r.y + row;
+        uint8_t* m = mask ? mask->data() + static_cast<size_t>(row) * r.width : rowMask.data();
+        ThresholdRow(frame.Row(y) + static_cast<size_t>(r.x) * 4, m, r.width, colorSpace, ranges, rangeCount);
+
+        current.clear();
+        size_t p = 0;
+        for (int x = 0; x < r.width;) {
+            if (!m[x]) {
+                x++;
+                continue;
+            }
+            int x0 = x;
+            while (x < r.width && m[x]) x++;
+            int x1 = x;
+
+            int label = -1;
+            // previous 按 x 有序, 跳过已完全位于左侧的行程
+            while (p < previous.size() && previous[p].x1 + reach <= x0) p++;
+            for (size_t q = p; q < previous.size() && previous[q].x0 < x1 + reach; q++) {
+                label = label < 0 ? FindRoot(comps, previous[q].label) : Union(comps, label, previous[q].label);
+            }
+
+            int len = x1 - x0;
+            int ax0 = r.x + x0;
+            if (label < 0) {
+                label = static_cast<int>(comps.size());
+                comps.push_back({ label, ax0, y, ax0 + len - 1, y, 0, 0, 0 });
+            }
+
+            Component& c = comps[FindRoot(comps, label)];
+            c.minX = std::min(c.minX, ax0);
+            c.maxX = std::max(c.maxX, ax0 + len - 1);
+            c.minY = std::min(c.minY, y);
+            c.maxY = std::max(c.maxY, y);
+            c.area += len;
+            c.sumX += static_cast<int64_t>(2 * ax0 + len - 1) * len / 2;
+            c.sumY += static_cast<int64_t>(y) * len;
+
+            current.push_back({ x0, x1, label });
+        }
+        previous.swap(current);
+    }
+
+    for (size_t i = 0; i < comps.size(); i++) {
+        const Component& c = comps[i];
+        if (c.parent != static_cast<int>(i) || c.area < minArea || c.area == 0) continue;
+        ColorBlob blob;
+        blob.x = c.minX;
+        blob.y = c.minY;
+        blob.width = c.maxX - c.minX + 1;
+        blob.height = c.maxY - c.minY + 1;
+        blob.area = static_cast<int>(c.area);
+        blob.centroidX = static_cast<float>(static_cast<double>(c.sumX) / c.area);
+        blob.centroidY = static_cast<float>(static_cast<double>(c.sumY) / c.area);
+        blobs.push_back(blob);
+    }
+
+    std::sort(blobs.begin(), blobs.end(), [](const ColorBlob& a, const ColorBlob& b) {
+        if (a.area != b.area) return a.area > b.area;
+        if (a.y != b.y) return a.y < b.y;
+        return a.x < b.x;
+    });
+}
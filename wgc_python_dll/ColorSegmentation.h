@@ -0,0 +1,40 @@
+#pragma once
+#include "FrameView.h"
+#include <vector>
+
+enum ColorSpace
+{
+    ColorSpaceBGR = 0,
+    ColorSpaceHSV = 1, // 与 OpenCV 一致: H 0-179, S/V 0-255
+};
+
+// 闭区间 [lower, upper]; HSV 下 lower[0] > upper[0] 表示色相跨越 0 (如红色)
+struct ColorRange
+{
+    uint8_t lower[3];
+    uint8_t upper[3];
+};
+
+struct ColorBlob
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int area;
+    float centroidX;
+    float centroidY;
+};
+
+void BgraToHsv(const uint8_t* bgra, uint8_t* hsv);
+
+// 任一区间命中即为 255, 否则为 0; BGR 区间使用 SSE2 比较
+void ThresholdRow(const uint8_t* bgra, uint8_t* mask, int width, int colorSpace,
+    const ColorRange* ranges, int rangeCount);
+
+// 在 roi 内阈值化并做单遍连通域标记 (按行程合并, 像素只访问一次),
+// 返回面积 >= minArea 的连通域, 按面积从大到小排序; 坐标为整帧坐标
+// mask 非空时同时输出 roi 大小的掩码
+void FindColorBlobs(const FrameView& frame, const FrameRect& roi, int colorSpace,
+    const ColorRange* ranges, int rangeCount, int minArea, int connectivity,
+    std::vector<ColorBlob>& blobs, std::vector<uint8_t>* mask = nullptr);
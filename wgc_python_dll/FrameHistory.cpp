@@ -0,0 +1,323 @@
+#include "FrameHistory.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+    inline void WriteVarint(std::vector<uint8_t>& out, size_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline bool ReadVarint(const uint8_t*& p, const uint8_t* end, size_t& value)
+    {
+        value = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t b = *p++;
+            value |= static_cast<size_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline uint32_t LoadPixel(const uint8_t* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+}
+
+void EncodeFrame(const uint8_t* pixels, const uint8_t* reference, size_t pixelCount, std::vector<uint8_t>& out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < pixelCount) {
+        // 与预测相同的游程; 关键帧的第一个像素没有预测
+        size_t same = i;
+        if (reference) {
+            while (same < pixelCount && LoadPixel(pixels + same * 4) == LoadPixel(reference + same * 4)) same++;
+        } else if (i > 0) {
+            while (same < pixelCount && LoadPixel(pixels + same * 4) == LoadPixel(pixels + (same - 1) * 4)) same++;
+        }
+
+        // 字面像素持续到下一段至少 2 个像素可预测为止
+        size_t lit = same;
+        while (lit < pixelCount) {
+            size_t next = lit + 1;
+            bool predicted = reference
+                ? LoadPixel(pixels + lit * 4) == LoadPixel(reference + lit * 4)
+                : lit > 0 && LoadPixel(pixels + lit * 4) == LoadPixel(pixels + (lit - 1) * 4);
+            if (predicted && next < pixelCount) {
+                bool nextPredicted = reference
+                    ? LoadPixel(pixels + next * 4) == LoadPixel(reference + next * 4)
+                    : LoadPixel(pixels + next * 4) == LoadPixel(pixels + lit * 4);
+                if (nextPredicted) break;
+            }
+            lit++;
+        }
+
+        WriteVarint(out, same - i);
+        WriteVarint(out, lit - same);
+        out.insert(out.end(), pixels + same * 4, pixels + lit * 4);
+        i = lit;
+    }
+}
+
+bool DecodeFrame(const uint8_t* data, size_t length, const uint8_t* reference, uint8_t* outPixels, size_t pixelCount)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + length;
+    size_t i = 0;
+    while (i < pixelCount) {
+        size_t same = 0, lit = 0;
+        if (!ReadVarint(p, end, same) || !ReadVarint(p, end, lit)) return false;
+        if (same + lit > pixelCount - i || static_cast<size_t>(end - p) < lit * 4) return false;
+
+        if (reference) {
+            if (reference != outPixels) memcpy(outPixels + i * 4, reference + i * 4, same * 4);
+        } else {
+            if (same && i == 0) return false;
+            for (size_t k = 0; k < same; k++) memcpy(outPixels + (i + k) * 4, outPixels + (i + k - 1) * 4, 4);
+        }
+        i += same;
+
+        memcpy(outPixels + i * 4, p, lit * 4);
+        p += lit * 4;
+        i += lit;
+    }
+    return p == end;
+}
+
+FrameHistory::FrameHistory(const FrameHistoryOptions& options) : m_options(options)
+{
+    if (m_options.keyframeInterval < 1) m_options.keyframeInterval = 1;
+    m_worker = std::thread(&FrameHistory::WorkerLoop, this);
+}
+
+FrameHistory::~FrameHistory()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_stop = true;
+    }
+    m_pendingCv.notify_all();
+    if (m_worker.joinable()) m_worker.join();
+}
+
+void FrameHistory::Submit(const FrameView& frame, int64_t timestampMs)
+{
+    if (!frame.IsValid()) return;
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    if (m_options.maxFps > 0 && m_lastSubmitMs != INT64_MIN &&
+        timestampMs - m_lastSubmitMs < 1000 / m_options.maxFps) {
+        return;
+    }
+    m_lastSubmitMs = timestampMs;
+
+    size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+    m_pending.resize(rowBytes * frame.height);
+    for (int y = 0; y < frame.height; y++) {
+        memcpy(m_pending.data() + y * rowBytes, frame.Row(y), rowBytes);
+    }
+    m_pendingWidth = frame.width;
+    m_pendingHeight = frame.height;
+    m_pendingTimestamp = timestampMs;
+    m_hasPending = true;
+    m_pendingCv.notify_one();
+}
+
+void FrameHistory::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    m_idleCv.wait(lock, [this] { return (!m_hasPending && !m_busy) || m_stop; });
+}
+
+void FrameHistory::Clear()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_pendingMutex);
+        m_hasPending = false;
+        m_idleCv.wait(lock, [this] { return !m_busy || m_stop; });
+        m_lastSubmitMs = INT64_MIN;
+    }
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    m_ring.clear();
+    m_memoryUsage = 0;
+    m_keyframeCount = 0;
+    m_width = 0;
+    m_height = 0;
+    m_forceKeyframe = true;
+}
+
+void FrameHistory::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_pendingMutex);
+    while (true) {
+        m_pendingCv.wait(lock, [this] { return m_hasPending || m_stop; });
+        if (m_stop) break;
+
+        m_work.swap(m_pending);
+        int width = m_pendingWidth;
+        int height = m_pendingHeight;
+        int64_t timestampMs = m_pendingTimestamp;
+        m_hasPending = false;
+        m_busy = true;
+
+        lock.unlock();
+        Compress(width, height, timestampMs);
+        lock.lock();
+
+        m_busy = false;
+        m_idleCv.notify_all();
+    }
+    m_idleCv.notify_all();
+}
+
+void FrameHistory::Compress(int width, int height, int64_t timestampMs)
+{
+    size_t pixelCount = static_cast<size_t>(width) * height;
+    bool forceKeyframe;
+
+    {
+        // 尺寸变化时旧帧无法作为参考, 直接清空
+        std::lock_guard<std::mutex> lock(m_ringMutex);
+        if (width != m_width || height != m_height) {
+            m_ring.clear();
+            m_memoryUsage = 0;
+            m_keyframeCount = 0;
+            m_width = width;
+            m_height = height;
+            m_forceKeyframe = true;
+        }
+        forceKeyframe = m_forceKeyframe;
+    }
+
+    Entry entry;
+    entry.timestampMs = timestampMs;
+    entry.keyframe = forceKeyframe || m_framesSinceKey + 1 >= m_options.keyframeInterval;
+
+    std::vector<uint8_t> encoded;
+    if (!entry.keyframe) {
+        EncodeFrame(m_work.data(), m_reference.data(), pixelCount, encoded);
+        // 差分效果太差 (画面大幅变化) 时改为关键帧, 缩短解码链
+        if (encoded.size() > pixelCount * 2) entry.keyframe = true;
+    }
+    if (entry.keyframe) {
+        EncodeFrame(m_work.data(), nullptr, pixelCount, encoded);
+        m_framesSinceKey = 0;
+    } else {
+        m_framesSinceKey++;
+    }
+    encoded.shrink_to_fit();
+    entry.data = std::make_shared<const std::vector<uint8_t>>(std::move(encoded));
+    m_reference.swap(m_work);
+
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    m_memoryUsage += entry.data->size();
+    if (entry.keyframe) {
+        m_keyframeCount++;
+        m_forceKeyframe = false;
+    }
+    m_ring.push_back(std::move(entry));
+    EvictLocked(timestampMs);
+}
+
+void FrameHistory::EvictLocked(int64_t newestMs)
+{
+    int64_t cutoff = newestMs - m_options.windowMs;
+
+    // 差分帧离开关键帧就无法解码, 因此以 "关键帧 + 后续差分帧" 为单位淘汰
+    // 按时间淘汰时要等下一组的关键帧也超出窗口, 否则窗口开头的帧会随整组一起丢失
+    while (!m_ring.empty()) {
+        if (m_memoryUsage <= m_options.memoryBudget) {
+            if (m_ring.front().timestampMs >= cutoff) break;
+            auto next = std::find_if(m_ring.begin() + 1, m_ring.end(), [](const Entry& e) { return e.keyframe; });
+            if (next == m_ring.end()) {
+                // 只剩一组时提前插入关键帧, 之后才能淘汰这一组
+                m_forceKeyframe = true;
+                break;
+            }
+            if (next->timestampMs >= cutoff) break;
+        } else if (m_keyframeCount < 2) {
+            m_forceKeyframe = true;
+            break;
+        }
+        do {
+            m_memoryUsage -= m_ring.front().data->size();
+            if (m_ring.front().keyframe) m_keyframeCount--;
+            m_ring.pop_front();
+        } while (!m_ring.empty() && !m_ring.front().keyframe);
+    }
+}
+
+size_t FrameHistory::FrameCount() const
+{
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    return m_ring.size();
+}
+
+size_t FrameHistory::MemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    return m_memoryUsage;
+}
+
+bool FrameHistory::GetTimeRange(int64_t* oldestMs, int64_t* newestMs) const
+{
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    if (m_ring.empty()) return false;
+    if (oldestMs) *oldestMs = m_ring.front().timestampMs;
+    if (newestMs) *newestMs = m_ring.back().timestampMs;
+    return true;
+}
+
+bool FrameHistory::Snapshot(int64_t startMs, int64_t endMs, size_t maxFrames, Range& range) const
+{
+    range = Range{};
+
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    if (m_ring.empty()) return false;
+
+    // 从区间起点之前最近的关键帧开始解码
+    size_t first = 0;
+    while (first < m_ring.size() && m_ring[first].timestampMs < startMs) first++;
+    if (first == m_ring.size() || m_ring[first].timestampMs > endMs) return false;
+    size_t begin = first;
+    while (begin > 0 && !m_ring[begin].keyframe) begin--;
+
+    size_t end = first;
+    while (end < m_ring.size() && m_ring[end].timestampMs <= endMs && (maxFrames == 0 || end - first < maxFrames)) end++;
+
+    range.width = m_width;
+    range.height = m_height;
+    range.first = first - begin;
+    range.entries.assign(m_ring.begin() + begin, m_ring.begin() + end);
+    return true;
+}
+
+bool FrameHistory::Decode(const Range& range, const FrameVisitor& visit)
+{
+    size_t pixelCount = static_cast<size_t>(range.width) * range.height;
+    std::vector<uint8_t> current(pixelCount * 4);
+
+    FrameView frame;
+    frame.data = current.data();
+    frame.width = range.width;
+    frame.height = range.height;
+    frame.stride = static_cast<size_t>(range.width) * 4;
+
+    for (size_t i = 0; i < range.entries.size(); i++) {
+        const Entry& entry = range.entries[i];
+        const uint8_t* reference = entry.keyframe ? nullptr : current.data();
+        if (!DecodeFrame(entry.data->data(), entry.data->size(), reference, current.data(), pixelCount)) return false;
+        if (i >= range.first && !visit(frame, entry.timestampMs)) break;
+    }
+    return true;
+}
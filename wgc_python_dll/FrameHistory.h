@@ -0,0 +1,111 @@
+#pragma once
+#include "FrameView.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 无损帧压缩: 以像素 (4 字节) 为单位, 交替记录 "与预测相同" 的游程和字面像素
+// 关键帧以左侧像素为预测, 差分帧以参考帧同位置像素为预测
+void EncodeFrame(const uint8_t* pixels, const uint8_t* reference, size_t pixelCount, std::vector<uint8_t>& out);
+// reference 为空表示关键帧; 差分帧时 reference 可以与 outPixels 相同 (原地更新)
+bool DecodeFrame(const uint8_t* data, size_t length, const uint8_t* reference, uint8_t* outPixels, size_t pixelCount);
+
+struct FrameHistoryOptions
+{
+    int64_t windowMs = 30000;
+    size_t memoryBudget = 256u * 1024 * 1024;
+    int keyframeInterval = 60;
+    int maxFps = 30;
+};
+
+// 按时间索引的压缩帧环形缓冲 ("最近 N 秒")
+// Submit 只做一次拷贝, 压缩在内部工作线程完成; 工作线程繁忙时只保留最新帧
+class FrameHistory
+{
+public:
+    // 分段读取时每段的默认帧数 (4K 帧约 265MB)
+    static constexpr size_t kDefaultChunkFrames = 8;
+
+    explicit FrameHistory(const FrameHistoryOptions& options);
+    ~FrameHistory();
+
+    FrameHistory(const FrameHistory&) = delete;
+    FrameHistory& operator=(const FrameHistory&) = delete;
+
+    void Submit(const FrameView& frame, int64_t timestampMs);
+    // 等待已提交的帧全部压缩完成
+    void Flush();
+    void Clear();
+
+    size_t FrameCount() const;
+    size_t MemoryUsage() const;
+    bool GetTimeRange(int64_t* oldestMs, int64_t* newestMs) const;
+
+    struct Entry
+    {
+        int64_t timestampMs;
+        bool keyframe;
+        // 压缩数据只读共享, 取出一段帧时只复制引用
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+
+    // 一段待解码的帧: 从所需的关键帧开始, entries[first] 起为请求区间内的帧
+    struct Range
+    {
+        int width = 0;
+        int height = 0;
+        size_t first = 0;
+        std::vector<Entry> entries;
+
+        size_t FrameCount() const { return entries.size() - first; }
+    };
+
+    // 取出 [startMs, endMs] 内最多 maxFrames 帧 (0 表示不限); 只在此期间持有环的锁
+    // 分段读取时下一段从上一段最后一帧的时间戳 + 1 开始
+    bool Snapshot(int64_t startMs, int64_t endMs, size_t maxFrames, Range& range) const;
+
+    // 按时间顺序逐帧解码, visit 收到的帧只在回调期间有效; visit 返回 false 时停止
+    // 不访问环, 解码期间压缩线程照常工作
+    using FrameVisitor = std::function<bool(const FrameView& frame, int64_t timestampMs)>;
+    static bool Decode(const Range& range, const FrameVisitor& visit);
+
+private:
+    FrameHistoryOptions m_options;
+
+    // 待压缩帧 (生产者 -> 工作线程)
+    std::mutex m_pendingMutex;
+    std::condition_variable m_pendingCv;
+    std::condition_variable m_idleCv;
+    std::vector<uint8_t> m_pending;
+    int64_t m_pendingTimestamp = 0;
+    int m_pendingWidth = 0;
+    int m_pendingHeight = 0;
+    bool m_hasPending = false;
+    bool m_busy = false;
+    bool m_stop = false;
+    int64_t m_lastSubmitMs = INT64_MIN;
+
+    // 已压缩帧
+    mutable std::mutex m_ringMutex;
+    std::deque<Entry> m_ring;
+    size_t m_memoryUsage = 0;
+    size_t m_keyframeCount = 0;
+    int m_width = 0;
+    int m_height = 0;
+    bool m_forceKeyframe = true;
+
+    // 仅工作线程访问
+    std::vector<uint8_t> m_work;
+    std::vector<uint8_t> m_reference;
+    int m_framesSinceKey = 0;
+
+    std::thread m_worker;
+
+    void WorkerLoop();
+    void Compress(int width, int height, int64_t timestampMs);
+    void EvictLocked(int64_t newestMs);
+};
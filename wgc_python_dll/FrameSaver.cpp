@@ -0,0 +1,171 @@
+#include "FrameSaver.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+    constexpr size_t kMaxFreeBuffers = 4;
+    constexpr size_t kMaxStatusEntries = 1024;
+}
+
+FrameSaver::FrameSaver(int workers, int pngStripes)
+    : m_pngStripes(pngStripes > 0 ? pngStripes : std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+      m_stripePool(m_pngStripes - 1)
+{
+    for (int i = 0; i < std::max(1, workers); i++) {
+        m_workers.emplace_back(&FrameSaver::WorkerLoop, this);
+    }
+}
+
+FrameSaver::~FrameSaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_workCv.notify_all();
+    // 已提交的截图仍会写完
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+std::vector<uint8_t> FrameSaver::AcquireBuffer(size_t size)
+{
+    std::vector<uint8_t> buffer;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto best = m_freeBuffers.end();
+        for (auto it = m_freeBuffers.begin(); it != m_freeBuffers.end(); ++it) {
+            if (it->capacity() >= size && (best == m_freeBuffers.end() || it->capacity() < best->capacity())) {
+                best = it;
+            }
+        }
+        if (best == m_freeBuffers.end() && !m_freeBuffers.empty()) best = m_freeBuffers.begin();
+        if (best != m_freeBuffers.end()) {
+            buffer = std::move(*best);
+            m_freeBuffers.erase(best);
+        }
+    }
+    buffer.resize(size);
+    return buffer;
+}
+
+void FrameSaver::ReleaseBuffer(std::vector<uint8_t> buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_freeBuffers.size() < kMaxFreeBuffers) m_freeBuffers.push_back(std::move(buffer));
+}
+
+int FrameSaver::Submit(std::vector<uint8_t> pixels, int width, int height, const std::string& path,
+    int format, bool withAlpha)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int id = m_nextId++;
+    m_queue.push_back({ id, std::move(pixels), width, height, path, format, withAlpha });
+    m_status[id] = SaveStatusPending;
+
+    // 只保留最近的状态记录, 丢弃最早已结束的任务
+    while (m_status.size() > kMaxStatusEntries) {
+        auto it = m_status.begin();
+        while (it != m_status.end() && it->second == SaveStatusPending) ++it;
+        if (it == m_status.end()) break;
+        m_status.erase(it);
+    }
+
+    m_workCv.notify_one();
+    return id;
+}
+
+int FrameSaver::Status(int jobId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_status.find(jobId);
+    return it == m_status.end() ? SaveStatusUnknown : it->second;
+}
+
+int FrameSaver::Wait(int jobId, int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto finished = [&] {
+        auto it = m_status.find(jobId);
+        return it == m_status.end() || it->second != SaveStatusPending;
+    };
+
+    if (timeoutMs < 0) {
+        m_doneCv.wait(lock, finished);
+    } else {
+        m_doneCv.wait_for(lock, std::chrono::milliseconds(timeoutMs), finished);
+    }
+
+    auto it = m_status.find(jobId);
+    return it == m_status.end() ? SaveStatusUnknown : it->second;
+}
+
+void FrameSaver::SetCallback(Callback callback)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_callback = std::move(callback);
+}
+
+void FrameSaver::WorkerLoop()
+{
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workCv.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        bool ok = false;
+        try {
+            ok = Process(job);
+        } catch (...) {
+        }
+
+        Callback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_status.find(job.id);
+            if (it != m_status.end()) it->second = ok ? SaveStatusDone : SaveStatusFailed;
+            callback = m_callback;
+        }
+        m_doneCv.notify_all();
+        ReleaseBuffer(std::move(job.pixels));
+
+        if (callback) {
+            try {
+                callback(job.id, ok);
+            } catch (...) {
+            }
+        }
+    }
+}
+
+bool FrameSaver::Process(const Job& job)
+{
+    FrameView frame{ job.pixels.data(), job.width, job.height, static_cast<size_t>(job.width) * 4 };
+    if (!frame.IsValid()) return false;
+
+    std::vector<uint8_t> encoded;
+    if (job.format == ImageFormatPng) {
+        EncodePng(frame, job.withAlpha, m_pngStripes, encoded, &m_stripePool);
+    } else if (job.format == ImageFormatQoi) {
+        EncodeQoi(frame, job.withAlpha, encoded);
+    } else {
+        return false;
+    }
+    if (encoded.empty()) return false;
+
+    // UTF-8 路径, Windows 上经 filesystem::path 转为宽字符
+    std::u8string path(job.path.begin(), job.path.end());
+    std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "ImageEncoder.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum SaveStatus
+{
+    SaveStatusUnknown = 0,
+    SaveStatusPending = 1,
+    SaveStatusDone = 2,
+    SaveStatusFailed = 3,
+};
+
+// 后台编码并写盘: 调用方只做一次帧拷贝 (拷入池化缓冲) 即返回
+// 完成回调在工作线程上调用
+class FrameSaver
+{
+public:
+    using Callback = std::function<void(int jobId, bool success)>;
+
+    // pngStripes <= 0 时取硬件线程数; 条带在 pngStripes - 1 个常驻线程与工作线程上并行
+    explicit FrameSaver(int workers = 2, int pngStripes = 0);
+    ~FrameSaver();
+
+    FrameSaver(const FrameSaver&) = delete;
+    FrameSaver& operator=(const FrameSaver&) = delete;
+
+    // 取一块至少 size 字节的缓冲, 优先复用已完成任务归还的内存
+    std::vector<uint8_t> AcquireBuffer(size_t size);
+
+    // pixels 为无行填充的 BGRA, path 为 UTF-8; 返回任务 ID
+    int Submit(std::vector<uint8_t> pixels, int width, int height, const std::string& path,
+        int format, bool withAlpha);
+
+    int Status(int jobId) const;
+    // 等待任务结束, 返回最终状态; 超时返回 SaveStatusPending
+    int Wait(int jobId, int timeoutMs);
+    void SetCallback(Callback callback);
+
+private:
+    struct Job
+    {
+        int id;
+        std::vector<uint8_t> pixels;
+        int width;
+        int height;
+        std::string path;
+        int format;
+        bool withAlpha;
+    };
+
+    void WorkerLoop();
+    bool Process(const Job& job);
+    void ReleaseBuffer(std::vector<uint8_t> buffer);
+
+    int m_pngStripes;
+    StripeWorkerPool m_stripePool;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workCv;
+    std::condition_variable m_doneCv;
+    std::deque<Job> m_queue;
+    std::map<int, int> m_status;
+    std::vector<std::vector<uint8_t>> m_freeBuffers;
+    std::vector<std::thread> m_workers;
+    Callback m_callback;
+    int m_nextId = 1;
+    bool m_stop = false;
+};
@@ -0,0 +1,137 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+FrameStatsAccumulator::FrameStatsAccumulator(int flags) : m_flags(flags)
+{
+    if (m_flags & FrameStatsHistogram) {
+        memset(m_histogram, 0, sizeof(m_histogram));
+    }
+    memset(m_min, 0xFF, sizeof(m_min));
+    memset(m_max, 0x00, sizeof(m_max));
+}
+
+void FrameStatsAccumulator::AddRow(const uint8_t* bgra, int width)
+{
+    if (width <= 0) return;
+
+    // 只请求像素数时也要计数
+    m_pixelCount += width;
+    if (m_flags & FrameStatsHistogram) {
+        AddRowHistogram(bgra, width);
+    } else if (m_flags != 0) {
+        AddRowSumsMinMax(bgra, width);
+    }
+}
+
+void FrameStatsAccumulator::AddRowHistogram(const uint8_t* bgra, int width)
+{
+    // 两组直方图交替写入, 减少相邻像素同值时的写后读依赖
+    int x = 0;
+    for (; x + 1 < width; x += 2) {
+        const uint8_t* p = bgra + x * 4;
+        m_histogram[0][0][p[0]]++;
+        m_histogram[0][1][p[1]]++;
+        m_histogram[0][2][p[2]]++;
+        m_histogram[0][3][p[3]]++;
+        m_histogram[1][0][p[4]]++;
+        m_histogram[1][1][p[5]]++;
+        m_histogram[1][2][p[6]]++;
+        m_histogram[1][3][p[7]]++;
+    }
+    if (x < width) {
+        const uint8_t* p = bgra + x * 4;
+        for (int c = 0; c < 4; c++) m_histogram[0][c][p[c]]++;
+    }
+}
+
+void FrameStatsAccumulator::AddRowSumsMinMax(const uint8_t* bgra, int width)
+{
+    int x = 0;
+#ifdef WGC_HAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i channelMask = _mm_set1_epi32(0xFF);
+    __m128i sums[4] = { zero, zero, zero, zero };
+    __m128i vmin = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_min));
+    __m128i vmax = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_max));
+
+    for (; x + 4 <= width; x += 4) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + x * 4));
+        vmin = _mm_min_epu8(vmin, px);
+        vmax = _mm_max_epu8(vmax, px);
+        // 每个通道单独取出后用 SAD 水平求和
+        sums[0] = _mm_add_epi64(sums[0], _mm_sad_epu8(_mm_and_si128(px, channelMask), zero));
+        sums[1] = _mm_add_epi64(sums[1], _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(px, 8), channelMask), zero));
+        sums[2] = _mm_add_epi64(sums[2], _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(px, 16), channelMask), zero));
+        sums[3] = _mm_add_epi64(sums[3], _mm_sad_epu8(_mm_srli_epi32(px, 24), zero));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_min), vmin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(m_max), vmax);
+    for (int c = 0; c < 4; c++) {
+        uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums[c]);
+        m_sum[c] += lanes[0] + lanes[1];
+    }
+#endif
+
+    for (; x < width; x++) {
+        const uint8_t* p = bgra + x * 4;
+        for (int c = 0; c < 4; c++) {
+            m_sum[c] += p[c];
+            m_min[c] = std::min(m_min[c], p[c]);
+            m_max[c] = std::max(m_max[c], p[c]);
+        }
+    }
+}
+
+void FrameStatsAccumulator::Finalize(FrameStatistics& out) const
+{
+    out = FrameStatistics();
+    out.pixelCount = m_pixelCount;
+    if (m_pixelCount == 0) return;
+
+    if (m_flags & FrameStatsHistogram) {
+        for (int c = 0; c < 4; c++) {
+            int lo = -1, hi = -1;
+            for (int v = 0; v < 256; v++) {
+                uint32_t n = m_histogram[0][c][v] + m_histogram[1][c][v];
+                out.histogram[c][v] = n;
+                out.sum[c] += static_cast<uint64_t>(n) * v;
+                if (n) {
+                    if (lo < 0) lo = v;
+                    hi = v;
+                }
+            }
+            out.minValue[c] = static_cast<uint8_t>(lo);
+            out.maxValue[c] = static_cast<uint8_t>(hi);
+        }
+        return;
+    }
+
+    // SIMD 累加器的 16 个字节按像素排列, 下标 i 对应通道 i % 4
+    for (int c = 0; c < 4; c++) {
+        out.sum[c] = m_sum[c];
+        uint8_t lo = 0xFF, hi = 0;
+        for (int i = c; i < 16; i += 4) {
+            lo = std::min(lo, m_min[i]);
+            hi = std::max(hi, m_max[i]);
+        }
+        out.minValue[c] = lo;
+        out.maxValue[c] = hi;
+    }
+}
+
+void ComputeFrameStats(const FrameView& frame, const FrameRect& roi, int flags, FrameStatistics& out)
+{
+    FrameStatsAccumulator acc(flags);
+    FrameRect r = roi.ClampTo(frame.width, frame.height);
+    for (int y = r.y; y < r.y + r.height; y++) {
+        acc.AddRow(frame.Row(y) + static_cast<size_t>(r.x) * 4, r.width);
+    }
+    acc.Finalize(out);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "FrameView.h"
+
+// 通道顺序与帧数据一致: B, G, R, A
+struct FrameStatistics
+{
+    uint32_t histogram[4][256] = {};
+    uint64_t sum[4] = {};
+    uint8_t minValue[4] = {};
+    uint8_t maxValue[4] = {};
+    uint64_t pixelCount = 0;
+};
+
+enum FrameStatsFlags
+{
+    FrameStatsHistogram = 1,
+    FrameStatsSums = 2,
+    FrameStatsMinMax = 4,
+};
+
+// 按行累加统计量, 可在拷贝行的同时调用 (行数据仍在缓存中)
+// 启用直方图时总和与最值由直方图导出; 否则用 SSE2 直接累加
+class FrameStatsAccumulator
+{
+public:
+    explicit FrameStatsAccumulator(int flags);
+
+    int Flags() const { return m_flags; }
+    void AddRow(const uint8_t* bgra, int width);
+    void Finalize(FrameStatistics& out) const;
+
+private:
+    int m_flags;
+    uint64_t m_pixelCount = 0;
+    uint32_t m_histogram[2][4][256];
+    uint64_t m_sum[4] = {};
+    uint8_t m_min[16];
+    uint8_t m_max[16];
+
+    void AddRowHistogram(const uint8_t* bgra, int width);
+    void AddRowSumsMinMax(const uint8_t* bgra, int width);
+};
+
+void ComputeFrameStats(const FrameView& frame, const FrameRect& roi, int flags, FrameStatistics& out);
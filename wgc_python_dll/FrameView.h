@@ -0,0 +1,57 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 不依赖 Windows 头文件的图像视图, 供纯算法模块使用 (可在 Linux 下单独编译)
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define WGC_HAS_SSE2 1
+#endif
+
+// 帧时间戳使用的单调时钟 (毫秒)
+inline int64_t CaptureClockMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct FrameView
+{
+    const uint8_t* data = nullptr;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0; // 每行字节数, BGRA 格式下 >= width * 4
+
+    const uint8_t* Row(int y) const { return data + static_cast<size_t>(y) * stride; }
+    bool IsValid() const { return data && width > 0 && height > 0 && stride >= static_cast<size_t>(width) * 4; }
+};
+
+struct FrameRect
+{
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    // width/height <= 0 表示整帧; 结果裁剪到帧范围内
+    FrameRect ClampTo(int frameWidth, int frameHeight) const
+    {
+        FrameRect r = *this;
+        if (r.width <= 0 || r.height <= 0) {
+            r.x = 0;
+            r.y = 0;
+            r.width = frameWidth;
+            r.height = frameHeight;
+        }
+        if (r.x < 0) { r.width += r.x; r.x = 0; }
+        if (r.y < 0) { r.height += r.y; r.y = 0; }
+        if (r.x + r.width > frameWidth) r.width = frameWidth - r.x;
+        if (r.y + r.height > frameHeight) r.height = frameHeight - r.y;
+        if (r.width < 0) r.width = 0;
+        if (r.height < 0) r.height = 0;
+        return r;
+    }
+
+    bool IsEmpty() const { return width <= 0 || height <= 0; }
+};
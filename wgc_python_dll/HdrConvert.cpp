@@ -0,0 +1,182 @@
+#include "HdrConvert.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define WGC_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WGC_TARGET_AVX2
+#else
+#define WGC_TARGET_AVX2 __attribute__((target("avx2,f16c,fma")))
+#endif
+#endif
+
+float HalfToFloat(uint16_t h)
+{
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // 非规格化数
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3FF;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float f;
+    memcpy(&f, &bits, 4);
+    return f;
+}
+
+HdrConverter::HdrConverter(const ToneMapParams& params) : m_params(params), m_useSimd(HasSimdSupport())
+{
+    if (!(m_params.exposure > 0.0f)) m_params.exposure = 1.0f;
+    if (!(m_params.whitePoint > 0.0f)) m_params.whitePoint = 1.0f;
+
+    for (int i = 0; i < kLutSize; i++) {
+        double linear = static_cast<double>(i) / (kLutSize - 1);
+        double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+        m_srgbLut[i] = static_cast<uint8_t>(std::clamp(srgb * 255.0 + 0.5, 0.0, 255.0));
+    }
+}
+
+bool HdrConverter::HasSimdSupport()
+{
+#if defined(WGC_HAS_AVX2_KERNELS) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool f16c = (info[2] & (1 << 29)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    if (!f16c || !osxsave || !fma) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(WGC_HAS_AVX2_KERNELS)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c") && __builtin_cpu_supports("fma");
+#else
+    return false;
+#endif
+}
+
+float HdrConverter::ToneMap(float v) const
+{
+    float x = v * m_params.exposure;
+    if (!(x > 0.0f)) x = 0.0f; // 负值与 NaN
+    switch (m_params.op) {
+    case ToneMapReinhard: {
+        float w2 = m_params.whitePoint * m_params.whitePoint;
+        x = x * (1.0f + x / w2) / (1.0f + x);
+        break;
+    }
+    case ToneMapAces:
+        x = (x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f);
+        break;
+    default:
+        break;
+    }
+    return x < 1.0f ? x : 1.0f; // 正无穷经上式得到 NaN, 同样映射为 1
+}
+
+void HdrConverter::ConvertRow(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const
+{
+    if (m_useSimd) {
+        ConvertRowAvx2(rgbaHalf, dst, width, dstChannels);
+    } else {
+        ConvertRowScalar(rgbaHalf, dst, width, dstChannels);
+    }
+}
+
+void HdrConverter::ConvertRowScalar(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const
+{
+    for (int x = 0; x < width; x++) {
+        const uint16_t* p = rgbaHalf + x * 4;
+        uint8_t* d = dst + x * dstChannels;
+        for (int c = 0; c < 3; c++) {
+            float v = ToneMap(HalfToFloat(p[2 - c]));
+            d[c] = m_srgbLut[static_cast<int>(v * (kLutSize - 1) + 0.5f)];
+        }
+        if (dstChannels == 4) {
+            float a = HalfToFloat(p[3]);
+            a = a > 0.0f ? std::min(a, 1.0f) : 0.0f;
+            d[3] = static_cast<uint8_t>(a * 255.0f + 0.5f);
+        }
+    }
+}
+
+#ifdef WGC_HAS_AVX2_KERNELS
+WGC_TARGET_AVX2
+void HdrConverter::ConvertRowAvx2(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 exposure = _mm256_set1_ps(m_params.exposure);
+    const __m256 invWhite2 = _mm256_set1_ps(1.0f / (m_params.whitePoint * m_params.whitePoint));
+    const __m256 lutScale = _mm256_set1_ps(static_cast<float>(kLutSize - 1));
+    const __m256 alphaScale = _mm256_set1_ps(255.0f);
+    // 每 8 个浮点数为 2 个 RGBA 像素, 第 3/7 位是 alpha, 不参与色调映射
+    const __m256 alphaMask = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+
+    alignas(32) int32_t idx[8];
+    int x = 0;
+    for (; x + 2 <= width; x += 2) {
+        __m128i halfs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgbaHalf + x * 4));
+        __m256 v = _mm256_cvtph_ps(halfs);
+
+        __m256 alpha = _mm256_min_ps(_mm256_max_ps(v, zero), one);
+        __m256 t = _mm256_max_ps(_mm256_mul_ps(v, exposure), zero);
+
+        if (m_params.op == ToneMapReinhard) {
+            __m256 num = _mm256_mul_ps(t, _mm256_fmadd_ps(t, invWhite2, one));
+            t = _mm256_div_ps(num, _mm256_add_ps(one, t));
+        } else if (m_params.op == ToneMapAces) {
+            __m256 num = _mm256_mul_ps(t, _mm256_fmadd_ps(t, _mm256_set1_ps(2.51f), _mm256_set1_ps(0.03f)));
+            __m256 den = _mm256_fmadd_ps(t, _mm256_fmadd_ps(t, _mm256_set1_ps(2.43f), _mm256_set1_ps(0.59f)), _mm256_set1_ps(0.14f));
+            t = _mm256_div_ps(num, den);
+        }
+        t = _mm256_min_ps(t, one);
+
+        __m256 color = _mm256_mul_ps(t, lutScale);
+        __m256 alphaOut = _mm256_mul_ps(alpha, alphaScale);
+        __m256 scaled = _mm256_blendv_ps(color, alphaOut, alphaMask);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(idx), _mm256_cvtps_epi32(scaled));
+
+        for (int k = 0; k < 2; k++) {
+            const int32_t* s = idx + k * 4;
+            uint8_t* d = dst + (x + k) * dstChannels;
+            d[0] = m_srgbLut[s[2]];
+            d[1] = m_srgbLut[s[1]];
+            d[2] = m_srgbLut[s[0]];
+            if (dstChannels == 4) d[3] = static_cast<uint8_t>(s[3]);
+        }
+    }
+
+    if (x < width) {
+        ConvertRowScalar(rgbaHalf + x * 4, dst + x * dstChannels, width - x, dstChannels);
+    }
+}
+#else
+void HdrConverter::ConvertRowAvx2(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const
+{
+    ConvertRowScalar(rgbaHalf, dst, width, dstChannels);
+}
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+#include "FrameView.h"
+
+enum ToneMapOperator
+{
+    ToneMapClamp = 0,    // 直接截断到 SDR 白点
+    ToneMapReinhard = 1, // 扩展 Reinhard, whitePoint 处映射为 1.0
+    ToneMapAces = 2,     // ACES 拟合曲线 (Narkowicz)
+};
+
+// 输入为 scRGB 线性值 (1.0 = SDR 白, 80 nits)
+struct ToneMapParams
+{
+    int op = ToneMapReinhard;
+    float exposure = 1.0f;
+    float whitePoint = 4.0f;
+};
+
+// R16G16B16A16Float -> 8 位 BGRA/BGR, 输出经 sRGB 编码
+// 有 AVX2 + F16C 时使用向量化的半精度转换与色调映射, 否则回退到标量实现
+class HdrConverter
+{
+public:
+    explicit HdrConverter(const ToneMapParams& params = ToneMapParams());
+
+    const ToneMapParams& Params() const { return m_params; }
+
+    // dstChannels: 4 (BGRA) 或 3 (BGR)
+    void ConvertRow(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const;
+    void ConvertRowScalar(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const;
+
+    static bool HasSimdSupport();
+
+private:
+    static constexpr int kLutBits = 14;
+    static constexpr int kLutSize = 1 << kLutBits;
+
+    ToneMapParams m_params;
+    uint8_t m_srgbLut[kLutSize];
+    bool m_useSimd;
+
+    float ToneMap(float v) const;
+    void ConvertRowAvx2(const uint16_t* rgbaHalf, uint8_t* dst, int width, int dstChannels) const;
+};
+
+float HalfToFloat(uint16_t h);
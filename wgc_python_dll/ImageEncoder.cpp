@@ -0,0 +1,536 @@
+#include "ImageEncoder.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+namespace
+{
+    void PutBE32(std::vector<uint8_t>& out, uint32_t v)
+    {
+        out.push_back(static_cast<uint8_t>(v >> 24));
+        out.push_back(static_cast<uint8_t>(v >> 16));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    struct Crc32Table
+    {
+        uint32_t entries[256];
+
+        Crc32Table()
+        {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[i] = c;
+            }
+        }
+    };
+
+    const Crc32Table& CrcTable()
+    {
+        static const Crc32Table table;
+        return table;
+    }
+
+    // deflate 比特流, 低位在前
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+        void Put(uint32_t bits, int count)
+        {
+            m_buffer |= static_cast<uint64_t>(bits) << m_count;
+            m_count += count;
+            while (m_count >= 8) {
+                m_out.push_back(static_cast<uint8_t>(m_buffer));
+                m_buffer >>= 8;
+                m_count -= 8;
+            }
+        }
+
+        void AlignToByte()
+        {
+            if (m_count > 0) Put(0, 8 - m_count);
+        }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint64_t m_buffer = 0;
+        int m_count = 0;
+    };
+
+    uint32_t ReverseBits(uint32_t code, int length)
+    {
+        uint32_t r = 0;
+        for (int i = 0; i < length; i++) {
+            r = (r << 1) | (code & 1);
+            code >>= 1;
+        }
+        return r;
+    }
+
+    constexpr int kLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr int kLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    constexpr int kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    constexpr int kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // 固定 Huffman 码表 (已按输出顺序反转) 及长度码查找表
+    struct FixedCodes
+    {
+        uint16_t litCode[288];
+        uint8_t litBits[288];
+        uint16_t distCode[30];
+        uint8_t lengthSymbol[259];
+
+        FixedCodes()
+        {
+            for (int s = 0; s < 288; s++) {
+                uint32_t code;
+                int bits;
+                if (s < 144) { code = 0x30 + s; bits = 8; }
+                else if (s < 256) { code = 0x190 + (s - 144); bits = 9; }
+                else if (s < 280) { code = s - 256; bits = 7; }
+                else { code = 0xC0 + (s - 280); bits = 8; }
+                litCode[s] = static_cast<uint16_t>(ReverseBits(code, bits));
+                litBits[s] = static_cast<uint8_t>(bits);
+            }
+            for (int d = 0; d < 30; d++) distCode[d] = static_cast<uint16_t>(ReverseBits(d, 5));
+
+            int sym = 0;
+            for (int len = 3; len <= 258; len++) {
+                while (sym < 28 && len >= kLengthBase[sym + 1]) sym++;
+                lengthSymbol[len] = static_cast<uint8_t>(sym);
+            }
+        }
+    };
+
+    const FixedCodes& Codes()
+    {
+        static const FixedCodes codes;
+        return codes;
+    }
+
+    int DistanceSymbol(int distance)
+    {
+        return static_cast<int>(std::upper_bound(kDistBase, kDistBase + 30, distance) - kDistBase) - 1;
+    }
+
+    constexpr int kHashBits = 15;
+    constexpr int kWindowSize = 32768;
+    constexpr int kMaxMatch = 258;
+    constexpr int kMaxChain = 8;
+
+    inline uint32_t Hash3(const uint8_t* p)
+    {
+        return ((p[0] << 10) ^ (p[1] << 5) ^ p[2]) & ((1u << kHashBits) - 1);
+    }
+
+    void ToRgb(const uint8_t* bgra, uint8_t* dst, int width, bool withAlpha)
+    {
+        if (withAlpha) {
+            for (int x = 0; x < width; x++) {
+                dst[x * 4 + 0] = bgra[x * 4 + 2];
+                dst[x * 4 + 1] = bgra[x * 4 + 1];
+                dst[x * 4 + 2] = bgra[x * 4 + 0];
+                dst[x * 4 + 3] = bgra[x * 4 + 3];
+            }
+        } else {
+            for (int x = 0; x < width; x++) {
+                dst[x * 3 + 0] = bgra[x * 4 + 2];
+                dst[x * 3 + 1] = bgra[x * 4 + 1];
+                dst[x * 3 + 2] = bgra[x * 4 + 0];
+            }
+        }
+    }
+
+    struct PngStripe
+    {
+        std::vector<uint8_t> compressed;
+        uint32_t adler = 1;
+        size_t rawSize = 0;
+    };
+
+    // 滤波 (每行在 Sub/Up 中取绝对值和较小者) 后压缩 [y0, y1) 行
+    void EncodePngStripe(const FrameView& frame, bool withAlpha, int y0, int y1, bool final, PngStripe& stripe)
+    {
+        int bpp = withAlpha ? 4 : 3;
+        size_t rowBytes = static_cast<size_t>(frame.width) * bpp;
+
+        std::vector<uint8_t> raw((rowBytes + 1) * (y1 - y0));
+        std::vector<uint8_t> previous(rowBytes, 0), current(rowBytes), sub(rowBytes), up(rowBytes);
+        if (y0 > 0) ToRgb(frame.Row(y0 - 1), previous.data(), frame.width, withAlpha);
+
+        uint8_t* dst = raw.data();
+        for (int y = y0; y < y1; y++) {
+            ToRgb(frame.Row(y), current.data(), frame.width, withAlpha);
+
+            uint32_t subCost = 0, upCost = 0;
+            for (size_t i = 0; i < rowBytes; i++) {
+                uint8_t left = i >= static_cast<size_t>(bpp) ? current[i - bpp] : 0;
+                sub[i] = static_cast<uint8_t>(current[i] - left);
+                up[i] = static_cast<uint8_t>(current[i] - previous[i]);
+                subCost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(sub[i])));
+                upCost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(up[i])));
+            }
+
+            bool useUp = y > 0 && upCost < subCost;
+            *dst++ = useUp ? 2 : 1;
+            memcpy(dst, useUp ? up.data() : sub.data(), rowBytes);
+            dst += rowBytes;
+            current.swap(previous);
+        }
+
+        stripe.rawSize = raw.size();
+        stripe.adler = Adler32(1, raw.data(), raw.size());
+        DeflateFixed(raw.data(), raw.size(), final, stripe.compressed);
+    }
+
+    void WriteChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size)
+    {
+        PutBE32(out, static_cast<uint32_t>(size));
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        if (size) out.insert(out.end(), data, data + size);
+        uint32_t crc = Crc32(0, out.data() + start, size + 4);
+        PutBE32(out, crc);
+    }
+}
+
+uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size)
+{
+    constexpr uint32_t base = 65521;
+    constexpr size_t nmax = 5552; // 保证 32 位累加不溢出的最大块长
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while (size > 0) {
+        size_t n = std::min(size, nmax);
+        size -= n;
+        while (n--) {
+            a += *data++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, size_t size2)
+{
+    constexpr uint32_t base = 65521;
+    uint32_t rem = static_cast<uint32_t>(size2 % base);
+    uint32_t sum1 = adler1 & 0xFFFF;
+    uint32_t sum2 = static_cast<uint32_t>((static_cast<uint64_t>(rem) * sum1) % base);
+    sum1 += (adler2 & 0xFFFF) + base - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + base - rem;
+    if (sum1 >= base) sum1 -= base;
+    if (sum1 >= base) sum1 -= base;
+    if (sum2 >= (base << 1)) sum2 -= (base << 1);
+    if (sum2 >= base) sum2 -= base;
+    return (sum2 << 16) | sum1;
+}
+
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size)
+{
+    const uint32_t* table = CrcTable().entries;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void DeflateFixed(const uint8_t* data, size_t size, bool final, std::vector<uint8_t>& out)
+{
+    const FixedCodes& codes = Codes();
+    BitWriter writer(out);
+    writer.Put(final ? 1 : 0, 1);
+    writer.Put(1, 2); // 固定 Huffman
+
+    auto putLiteral = [&](int symbol) {
+        writer.Put(codes.litCode[symbol], codes.litBits[symbol]);
+    };
+
+    std::vector<int32_t> head(1u << kHashBits, -1);
+    std::vector<int32_t> prev(size);
+
+    auto insert = [&](size_t pos) {
+        uint32_t h = Hash3(data + pos);
+        prev[pos] = head[h];
+        head[h] = static_cast<int32_t>(pos);
+    };
+
+    size_t pos = 0;
+    while (pos < size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+
+        if (pos + 3 <= size) {
+            int maxLength = static_cast<int>(std::min<size_t>(kMaxMatch, size - pos));
+            int32_t candidate = head[Hash3(data + pos)];
+            for (int chain = 0; chain < kMaxChain && candidate >= 0; chain++) {
+                int distance = static_cast<int>(pos - candidate);
+                if (distance > kWindowSize) break;
+
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + pos;
+                if (a[bestLength] == b[bestLength]) {
+                    int length = 0;
+                    while (length < maxLength && a[length] == b[length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = distance;
+                        if (length == maxLength) break;
+                    }
+                }
+                candidate = prev[candidate];
+            }
+            insert(pos);
+        }
+
+        if (bestLength >= 3) {
+            int ls = codes.lengthSymbol[bestLength];
+            putLiteral(257 + ls);
+            if (kLengthExtra[ls]) writer.Put(bestLength - kLengthBase[ls], kLengthExtra[ls]);
+
+            int ds = DistanceSymbol(bestDistance);
+            writer.Put(codes.distCode[ds], 5);
+            if (kDistExtra[ds]) writer.Put(bestDistance - kDistBase[ds], kDistExtra[ds]);
+
+            for (int i = 1; i < bestLength; i++) {
+                if (pos + i + 3 <= size) insert(pos + i);
+            }
+            pos += bestLength;
+        } else {
+            putLiteral(data[pos]);
+            pos++;
+        }
+    }
+
+    putLiteral(256);
+
+    if (!final) {
+        // 空存储块: 对齐到字节边界, 使下一段可以直接拼接
+        writer.Put(0, 1);
+        writer.Put(0, 2);
+        writer.AlignToByte();
+        out.push_back(0x00);
+        out.push_back(0x00);
+        out.push_back(0xFF);
+        out.push_back(0xFF);
+    } else {
+        writer.AlignToByte();
+    }
+}
+
+StripeWorkerPool::StripeWorkerPool(int threads)
+{
+    for (int i = 0; i < threads; i++) {
+        m_threads.emplace_back(&StripeWorkerPool::WorkerLoop, this);
+    }
+}
+
+StripeWorkerPool::~StripeWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+bool StripeWorkerPool::RunOneLocked(std::unique_lock<std::mutex>& lock)
+{
+    if (m_queue.empty()) return false;
+    std::function<void()> item = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    item();
+    lock.lock();
+    return true;
+}
+
+void StripeWorkerPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+        if (!RunOneLocked(lock) && m_stop) return;
+    }
+}
+
+void StripeWorkerPool::Run(int count, const std::function<void(int)>& task)
+{
+    if (count <= 0) return;
+    if (m_threads.empty() || count == 1) {
+        for (int i = 0; i < count; i++) task(i);
+        return;
+    }
+
+    struct Batch
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int remaining;
+        std::exception_ptr error;
+    } batch;
+    batch.remaining = count;
+
+    auto runIndex = [&task, &batch](int i) {
+        std::exception_ptr error;
+        try {
+            task(i);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // 持锁通知, Run 返回 (batch 析构) 前最后一个任务已不再访问 batch
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (error && !batch.error) batch.error = error;
+        if (--batch.remaining == 0) batch.cv.notify_all();
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 1; i < count; i++) m_queue.push_back([&runIndex, i] { runIndex(i); });
+    }
+    m_cv.notify_all();
+
+    runIndex(0);
+    {
+        // 等待期间帮忙执行队列中的任务 (可能属于其他并发的 Run), 池线程全忙时也不会饿死
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (RunOneLocked(lock)) {
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.cv.wait(lock, [&] { return batch.remaining == 0; });
+    if (batch.error) std::rethrow_exception(batch.error);
+}
+
+void EncodePng(const FrameView& frame, bool withAlpha, int stripes, std::vector<uint8_t>& out,
+    StripeWorkerPool* pool)
+{
+    out.clear();
+    if (!frame.IsValid()) return;
+
+    // 条带太薄时并行收益抵不过 LZ77 窗口被截断的损失
+    constexpr int kMinStripeRows = 32;
+    stripes = std::clamp(stripes, 1, std::max(1, frame.height / kMinStripeRows));
+    int rowsPerStripe = (frame.height + stripes - 1) / stripes;
+    stripes = (frame.height + rowsPerStripe - 1) / rowsPerStripe;
+
+    std::vector<PngStripe> parts(stripes);
+    auto encodeStripe = [&](int i) {
+        int y0 = i * rowsPerStripe;
+        int y1 = std::min(frame.height, y0 + rowsPerStripe);
+        EncodePngStripe(frame, withAlpha, y0, y1, i == stripes - 1, parts[i]);
+    };
+    if (pool) {
+        pool->Run(stripes, encodeStripe);
+    } else {
+        for (int i = 0; i < stripes; i++) encodeStripe(i);
+    }
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.insert(out.end(), signature, signature + 8);
+
+    std::vector<uint8_t> ihdr;
+    PutBE32(ihdr, static_cast<uint32_t>(frame.width));
+    PutBE32(ihdr, static_cast<uint32_t>(frame.height));
+    ihdr.push_back(8);
+    ihdr.push_back(withAlpha ? 6 : 2);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    WriteChunk(out, "IHDR", ihdr.data(), ihdr.size());
+
+    uint32_t adler = parts[0].adler;
+    for (int i = 1; i < stripes; i++) adler = Adler32Combine(adler, parts[i].adler, parts[i].rawSize);
+
+    // zlib 头 (32K 窗口, 最快压缩级别) 放在第一个 IDAT, adler32 放在最后一个
+    parts[0].compressed.insert(parts[0].compressed.begin(), { 0x78, 0x01 });
+    PutBE32(parts[stripes - 1].compressed, adler);
+
+    for (const PngStripe& part : parts) {
+        WriteChunk(out, "IDAT", part.compressed.data(), part.compressed.size());
+    }
+    WriteChunk(out, "IEND", nullptr, 0);
+}
+
+void EncodeQoi(const FrameView& frame, bool withAlpha, std::vector<uint8_t>& out)
+{
+    out.clear();
+    if (!frame.IsValid()) return;
+
+    out.reserve(14 + static_cast<size_t>(frame.width) * frame.height + 8);
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    PutBE32(out, static_cast<uint32_t>(frame.width));
+    PutBE32(out, static_cast<uint32_t>(frame.height));
+    out.push_back(withAlpha ? 4 : 3);
+    out.push_back(0); // sRGB
+
+    struct Rgba { uint8_t r, g, b, a; };
+    Rgba index[64] = {};
+    Rgba prev = { 0, 0, 0, 255 };
+    int run = 0;
+
+    auto same = [](const Rgba& x, const Rgba& y) {
+        return x.r == y.r && x.g == y.g && x.b == y.b && x.a == y.a;
+    };
+
+    for (int y = 0; y < frame.height; y++) {
+        const uint8_t* row = frame.Row(y);
+        for (int x = 0; x < frame.width; x++) {
+            Rgba px = { row[x * 4 + 2], row[x * 4 + 1], row[x * 4], withAlpha ? row[x * 4 + 3] : uint8_t(255) };
+
+            if (same(px, prev)) {
+                if (++run == 62) {
+                    out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+                run = 0;
+            }
+
+            int slot = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+            if (same(index[slot], px)) {
+                out.push_back(static_cast<uint8_t>(slot));
+            } else {
+                index[slot] = px;
+                if (px.a == prev.a) {
+                    int dr = static_cast<int8_t>(px.r - prev.r);
+                    int dg = static_cast<int8_t>(px.g - prev.g);
+                    int db = static_cast<int8_t>(px.b - prev.b);
+                    int drg = dr - dg;
+                    int dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        out.push_back(static_cast<uint8_t>(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+                    } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                        out.push_back(static_cast<uint8_t>(0x80 | (dg + 32)));
+                        out.push_back(static_cast<uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+                    } else {
+                        out.insert(out.end(), { 0xFE, px.r, px.g, px.b });
+                    }
+                } else {
+                    out.insert(out.end(), { 0xFF, px.r, px.g, px.b, px.a });
+                }
+            }
+            prev = px;
+        }
+    }
+
+    if (run > 0) out.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+    out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+}
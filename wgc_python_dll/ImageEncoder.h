@@ -0,0 +1,55 @@
+#pragma once
+#include "FrameView.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum ImageFormat
+{
+    ImageFormatQoi = 0,
+    ImageFormatPng = 1,
+};
+
+// 输入均为 BGRA; withAlpha 为 false 时输出 RGB (QOI 头部声明 3 通道, alpha 按 255 处理)
+void EncodeQoi(const FrameView& frame, bool withAlpha, std::vector<uint8_t>& out);
+
+// 常驻的条带编码线程池, 由调用方 (FrameSaver) 持有, 避免每个条带临时创建线程
+class StripeWorkerPool
+{
+public:
+    explicit StripeWorkerPool(int threads);
+    ~StripeWorkerPool();
+
+    StripeWorkerPool(const StripeWorkerPool&) = delete;
+    StripeWorkerPool& operator=(const StripeWorkerPool&) = delete;
+
+    // 并行执行 task(0) .. task(count - 1), 调用线程也参与执行, 全部完成后返回;
+    // 可被多个线程同时调用; 任务抛出的第一个异常在此重新抛出
+    void Run(int count, const std::function<void(int)>& task);
+
+private:
+    void WorkerLoop();
+    bool RunOneLocked(std::unique_lock<std::mutex>& lock);
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_queue;
+    std::vector<std::thread> m_threads;
+    bool m_stop = false;
+};
+
+// 按行条带编码: 每个条带独立滤波并压缩为一段 deflate (以同步刷新结尾, 可直接拼接),
+// 各自写成一个 IDAT 块; adler32 分段计算后合并. pool 非空时条带在池中并行, 否则在调用线程上依次编码
+void EncodePng(const FrameView& frame, bool withAlpha, int stripes, std::vector<uint8_t>& out,
+    StripeWorkerPool* pool = nullptr);
+
+// 固定 Huffman 码 + 哈希链 LZ77 的 deflate 压缩, 输出字节对齐
+// final 为 false 时以空的存储块 (同步刷新) 结尾, 便于与后续段拼接
+void DeflateFixed(const uint8_t* data, size_t size, bool final, std::vector<uint8_t>& out);
+
+uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size);
+uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, size_t size2);
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
@@ -0,0 +1,103 @@
+#include "ImagePyramid.h"
+#include <cstring>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+void Downsample2x2Row(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dstWidth)
+{
+    int x = 0;
+#ifdef WGC_HAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(2);
+    // 每次读取两行各 4 个像素, 输出 2 个像素
+    for (; x + 2 <= dstWidth; x += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+        __m128i sum = _mm_unpacklo_epi64(lo, hi);
+        sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(sum, zero));
+    }
+#endif
+    for (; x < dstWidth; x++) {
+        const uint8_t* a = row0 + x * 8;
+        const uint8_t* b = row1 + x * 8;
+        for (int c = 0; c < 4; c++) {
+            dst[x * 4 + c] = static_cast<uint8_t>((a[c] + a[c + 4] + b[c] + b[c + 4] + 2) >> 2);
+        }
+    }
+}
+
+PyramidLayout ComputePyramidLayout(int width, int height, int levels, bool includeFull)
+{
+    PyramidLayout layout;
+    if (levels < 0) levels = 0;
+    if (levels > kMaxPyramidLevels) levels = kMaxPyramidLevels;
+
+    layout.width[0] = width;
+    layout.height[0] = height;
+    for (int i = 1; i <= levels; i++) {
+        layout.width[i] = layout.width[i - 1] / 2;
+        layout.height[i] = layout.height[i - 1] / 2;
+        if (layout.width[i] <= 0 || layout.height[i] <= 0) break;
+        layout.levels = i;
+    }
+
+    size_t offset = 0;
+    for (int i = 0; i <= layout.levels; i++) {
+        if (i == 0 && !includeFull) {
+            layout.offset[0] = -1;
+            continue;
+        }
+        layout.offset[i] = static_cast<int64_t>(offset);
+        offset += static_cast<size_t>(layout.width[i]) * layout.height[i] * 4;
+    }
+    layout.totalBytes = offset;
+    return layout;
+}
+
+PyramidBuilder::PyramidBuilder(const PyramidLayout& layout, uint8_t* output)
+    : m_layout(layout), m_output(output)
+{
+}
+
+uint8_t* PyramidBuilder::LevelRow(int level, int y) const
+{
+    return m_output + m_layout.offset[level] + static_cast<size_t>(y) * m_layout.width[level] * 4;
+}
+
+void PyramidBuilder::AddRow(const uint8_t* row)
+{
+    int y = m_rowsWritten[0]++;
+    if (y >= m_layout.height[0]) return;
+
+    if (m_layout.offset[0] >= 0) {
+        memcpy(LevelRow(0, y), row, static_cast<size_t>(m_layout.width[0]) * 4);
+    }
+
+    if (y & 1) {
+        if (m_layout.levels >= 1) EmitRow(1, m_previousFullRow, row);
+    }
+    m_previousFullRow = row;
+}
+
+void PyramidBuilder::EmitRow(int level, const uint8_t* row0, const uint8_t* row1)
+{
+    int y = m_rowsWritten[level];
+    if (y >= m_layout.height[level]) return;
+    m_rowsWritten[level]++;
+
+    uint8_t* dst = LevelRow(level, y);
+    Downsample2x2Row(row0, row1, dst, m_layout.width[level]);
+
+    if ((y & 1) && level < m_layout.levels) {
+        EmitRow(level + 1, LevelRow(level, y - 1), dst);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "FrameView.h"
+
+constexpr int kMaxPyramidLevels = 3; // 1/2, 1/4, 1/8
+
+// 2x2 均值缩小一行: 两行 BGRA 源数据 -> dstWidth 个像素 (源宽度 >= dstWidth * 2)
+void Downsample2x2Row(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dstWidth);
+
+// 连续存放的金字塔: [原图 (可选)][1/2][1/4][1/8], 均为无行填充的 BGRA
+// 下标 0 为原图, 不包含原图时 offset[0] 为 -1
+struct PyramidLayout
+{
+    int levels = 0;
+    int width[kMaxPyramidLevels + 1] = {};
+    int height[kMaxPyramidLevels + 1] = {};
+    int64_t offset[kMaxPyramidLevels + 1] = {};
+    size_t totalBytes = 0;
+};
+
+PyramidLayout ComputePyramidLayout(int width, int height, int levels, bool includeFull);
+
+// 按行流式构建金字塔: 每输入一行原图即级联生成可得的各层行,
+// 原图每个字节只从源读取一次, 其余层读取的是刚写入 (仍在缓存中) 的上一层
+class PyramidBuilder
+{
+public:
+    PyramidBuilder(const PyramidLayout& layout, uint8_t* output);
+
+    // row 指向的数据需保持有效直到下一次 AddRow 调用
+    void AddRow(const uint8_t* row);
+
+private:
+    PyramidLayout m_layout;
+    uint8_t* m_output;
+    int m_rowsWritten[kMaxPyramidLevels + 1] = {};
+    const uint8_t* m_previousFullRow = nullptr;
+
+    uint8_t* LevelRow(int level, int y) const;
+    void EmitRow(int level, const uint8_t* row0, const uint8_t* row1);
+};
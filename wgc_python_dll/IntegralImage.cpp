@@ -0,0 +1,220 @@
+#include "IntegralImage.h"
+#include "ReadbackPipeline.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+    // 255 * 面积 < 2^32 时 uint32 取模和可精确还原, 更大的矩形拆成两半分别求和
+    constexpr int64_t kMaxExactArea = 0xFFFFFFFFll / 255;
+}
+
+bool IntegralImage::Resize(int width, int height)
+{
+    if (width == m_width && height == m_height && !IsEmpty()) return false;
+
+    m_width = width;
+    m_height = height;
+    m_bands = (height + kBandRows - 1) / kBandRows;
+    m_stride = static_cast<size_t>(width) + 1;
+
+    // 第 0 列恒为 0, 重建时从第 1 列开始写
+    m_luma.assign(static_cast<size_t>(width) * height, 0);
+    m_row.resize(width);
+    m_local.assign(m_stride * height, 0);
+    m_localSq.assign(m_stride * height, 0);
+    m_prefix.assign(m_stride * (m_bands + 1), 0);
+    m_prefixSq.assign(m_stride * (m_bands + 1), 0);
+    m_bandMinX.assign(m_bands, 0);
+    return true;
+}
+
+void IntegralImage::Clear()
+{
+    m_width = 0;
+    m_height = 0;
+    m_bands = 0;
+    m_stride = 0;
+    m_luma = {};
+    m_row = {};
+    m_local = {};
+    m_localSq = {};
+    m_prefix = {};
+    m_prefixSq = {};
+    m_bandMinX = {};
+}
+
+void IntegralImage::MarkChanged(int y, int x)
+{
+    int& minX = m_bandMinX[y / kBandRows];
+    minX = std::min(minX, x);
+}
+
+int IntegralImage::Update(const FrameView& frame)
+{
+    if (!frame.IsValid()) return 0;
+
+    bool rebuild = Resize(frame.width, frame.height);
+    if (!rebuild) std::fill(m_bandMinX.begin(), m_bandMinX.end(), INT_MAX);
+
+    for (int y = 0; y < m_height; y++) {
+        uint8_t* luma = m_luma.data() + static_cast<size_t>(y) * m_width;
+        if (rebuild) {
+            ConvertRowToLuma(frame.Row(y), luma, m_width);
+            continue;
+        }
+
+        ConvertRowToLuma(frame.Row(y), m_row.data(), m_width);
+        if (memcmp(m_row.data(), luma, m_width) == 0) continue;
+
+        int x = static_cast<int>(std::mismatch(m_row.begin(), m_row.end(), luma).first - m_row.begin());
+        memcpy(luma + x, m_row.data() + x, static_cast<size_t>(m_width - x));
+        MarkChanged(y, x);
+    }
+
+    RebuildChanged();
+    return static_cast<int>(std::count_if(m_bandMinX.begin(), m_bandMinX.end(), [](int x) { return x != INT_MAX; }));
+}
+
+int IntegralImage::Update(const FrameView& frame, const FrameRect* dirtyRects, size_t count)
+{
+    if (!frame.IsValid()) return 0;
+    if (IsEmpty() || frame.width != m_width || frame.height != m_height) return Update(frame);
+
+    std::fill(m_bandMinX.begin(), m_bandMinX.end(), INT_MAX);
+    for (size_t i = 0; i < count; i++) {
+        FrameRect rect = dirtyRects[i];
+        if (rect.IsEmpty()) continue;
+        rect = rect.ClampTo(m_width, m_height);
+        if (rect.IsEmpty()) continue;
+
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            ConvertRowToLuma(frame.Row(y) + static_cast<size_t>(rect.x) * 4,
+                m_luma.data() + static_cast<size_t>(y) * m_width + rect.x, rect.width);
+            MarkChanged(y, rect.x);
+        }
+    }
+
+    RebuildChanged();
+    return static_cast<int>(std::count_if(m_bandMinX.begin(), m_bandMinX.end(), [](int x) { return x != INT_MAX; }));
+}
+
+void IntegralImage::RebuildChanged()
+{
+    // 条带内: 变化列 minX 左侧 (含 minX 处的角点) 不受影响, 行前缀从该处的已有值接着累加
+    // 条带边界: 第 b + 1 条边界 = 第 b 条边界 + 第 b 条带末行的局部值, 只重算此前所有变化中最左列右侧
+    int carryMinX = INT_MAX;
+    for (int band = 0; band < m_bands; band++) {
+        int y0 = band * kBandRows;
+        int y1 = std::min(y0 + kBandRows, m_height);
+        int minX = m_bandMinX[band];
+
+        if (minX != INT_MAX) {
+            for (int y = y0; y < y1; y++) {
+                const uint8_t* luma = m_luma.data() + static_cast<size_t>(y) * m_width;
+                uint32_t* local = m_local.data() + static_cast<size_t>(y) * m_stride;
+                uint64_t* localSq = m_localSq.data() + static_cast<size_t>(y) * m_stride;
+                const uint32_t* above = y > y0 ? local - m_stride : nullptr;
+                const uint64_t* aboveSq = y > y0 ? localSq - m_stride : nullptr;
+
+                uint32_t run = local[minX] - (above ? above[minX] : 0);
+                uint64_t runSq = localSq[minX] - (aboveSq ? aboveSq[minX] : 0);
+                if (above) {
+                    for (int x = minX; x < m_width; x++) {
+                        uint32_t v = luma[x];
+                        run += v;
+                        runSq += v * v;
+                        local[x + 1] = above[x + 1] + run;
+                        localSq[x + 1] = aboveSq[x + 1] + runSq;
+                    }
+                } else {
+                    for (int x = minX; x < m_width; x++) {
+                        uint32_t v = luma[x];
+                        run += v;
+                        runSq += v * v;
+                        local[x + 1] = run;
+                        localSq[x + 1] = runSq;
+                    }
+                }
+            }
+        }
+
+        carryMinX = std::min(carryMinX, minX);
+        if (carryMinX == INT_MAX) continue;
+
+        const uint32_t* bandLast = m_local.data() + static_cast<size_t>(y1 - 1) * m_stride;
+        const uint64_t* bandLastSq = m_localSq.data() + static_cast<size_t>(y1 - 1) * m_stride;
+        const uint32_t* prev = m_prefix.data() + static_cast<size_t>(band) * m_stride;
+        const uint64_t* prevSq = m_prefixSq.data() + static_cast<size_t>(band) * m_stride;
+        uint32_t* next = m_prefix.data() + static_cast<size_t>(band + 1) * m_stride;
+        uint64_t* nextSq = m_prefixSq.data() + static_cast<size_t>(band + 1) * m_stride;
+        for (int x = carryMinX + 1; x <= m_width; x++) {
+            next[x] = prev[x] + bandLast[x];
+            nextSq[x] = prevSq[x] + bandLastSq[x];
+        }
+    }
+}
+
+void IntegralImage::Corner(int y, int x, uint32_t& sum, uint64_t& sumSq) const
+{
+    if (y == 0) {
+        sum = 0;
+        sumSq = 0;
+        return;
+    }
+    size_t band = static_cast<size_t>(y - 1) / kBandRows;
+    size_t local = static_cast<size_t>(y - 1) * m_stride + x;
+    size_t prefix = band * m_stride + x;
+    sum = m_prefix[prefix] + m_local[local];
+    sumSq = m_prefixSq[prefix] + m_localSq[local];
+}
+
+void IntegralImage::RectSums(int x0, int y0, int x1, int y1, uint64_t& sum, uint64_t& sumSq) const
+{
+    int64_t area = static_cast<int64_t>(x1 - x0) * (y1 - y0);
+    if (area > kMaxExactArea) {
+        int mid = y0 + (y1 - y0) / 2;
+        uint64_t s0, q0, s1, q1;
+        RectSums(x0, y0, x1, mid, s0, q0);
+        RectSums(x0, mid, x1, y1, s1, q1);
+        sum = s0 + s1;
+        sumSq = q0 + q1;
+        return;
+    }
+
+    uint32_t a, b, c, d;
+    uint64_t aq, bq, cq, dq;
+    Corner(y0, x0, a, aq);
+    Corner(y0, x1, b, bq);
+    Corner(y1, x0, c, cq);
+    Corner(y1, x1, d, dq);
+    sum = static_cast<uint32_t>(d - b - c + a);
+    sumSq = dq - bq - cq + aq;
+}
+
+bool IntegralImage::Query(const FrameRect& rect, double* mean, double* variance) const
+{
+    if (IsEmpty()) return false;
+    FrameRect r = rect.ClampTo(m_width, m_height);
+    if (r.IsEmpty()) return false;
+
+    uint64_t sum, sumSq;
+    RectSums(r.x, r.y, r.x + r.width, r.y + r.height, sum, sumSq);
+
+    double n = static_cast<double>(r.width) * r.height;
+    double m = static_cast<double>(sum) / n;
+    if (mean) *mean = m;
+    if (variance) *variance = std::max(0.0, static_cast<double>(sumSq) / n - m * m);
+    return true;
+}
+
+void IntegralImage::QueryBatch(const FrameRect* rects, size_t count, float* means, float* variances) const
+{
+    for (size_t i = 0; i < count; i++) {
+        double mean = 0, variance = 0;
+        Query(rects[i], &mean, &variance);
+        if (means) means[i] = static_cast<float>(mean);
+        if (variances) variances[i] = static_cast<float>(variance);
+    }
+}
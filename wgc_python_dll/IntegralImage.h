@@ -0,0 +1,49 @@
+#pragma once
+#include "FrameView.h"
+#include <vector>
+
+// 亮度 (B*29 + G*150 + R*77) >> 8 的积分图, 同时维护和与平方和, 任意矩形的均值/方差为 O(1) 查询
+// 按 kBandRows 行分条带存储: 条带内保存局部积分图, 条带边界上保存全局列前缀和,
+// 角点值 = 边界前缀 + 局部值. 帧内容变化时只重算变化的条带, 以及其后各条带边界上变化列右侧的部分
+class IntegralImage
+{
+public:
+    static constexpr int kBandRows = 16;
+
+    // 与上一帧亮度逐行比较找出变化区域; 返回重算的条带数, 尺寸变化时整帧重建
+    int Update(const FrameView& frame);
+    // 调用方已知变化区域时只转换这些区域, 其余像素视为未变化 (首帧或尺寸变化时仍整帧重建)
+    int Update(const FrameView& frame, const FrameRect* dirtyRects, size_t count);
+    void Clear();
+
+    bool IsEmpty() const { return m_width == 0 || m_height == 0; }
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    // rect 按 FrameRect::ClampTo 裁剪 (宽高 <= 0 表示整帧); 裁剪后为空返回 false
+    bool Query(const FrameRect& rect, double* mean, double* variance) const;
+    // 裁剪后为空的区域输出 0
+    void QueryBatch(const FrameRect* rects, size_t count, float* means, float* variances) const;
+
+private:
+    bool Resize(int width, int height);
+    void MarkChanged(int y, int x);
+    void RebuildChanged();
+    // 行 [0, y) 与列 [0, x) 范围内的和
+    void Corner(int y, int x, uint32_t& sum, uint64_t& sumSq) const;
+    void RectSums(int x0, int y0, int x1, int y1, uint64_t& sum, uint64_t& sumSq) const;
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_bands = 0;
+    size_t m_stride = 0; // 每行 width + 1 项
+    std::vector<uint8_t> m_luma;
+    std::vector<uint8_t> m_row;
+    // 和用 uint32 按 2^32 取模累计, 单个矩形内的和不超过 2^32 时相减结果仍精确
+    std::vector<uint32_t> m_local;
+    std::vector<uint64_t> m_localSq;
+    std::vector<uint32_t> m_prefix;
+    std::vector<uint64_t> m_prefixSq;
+    // 各条带最左侧的变化列, 未变化为 INT_MAX
+    std::vector<int> m_bandMinX;
+};
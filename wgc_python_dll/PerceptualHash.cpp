@@ -0,0 +1,109 @@
+#include "PerceptualHash.h"
+#include <bit>
+
+namespace
+{
+    constexpr int kHashWidth = 9;
+    constexpr int kHashHeight = 8;
+    // 每个格子最多采样 16x16 个像素, 4K 帧也只读取约 1.8 万个像素
+    constexpr int kMaxSamplesPerAxis = 16;
+
+    inline uint32_t Luma(const uint8_t* bgra)
+    {
+        return (bgra[0] * 29u + bgra[1] * 150u + bgra[2] * 77u) >> 8;
+    }
+
+    uint32_t CellAverage(const FrameView& frame, int x0, int x1, int y0, int y1)
+    {
+        int stepX = (x1 - x0 + kMaxSamplesPerAxis - 1) / kMaxSamplesPerAxis;
+        int stepY = (y1 - y0 + kMaxSamplesPerAxis - 1) / kMaxSamplesPerAxis;
+        if (stepX < 1) stepX = 1;
+        if (stepY < 1) stepY = 1;
+
+        uint32_t sum = 0;
+        uint32_t count = 0;
+        for (int y = y0; y < y1; y += stepY) {
+            const uint8_t* row = frame.Row(y);
+            for (int x = x0; x < x1; x += stepX) {
+                sum += Luma(row + x * 4);
+                count++;
+            }
+        }
+        return count ? sum / count : 0;
+    }
+}
+
+uint64_t ComputeDHash(const FrameView& frame)
+{
+    if (!frame.IsValid()) return 0;
+
+    uint32_t cells[kHashHeight][kHashWidth];
+    for (int cy = 0; cy < kHashHeight; cy++) {
+        int y0 = cy * frame.height / kHashHeight;
+        int y1 = (cy + 1) * frame.height / kHashHeight;
+        if (y1 <= y0) y1 = y0 + 1;
+        for (int cx = 0; cx < kHashWidth; cx++) {
+            int x0 = cx * frame.width / kHashWidth;
+            int x1 = (cx + 1) * frame.width / kHashWidth;
+            if (x1 <= x0) x1 = x0 + 1;
+            cells[cy][cx] = CellAverage(frame, x0, x1, y0, y1);
+        }
+    }
+
+    uint64_t hash = 0;
+    for (int cy = 0; cy < kHashHeight; cy++) {
+        for (int cx = 0; cx < kHashWidth - 1; cx++) {
+            hash <<= 1;
+            if (cells[cy][cx] > cells[cy][cx + 1]) hash |= 1;
+        }
+    }
+    return hash;
+}
+
+int HammingDistance(uint64_t a, uint64_t b)
+{
+    return std::popcount(a ^ b);
+}
+
+void HashIndex::Add(const std::string& label, uint64_t hash)
+{
+    m_hashes.push_back(hash);
+    m_labels.push_back(label);
+}
+
+int HashIndex::Remove(const std::string& label)
+{
+    int removed = 0;
+    for (size_t i = 0; i < m_labels.size();) {
+        if (m_labels[i] == label) {
+            m_hashes.erase(m_hashes.begin() + i);
+            m_labels.erase(m_labels.begin() + i);
+            removed++;
+        } else {
+            i++;
+        }
+    }
+    return removed;
+}
+
+void HashIndex::Clear()
+{
+    m_hashes.clear();
+    m_labels.clear();
+}
+
+int HashIndex::FindNearest(uint64_t hash, int* outDistance) const
+{
+    int best = -1;
+    int bestDistance = 65;
+    for (size_t i = 0; i < m_hashes.size(); i++) {
+        int d = std::popcount(m_hashes[i] ^ hash);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = static_cast<int>(i);
+            if (d == 0) break;
+        }
+    }
+    if (outDistance) *outDistance = best >= 0 ? bestDistance : -1;
+    return best;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "FrameView.h"
+#include <string>
+#include <vector>
+
+// 64 位 dHash: 将帧缩小为 9x8 灰度图, 比较水平相邻像素的亮度
+uint64_t ComputeDHash(const FrameView& frame);
+
+int HammingDistance(uint64_t a, uint64_t b);
+
+// 带标签的参考哈希索引, 按汉明距离查找最接近的画面
+class HashIndex
+{
+public:
+    void Add(const std::string& label, uint64_t hash);
+    int Remove(const std::string& label);
+    void Clear();
+    size_t Size() const { return m_hashes.size(); }
+
+    // 返回最佳匹配的下标, 索引为空时返回 -1
+    int FindNearest(uint64_t hash, int* outDistance) const;
+    const std::string& LabelAt(int index) const { return m_labels[index]; }
+
+private:
+    std::vector<uint64_t> m_hashes;
+    std::vector<std::string> m_labels;
+};
@@ -0,0 +1,231 @@
+#include "ReadbackPipeline.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    template <int Format> struct FormatTraits;
+    template <> struct FormatTraits<PipelineBGRA> { static constexpr int Channels = 4; };
+    template <> struct FormatTraits<PipelineBGR> { static constexpr int Channels = 3; };
+    template <> struct FormatTraits<PipelineGray> { static constexpr int Channels = 1; };
+
+    template <int Format> void ConvertRow(const uint8_t* bgra, uint8_t* dst, int width);
+
+    template <>
+    void ConvertRow<PipelineBGRA>(const uint8_t* bgra, uint8_t* dst, int width)
+    {
+        memcpy(dst, bgra, static_cast<size_t>(width) * 4);
+    }
+
+    template <>
+    void ConvertRow<PipelineBGR>(const uint8_t* bgra, uint8_t* dst, int width)
+    {
+        for (int x = 0; x < width; x++) {
+            dst[x * 3 + 0] = bgra[x * 4 + 0];
+            dst[x * 3 + 1] = bgra[x * 4 + 1];
+            dst[x * 3 + 2] = bgra[x * 4 + 2];
+        }
+    }
+
+    template <>
+    void ConvertRow<PipelineGray>(const uint8_t* bgra, uint8_t* dst, int width)
+    {
+        ConvertRowToLuma(bgra, dst, width);
+    }
+
+    // 先逐行竖向累加 (连续内存, 便于向量化), 攒够 Scale 行后再横向合并求均值
+    void AccumulateRow(const uint8_t* row, uint16_t* acc, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            acc[i] = static_cast<uint16_t>(acc[i] + row[i]);
+        }
+    }
+
+    template <int Scale, int Channels>
+    void ResolveRow(const uint16_t* acc, uint8_t* dst, int outWidth)
+    {
+        constexpr int area = Scale * Scale;
+        for (int x = 0; x < outWidth; x++) {
+            const uint16_t* src = acc + x * Scale * Channels;
+            for (int c = 0; c < Channels; c++) {
+                int sum = 0;
+                for (int k = 0; k < Scale; k++) sum += src[k * Channels + c];
+                dst[x * Channels + c] = static_cast<uint8_t>((sum + area / 2) / area);
+            }
+        }
+    }
+
+    template <int Channels>
+    void HistogramRow(const uint8_t* row, int width, uint32_t (*histogram)[256])
+    {
+        for (int x = 0; x < width; x++) {
+            for (int c = 0; c < Channels; c++) {
+                histogram[c][row[x * Channels + c]]++;
+            }
+        }
+    }
+
+    void FinalizeStats(FrameStatistics& stats, int channels, uint64_t pixelCount)
+    {
+        stats.pixelCount = pixelCount;
+        for (int c = 0; c < channels; c++) {
+            uint64_t sum = 0;
+            int lo = -1, hi = -1;
+            for (int v = 0; v < 256; v++) {
+                uint32_t n = stats.histogram[c][v];
+                if (!n) continue;
+                sum += static_cast<uint64_t>(n) * v;
+                if (lo < 0) lo = v;
+                hi = v;
+            }
+            stats.sum[c] = sum;
+            stats.minValue[c] = static_cast<uint8_t>(lo < 0 ? 0 : lo);
+            stats.maxValue[c] = static_cast<uint8_t>(hi < 0 ? 0 : hi);
+        }
+    }
+
+    struct PipelineContext
+    {
+        const FrameView& source;
+        const HdrConverter* hdr;
+        const PipelineLayout& layout;
+        uint8_t* output;
+        FrameStatistics* stats;
+    };
+
+    template <int Format, int Scale, bool Stats>
+    void PipelineKernel(const PipelineContext& ctx)
+    {
+        constexpr int channels = FormatTraits<Format>::Channels;
+        const PipelineLayout& layout = ctx.layout;
+        const int outWidth = layout.width;
+        const int srcWidth = outWidth * Scale;
+        const size_t outRowBytes = static_cast<size_t>(outWidth) * channels;
+        const size_t pixelBytes = ctx.hdr ? 8 : 4;
+
+        // 中间行只有一两行, 始终在缓存中
+        std::vector<uint8_t> bgraRow(ctx.hdr && Format == PipelineGray ? static_cast<size_t>(srcWidth) * 4 : 0);
+        std::vector<uint8_t> convertedRow(Scale > 1 ? static_cast<size_t>(srcWidth) * channels : 0);
+        std::vector<uint16_t> acc(Scale > 1 ? convertedRow.size() : 0);
+
+        if constexpr (Stats) *ctx.stats = FrameStatistics();
+
+        auto convert = [&](int y, uint8_t* dst) {
+            const uint8_t* src = ctx.source.Row(layout.crop.y + y) + static_cast<size_t>(layout.crop.x) * pixelBytes;
+            if (!ctx.hdr) {
+                ConvertRow<Format>(src, dst, srcWidth);
+            } else if constexpr (Format == PipelineGray) {
+                ctx.hdr->ConvertRow(reinterpret_cast<const uint16_t*>(src), bgraRow.data(), srcWidth, 4);
+                ConvertRow<Format>(bgraRow.data(), dst, srcWidth);
+            } else {
+                ctx.hdr->ConvertRow(reinterpret_cast<const uint16_t*>(src), dst, srcWidth, channels);
+            }
+        };
+
+        for (int y = 0; y < layout.height; y++) {
+            uint8_t* dst = ctx.output + y * outRowBytes;
+
+            if constexpr (Scale == 1) {
+                convert(y, dst);
+            } else {
+                std::fill(acc.begin(), acc.end(), static_cast<uint16_t>(0));
+                for (int k = 0; k < Scale; k++) {
+                    convert(y * Scale + k, convertedRow.data());
+                    AccumulateRow(convertedRow.data(), acc.data(), convertedRow.size());
+                }
+                ResolveRow<Scale, channels>(acc.data(), dst, outWidth);
+            }
+
+            if constexpr (Stats) HistogramRow<channels>(dst, outWidth, ctx.stats->histogram);
+        }
+
+        if constexpr (Stats) {
+            FinalizeStats(*ctx.stats, channels, static_cast<uint64_t>(outWidth) * layout.height);
+        }
+    }
+
+    using PipelineFn = void (*)(const PipelineContext&);
+
+    // 预先实例化的组合: [格式][缩放 1/2/4][统计]
+    constexpr PipelineFn kPipelines[3][3][2] = {
+        {
+            { PipelineKernel<PipelineBGRA, 1, false>, PipelineKernel<PipelineBGRA, 1, true> },
+            { PipelineKernel<PipelineBGRA, 2, false>, PipelineKernel<PipelineBGRA, 2, true> },
+            { PipelineKernel<PipelineBGRA, 4, false>, PipelineKernel<PipelineBGRA, 4, true> },
+        },
+        {
+            { PipelineKernel<PipelineBGR, 1, false>, PipelineKernel<PipelineBGR, 1, true> },
+            { PipelineKernel<PipelineBGR, 2, false>, PipelineKernel<PipelineBGR, 2, true> },
+            { PipelineKernel<PipelineBGR, 4, false>, PipelineKernel<PipelineBGR, 4, true> },
+        },
+        {
+            { PipelineKernel<PipelineGray, 1, false>, PipelineKernel<PipelineGray, 1, true> },
+            { PipelineKernel<PipelineGray, 2, false>, PipelineKernel<PipelineGray, 2, true> },
+            { PipelineKernel<PipelineGray, 4, false>, PipelineKernel<PipelineGray, 4, true> },
+        },
+    };
+
+    int ScaleIndex(int scale)
+    {
+        switch (scale) {
+        case 1: return 0;
+        case 2: return 1;
+        case 4: return 2;
+        default: return -1;
+        }
+    }
+}
+
+void ConvertRowToLuma(const uint8_t* bgra, uint8_t* dst, int width)
+{
+    int x = 0;
+#ifdef WGC_HAS_SSE2
+    // madd 得到每像素 (B*29 + G*150, R*77) 两项, 相邻相加后收拢为 4 个 32 位结果
+    const __m128i weights = _mm_setr_epi16(29, 150, 77, 0, 29, 150, 77, 0);
+    const __m128i zero = _mm_setzero_si128();
+    for (; x + 4 <= width; x += 4) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + x * 4));
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), weights);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), weights);
+        lo = _mm_add_epi32(lo, _mm_srli_epi64(lo, 32));
+        hi = _mm_add_epi32(hi, _mm_srli_epi64(hi, 32));
+        lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+        hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+        __m128i luma = _mm_srli_epi32(_mm_unpacklo_epi64(lo, hi), 8);
+        luma = _mm_packs_epi32(luma, luma);
+        luma = _mm_packus_epi16(luma, luma);
+        int packed = _mm_cvtsi128_si32(luma);
+        memcpy(dst + x, &packed, 4);
+    }
+#endif
+    for (; x < width; x++) {
+        dst[x] = static_cast<uint8_t>((bgra[x * 4] * 29 + bgra[x * 4 + 1] * 150 + bgra[x * 4 + 2] * 77) >> 8);
+    }
+}
+
+bool ComputePipelineLayout(int sourceWidth, int sourceHeight, const PipelineRequest& request, PipelineLayout& layout)
+{
+    if (request.format < PipelineBGRA || request.format > PipelineGray || ScaleIndex(request.scale) < 0) {
+        return false;
+    }
+
+    layout.crop = request.crop.ClampTo(sourceWidth, sourceHeight);
+    layout.width = layout.crop.width / request.scale;
+    layout.height = layout.crop.height / request.scale;
+    layout.channels = request.format == PipelineBGRA ? 4 : request.format == PipelineBGR ? 3 : 1;
+    layout.bytes = static_cast<size_t>(layout.width) * layout.height * layout.channels;
+    return layout.width > 0 && layout.height > 0;
+}
+
+void RunPipeline(const FrameView& source, const HdrConverter* hdr, const PipelineRequest& request,
+    const PipelineLayout& layout, uint8_t* output, FrameStatistics* stats)
+{
+    bool withStats = request.stats && stats;
+    PipelineFn fn = kPipelines[request.format][ScaleIndex(request.scale)][withStats ? 1 : 0];
+    fn({ source, hdr, layout, output, stats });
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "FrameView.h"
+#include "FrameStats.h"
+#include "HdrConvert.h"
+
+// 融合读回流水线: 裁剪 -> 格式转换 -> 整数倍缩小 -> 统计, 一遍走完映射纹理
+// 每种 (格式, 缩放, 统计) 组合都是独立特化的行内核, 预先实例化后按参数查表选择
+enum PipelineFormat
+{
+    PipelineBGRA = 0,
+    PipelineBGR = 1,
+    PipelineGray = 2, // (B*29 + G*150 + R*77) >> 8
+};
+
+struct PipelineRequest
+{
+    FrameRect crop;          // 宽高 <= 0 表示整帧
+    int format = PipelineBGRA;
+    int scale = 1;           // 1, 2, 4 (块均值), 不足一块的边缘丢弃
+    bool stats = false;      // 对输出计算直方图/总和/最值 (通道数与输出一致)
+};
+
+struct PipelineLayout
+{
+    FrameRect crop;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    size_t bytes = 0;        // 输出无行填充
+};
+
+// 单行 BGRA 转亮度 (SSE2), 与 PipelineGray 输出一致
+void ConvertRowToLuma(const uint8_t* bgra, uint8_t* luma, int width);
+
+bool ComputePipelineLayout(int sourceWidth, int sourceHeight, const PipelineRequest& request, PipelineLayout& layout);
+
+// hdr 非空时 source 为 RGBA16F, 只对裁剪范围内的列做色调映射
+void RunPipeline(const FrameView& source, const HdrConverter* hdr, const PipelineRequest& request,
+    const PipelineLayout& layout, uint8_t* output, FrameStatistics* stats);
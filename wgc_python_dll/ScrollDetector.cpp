@@ -0,0 +1,494 @@
+#include "ScrollDetector.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // 每个 32 位通道: h = ((h ^ px) * kPrime) ^ (... >> 15), 每步都是双射,
+    // 同一通道内只差一个像素的两行哈希必然不同
+    constexpr uint32_t kPrime = 0x9E3779B1u;
+    constexpr uint32_t kSeed = 0x811C9DC5u;
+    constexpr uint32_t kLaneStep = 0x27D4EB2Fu;
+    constexpr uint32_t kColorMask = 0x00FFFFFFu;
+
+    inline uint32_t MixScalar(uint32_t h, uint32_t px)
+    {
+        h = (h ^ (px & kColorMask)) * kPrime;
+        return h ^ (h >> 15);
+    }
+
+    inline uint32_t LoadPixel(const uint8_t* p)
+    {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline uint64_t Fmix64(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        return h ^ (h >> 33);
+    }
+
+#ifdef WGC_HAS_SSE2
+    // SSE2 没有 32 位低位乘法, 用两次 _mm_mul_epu32 拼出
+    inline __m128i MulLo32(__m128i a, __m128i b)
+    {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    inline __m128i MixLanes(__m128i h, __m128i px, __m128i prime, __m128i mask)
+    {
+        h = MulLo32(_mm_xor_si128(h, _mm_and_si128(px, mask)), prime);
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+    }
+#endif
+
+    // 行哈希: 4 个通道分别累积 x % 4 相同的像素; 列哈希: 每列一个通道沿 y 累积
+    template <bool Rows, bool Columns>
+    void HashLines(const FrameView& frame, const FrameRect& roi, uint64_t* rows, uint32_t* columns)
+    {
+        const uint32_t laneSeed[4] = { kSeed, kSeed + kLaneStep, kSeed + kLaneStep * 2, kSeed + kLaneStep * 3 };
+        if (Columns) std::fill(columns, columns + roi.width, kSeed);
+
+        for (int y = 0; y < roi.height; y++) {
+            const uint8_t* src = frame.Row(roi.y + y) + static_cast<size_t>(roi.x) * 4;
+            uint32_t lanes[4] = { laneSeed[0], laneSeed[1], laneSeed[2], laneSeed[3] };
+            int x = 0;
+#ifdef WGC_HAS_SSE2
+            const __m128i prime = _mm_set1_epi32(static_cast<int>(kPrime));
+            const __m128i mask = _mm_set1_epi32(static_cast<int>(kColorMask));
+            __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+            for (; x + 4 <= roi.width; x += 4) {
+                __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+                if (Rows) acc = MixLanes(acc, px, prime, mask);
+                if (Columns) {
+                    __m128i* col = reinterpret_cast<__m128i*>(columns + x);
+                    _mm_storeu_si128(col, MixLanes(_mm_loadu_si128(col), px, prime, mask));
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+#endif
+            for (; x < roi.width; x++) {
+                uint32_t px = LoadPixel(src + x * 4);
+                if (Rows) lanes[x & 3] = MixScalar(lanes[x & 3], px);
+                if (Columns) columns[x] = MixScalar(columns[x], px);
+            }
+
+            if (Rows) {
+                uint64_t h = 0x243F6A8885A308D3ull ^ static_cast<uint64_t>(roi.width);
+                for (uint32_t lane : lanes) {
+                    h = (h ^ lane) * 0x9E3779B97F4A7C15ull;
+                    h ^= h >> 32;
+                }
+                rows[y] = h;
+            }
+        }
+    }
+
+    struct AxisMatch
+    {
+        int offset = 0;
+        float confidence = 0;
+        int begin = 0; // 当前帧中与上一帧对齐的区间 [begin, end)
+        int end = 0;
+    };
+
+    // 只保留在本帧中唯一的哈希 (空白行、重复的分隔线等不参与投票)
+    void CollectUnique(const std::vector<uint64_t>& hashes, std::vector<std::pair<uint64_t, int>>& out)
+    {
+        std::vector<std::pair<uint64_t, int>> sorted;
+        sorted.reserve(hashes.size());
+        for (size_t i = 0; i < hashes.size(); i++) sorted.emplace_back(hashes[i], static_cast<int>(i));
+        std::sort(sorted.begin(), sorted.end());
+
+        out.clear();
+        for (size_t i = 0; i < sorted.size();) {
+            size_t j = i + 1;
+            while (j < sorted.size() && sorted[j].first == sorted[i].first) j++;
+            if (j == i + 1) out.push_back(sorted[i]);
+            i = j;
+        }
+    }
+
+    // 每个在两帧中都唯一的哈希为偏移 (上一帧位置 - 当前位置) 投一票
+    // 静止的标题栏/状态栏投给 0, 因此非零偏移只需在移动的行中占多数即可胜出
+    bool MatchAxis(const std::vector<uint64_t>& prev, const std::vector<uint64_t>& cur, int maxOffset, AxisMatch& match)
+    {
+        int n = static_cast<int>(cur.size());
+        if (n == 0 || prev.size() != cur.size()) return false;
+
+        int limit = maxOffset > 0 ? std::min(maxOffset, n - 1) : n - 1;
+
+        std::vector<std::pair<uint64_t, int>> prevUnique, curUnique;
+        CollectUnique(prev, prevUnique);
+        CollectUnique(cur, curUnique);
+
+        std::vector<int> votes(static_cast<size_t>(limit) * 2 + 1, 0);
+        std::vector<std::pair<int, int>> pairs; // (当前位置, 偏移)
+        size_t i = 0, j = 0;
+        while (i < prevUnique.size() && j < curUnique.size()) {
+            if (prevUnique[i].first < curUnique[j].first) {
+                i++;
+            } else if (curUnique[j].first < prevUnique[i].first) {
+                j++;
+            } else {
+                int offset = prevUnique[i].second - curUnique[j].second;
+                if (offset >= -limit && offset <= limit) {
+                    votes[offset + limit]++;
+                    pairs.emplace_back(curUnique[j].second, offset);
+                }
+                i++;
+                j++;
+            }
+        }
+
+        int total = static_cast<int>(pairs.size());
+        int zeroVotes = votes[limit];
+        int best = 0, bestVotes = 0;
+        for (int offset = 1; offset <= limit; offset++) {
+            // 票数相同时取绝对值较小的偏移
+            for (int signedOffset : { offset, -offset }) {
+                if (votes[signedOffset + limit] > bestVotes) {
+                    best = signedOffset;
+                    bestVotes = votes[signedOffset + limit];
+                }
+            }
+        }
+
+        int minVotes = std::clamp(n / 32, 2, 8);
+        int moving = total - zeroVotes;
+        if (bestVotes >= minVotes && bestVotes * 2 > moving) {
+            match.offset = best;
+            match.confidence = static_cast<float>(bestVotes) / moving;
+        } else if (zeroVotes > 0) {
+            match.offset = 0;
+            match.confidence = static_cast<float>(zeroVotes) / total;
+        } else {
+            return false;
+        }
+
+        int begin = n, end = 0;
+        for (const auto& [pos, offset] : pairs) {
+            if (offset != match.offset) continue;
+            begin = std::min(begin, pos);
+            end = std::max(end, pos + 1);
+        }
+        // 非唯一的行 (空白行等) 只要按该偏移对得上也并入对齐区间
+        int offset = match.offset;
+        while (begin > 0 && begin - 1 + offset >= 0 && cur[begin - 1] == prev[begin - 1 + offset]) begin--;
+        while (end < n && end + offset < n && cur[end] == prev[end + offset]) end++;
+        match.begin = begin;
+        match.end = end;
+        return true;
+    }
+
+    // 新露出的区间 (沿该轴的当前帧坐标)
+    std::pair<int, int> ExposedRange(const AxisMatch& match)
+    {
+        if (match.offset > 0) return { match.end, match.end + match.offset };
+        if (match.offset < 0) return { match.begin + match.offset, match.begin };
+        return { 0, 0 };
+    }
+}
+
+void ComputeLineHashes(const FrameView& frame, const FrameRect& roi,
+    std::vector<uint64_t>* rowHashes, std::vector<uint64_t>* columnHashes)
+{
+    if (rowHashes) rowHashes->assign(roi.height > 0 ? roi.height : 0, 0);
+    if (columnHashes) columnHashes->assign(roi.width > 0 ? roi.width : 0, 0);
+    if (!frame.IsValid() || roi.IsEmpty()) return;
+
+    uint64_t* rows = rowHashes ? rowHashes->data() : nullptr;
+    std::vector<uint32_t> columns(columnHashes ? roi.width : 0);
+
+    if (rows && columnHashes) {
+        HashLines<true, true>(frame, roi, rows, columns.data());
+    } else if (rows) {
+        HashLines<true, false>(frame, roi, rows, nullptr);
+    } else if (columnHashes) {
+        HashLines<false, true>(frame, roi, nullptr, columns.data());
+    }
+
+    if (columnHashes) {
+        uint64_t salt = static_cast<uint64_t>(roi.height) << 32;
+        for (int x = 0; x < roi.width; x++) (*columnHashes)[x] = Fmix64(columns[x] ^ salt);
+    }
+}
+
+ScrollResult MatchScroll(const std::vector<uint64_t>& prevRows, const std::vector<uint64_t>& curRows,
+    const std::vector<uint64_t>& prevColumns, const std::vector<uint64_t>& curColumns,
+    const FrameRect& roi, int maxOffset)
+{
+    ScrollResult result;
+    AxisMatch vertical, horizontal;
+    bool hasVertical = !curRows.empty() && MatchAxis(prevRows, curRows, maxOffset, vertical);
+    bool hasHorizontal = !curColumns.empty() && MatchAxis(prevColumns, curColumns, maxOffset, horizontal);
+
+    bool movedVertical = hasVertical && vertical.offset != 0;
+    bool movedHorizontal = hasHorizontal && horizontal.offset != 0;
+    if (movedVertical && movedHorizontal) {
+        // 同一帧只报告一个轴的滚动, 取更可信的一个
+        if (vertical.confidence >= horizontal.confidence) {
+            movedHorizontal = false;
+        } else {
+            movedVertical = false;
+        }
+    }
+
+    if (movedVertical) {
+        auto [begin, end] = ExposedRange(vertical);
+        result.dy = vertical.offset;
+        result.confidence = vertical.confidence;
+        result.newBand = { roi.x, roi.y + begin, roi.width, end - begin };
+    } else if (movedHorizontal) {
+        auto [begin, end] = ExposedRange(horizontal);
+        result.dx = horizontal.offset;
+        result.confidence = horizontal.confidence;
+        result.newBand = { roi.x + begin, roi.y, end - begin, roi.height };
+    } else if (hasVertical || hasHorizontal) {
+        result.confidence = std::max(hasVertical ? vertical.confidence : 0.0f,
+            hasHorizontal ? horizontal.confidence : 0.0f);
+    }
+    return result;
+}
+
+ScrollResult DetectScroll(const FrameView& previous, const FrameView& current, const FrameRect& roi,
+    int axes, int maxOffset)
+{
+    if (!previous.IsValid() || !current.IsValid() ||
+        previous.width != current.width || previous.height != current.height || roi.IsEmpty()) {
+        return {};
+    }
+
+    std::vector<uint64_t> prevRows, curRows, prevColumns, curColumns;
+    bool rows = (axes & ScrollAxisVertical) != 0;
+    bool columns = (axes & ScrollAxisHorizontal) != 0;
+    ComputeLineHashes(previous, roi, rows ? &prevRows : nullptr, columns ? &prevColumns : nullptr);
+    ComputeLineHashes(current, roi, rows ? &curRows : nullptr, columns ? &curColumns : nullptr);
+    return MatchScroll(prevRows, curRows, prevColumns, curColumns, roi, maxOffset);
+}
+
+void ScrollStitcher::Reset()
+{
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+    m_width = 0;
+    m_height = 0;
+    m_originX = 0;
+    m_originY = 0;
+    m_viewX = 0;
+    m_viewY = 0;
+    m_truncated = false;
+}
+
+bool ScrollStitcher::Apply(const FrameView& frame, const FrameRect& roi, const ScrollResult& scroll)
+{
+    if (!frame.IsValid() || roi.IsEmpty()) return false;
+
+    if (IsEmpty()) {
+        m_viewX = 0;
+        m_viewY = 0;
+        if (!EnsureBounds(0, 0, roi.width, roi.height)) {
+            m_truncated = true;
+            return false;
+        }
+        Blit(frame, roi, 0, 0);
+        return true;
+    }
+
+    m_viewX += scroll.dx;
+    m_viewY += scroll.dy;
+    const FrameRect& band = scroll.newBand;
+    if (band.IsEmpty()) return true;
+
+    int64_t worldX = m_viewX + (band.x - roi.x);
+    int64_t worldY = m_viewY + (band.y - roi.y);
+    if (!EnsureBounds(worldX, worldY, worldX + band.width, worldY + band.height)) {
+        m_truncated = true;
+        return false;
+    }
+    Blit(frame, band, worldX, worldY);
+    return true;
+}
+
+bool ScrollStitcher::EnsureBounds(int64_t x0, int64_t y0, int64_t x1, int64_t y1)
+{
+    int64_t nx0 = std::min(m_originX, x0);
+    int64_t ny0 = std::min(m_originY, y0);
+    int64_t nx1 = std::max(m_originX + m_width, x1);
+    int64_t ny1 = std::max(m_originY + m_height, y1);
+    if (IsEmpty()) {
+        nx0 = x0;
+        ny0 = y0;
+        nx1 = x1;
+        ny1 = y1;
+    }
+
+    int64_t newWidth = nx1 - nx0;
+    int64_t newHeight = ny1 - ny0;
+    if (!IsEmpty() && nx0 == m_originX && ny0 == m_originY && newWidth == m_width && newHeight == m_height) {
+        return true;
+    }
+    if (static_cast<uint64_t>(newWidth) * static_cast<uint64_t>(newHeight) * 4 > m_maxBytes) return false;
+
+    size_t newRowBytes = static_cast<size_t>(newWidth) * 4;
+    if (!IsEmpty() && nx0 == m_originX && ny0 == m_originY && newWidth == m_width) {
+        // 向下扩展 (最常见的向下滚动) 直接追加, 由 vector 摊销
+        m_pixels.resize(newRowBytes * newHeight, 0);
+    } else {
+        std::vector<uint8_t> pixels(newRowBytes * newHeight, 0);
+        size_t oldRowBytes = static_cast<size_t>(m_width) * 4;
+        size_t offsetX = static_cast<size_t>(m_originX - nx0) * 4;
+        size_t offsetY = static_cast<size_t>(m_originY - ny0);
+        for (int y = 0; y < m_height; y++) {
+            memcpy(pixels.data() + (offsetY + y) * newRowBytes + offsetX,
+                m_pixels.data() + y * oldRowBytes, oldRowBytes);
+        }
+        m_pixels.swap(pixels);
+    }
+
+    m_originX = nx0;
+    m_originY = ny0;
+    m_width = static_cast<int>(newWidth);
+    m_height = static_cast<int>(newHeight);
+    return true;
+}
+
+void ScrollStitcher::Blit(const FrameView& frame, const FrameRect& rect, int64_t worldX, int64_t worldY)
+{
+    size_t rowBytes = static_cast<size_t>(m_width) * 4;
+    size_t copyBytes = static_cast<size_t>(rect.width) * 4;
+    size_t dstX = static_cast<size_t>(worldX - m_originX) * 4;
+    size_t dstY = static_cast<size_t>(worldY - m_originY);
+    for (int y = 0; y < rect.height; y++) {
+        memcpy(m_pixels.data() + (dstY + y) * rowBytes + dstX,
+            frame.Row(rect.y + y) + static_cast<size_t>(rect.x) * 4, copyBytes);
+    }
+}
+
+ScrollTracker::ScrollTracker(const FrameRect& roi, int axes, bool stitch, size_t maxStitchBytes, int maxLostFrames)
+    : m_roi(roi), m_axes(axes), m_stitch(stitch),
+      m_maxLostFrames(maxLostFrames > 0 ? maxLostFrames : kDefaultMaxLostFrames), m_stitcher(maxStitchBytes),
+      m_finished(maxStitchBytes)
+{
+}
+
+void ScrollTracker::Restart(const FrameView& frame, const FrameRect& roi, int64_t timestampMs)
+{
+    int restarts = m_state.restarts;
+    int canvasResets = m_state.canvasResets;
+    m_state = ScrollState{};
+    m_state.restarts = restarts;
+    m_state.canvasResets = canvasResets;
+    m_state.timestampMs = timestampMs;
+
+    // 已拼接的画布留给调用方取走, 不随参考帧一起丢弃
+    if (!m_stitcher.IsEmpty()) {
+        if (!m_finished.IsEmpty()) m_state.canvasResets++;
+        std::swap(m_finished, m_stitcher);
+    }
+    m_stitcher.Reset();
+    if (m_stitch) m_stitcher.Apply(frame, roi, ScrollResult{});
+    m_refRows.swap(m_rows);
+    m_refColumns.swap(m_columns);
+    m_refRoi = roi;
+    m_hasReference = true;
+}
+
+void ScrollTracker::Submit(const FrameView& frame, int64_t timestampMs)
+{
+    if (!frame.IsValid()) return;
+
+    FrameRect roi = m_roi.ClampTo(frame.width, frame.height);
+    if (roi.IsEmpty()) return;
+
+    // 只在监听线程上调用, 哈希计算不需要持锁
+    ComputeLineHashes(frame, roi,
+        (m_axes & ScrollAxisVertical) ? &m_rows : nullptr,
+        (m_axes & ScrollAxisHorizontal) ? &m_columns : nullptr);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_hasReference) {
+        Restart(frame, roi, timestampMs);
+        return;
+    }
+    if (roi.width != m_refRoi.width || roi.height != m_refRoi.height) {
+        m_state.restarts++;
+        Restart(frame, roi, timestampMs);
+        return;
+    }
+
+    ScrollResult result = MatchScroll(m_refRows, m_rows, m_refColumns, m_columns, roi);
+    m_state.last = result;
+    m_state.timestampMs = timestampMs;
+
+    if (result.confidence <= 0) {
+        // 过渡动画等导致无法对齐时保留参考帧, 后续帧仍与之比较;
+        // 连续丢失过多说明内容已整体替换 (页面跳转), 旧参考帧不会再对齐, 从当前帧重新开始
+        if (++m_state.lostFrames >= m_maxLostFrames) {
+            m_state.restarts++;
+            Restart(frame, roi, timestampMs);
+        }
+        return;
+    }
+
+    m_state.lostFrames = 0;
+    m_state.totalX += result.dx;
+    m_state.totalY += result.dy;
+    if (m_stitch) m_stitcher.Apply(frame, roi, result);
+
+    m_refRows.swap(m_rows);
+    m_refColumns.swap(m_columns);
+    m_refRoi = roi;
+}
+
+ScrollState ScrollTracker::State() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ScrollState state = m_state;
+    state.canvasPending = !m_finished.IsEmpty();
+    state.canvasTruncated = state.canvasPending ? m_finished.IsTruncated() : m_stitcher.IsTruncated();
+    return state;
+}
+
+bool ScrollTracker::CopyStitched(std::vector<uint8_t>& pixels, int* width, int* height) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_stitch || m_stitcher.IsEmpty()) return false;
+
+    pixels = m_stitcher.Pixels();
+    *width = m_stitcher.Width();
+    *height = m_stitcher.Height();
+    return true;
+}
+
+bool ScrollTracker::TakeStitched(std::vector<uint8_t>& pixels, int* width, int* height)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_finished.IsEmpty()) {
+        pixels = m_finished.Pixels();
+        *width = m_finished.Width();
+        *height = m_finished.Height();
+        m_finished.Reset();
+        return true;
+    }
+    if (!m_stitch || m_stitcher.IsEmpty()) return false;
+
+    pixels = m_stitcher.Pixels();
+    *width = m_stitcher.Width();
+    *height = m_stitcher.Height();
+    return true;
+}
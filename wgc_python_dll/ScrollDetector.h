@@ -0,0 +1,133 @@
+#pragma once
+#include "FrameView.h"
+#include <mutex>
+#include <vector>
+
+enum ScrollAxis
+{
+    ScrollAxisVertical = 1,
+    ScrollAxisHorizontal = 2,
+    ScrollAxisBoth = 3,
+};
+
+// 当前帧 (x, y) 处的内容等于上一帧 (x + dx, y + dy) 处的内容:
+// dy > 0 表示内容上移 (向下滚动), 新露出的区域在滚动区域底部; dx > 0 时在右侧
+struct ScrollResult
+{
+    int dx = 0;
+    int dy = 0;
+    // 支持该偏移的行(列)占参与投票的行(列)的比例; 0 表示两帧无法对齐
+    float confidence = 0;
+    // 当前帧中新露出的区域 (帧坐标), 未滚动时为空
+    FrameRect newBand;
+};
+
+// 逐行/逐列计算 ROI 内像素的哈希 (忽略 alpha), 一次遍历同时得到两者; 不需要的输出传 nullptr
+void ComputeLineHashes(const FrameView& frame, const FrameRect& roi,
+    std::vector<uint64_t>* rowHashes, std::vector<uint64_t>* columnHashes);
+
+// 由两帧同一 ROI 的行/列哈希估计滚动偏移, 哈希数组为空的轴不参与检测
+// maxOffset <= 0 表示不限制偏移量
+ScrollResult MatchScroll(const std::vector<uint64_t>& prevRows, const std::vector<uint64_t>& curRows,
+    const std::vector<uint64_t>& prevColumns, const std::vector<uint64_t>& curColumns,
+    const FrameRect& roi, int maxOffset = 0);
+
+// 两帧尺寸需一致; roi 已裁剪到帧范围内
+ScrollResult DetectScroll(const FrameView& previous, const FrameView& current, const FrameRect& roi,
+    int axes, int maxOffset = 0);
+
+// 增量拼接长图: 首帧 ROI 作为初始画布, 之后只把每帧新露出的区域写入画布
+// 坐标以首帧 ROI 左上角为原点, 向上/向左滚动时画布向负方向扩展
+class ScrollStitcher
+{
+public:
+    explicit ScrollStitcher(size_t maxBytes = 256ull * 1024 * 1024) : m_maxBytes(maxBytes) {}
+
+    void Reset();
+    // 超出内存上限时返回 false, 画布保持不变 (该区域丢失, 记为截断)
+    bool Apply(const FrameView& frame, const FrameRect& roi, const ScrollResult& scroll);
+
+    bool IsEmpty() const { return m_width == 0 || m_height == 0; }
+    // 自上次 Reset 以来是否有新露出的区域因内存上限未能写入
+    bool IsTruncated() const { return m_truncated; }
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    // 紧凑 BGRA
+    const std::vector<uint8_t>& Pixels() const { return m_pixels; }
+    // 当前视口 (ROI) 左上角相对首帧的位置
+    int64_t ViewportX() const { return m_viewX; }
+    int64_t ViewportY() const { return m_viewY; }
+
+private:
+    bool EnsureBounds(int64_t x0, int64_t y0, int64_t x1, int64_t y1);
+    void Blit(const FrameView& frame, const FrameRect& rect, int64_t worldX, int64_t worldY);
+
+    size_t m_maxBytes;
+    std::vector<uint8_t> m_pixels;
+    int m_width = 0;
+    int m_height = 0;
+    // 画布左上角的位置
+    int64_t m_originX = 0;
+    int64_t m_originY = 0;
+    int64_t m_viewX = 0;
+    int64_t m_viewY = 0;
+    bool m_truncated = false;
+};
+
+struct ScrollState
+{
+    ScrollResult last;
+    int64_t totalX = 0; // 累计偏移, 即视口相对首帧的位置
+    int64_t totalY = 0;
+    int64_t timestampMs = 0;
+    int lostFrames = 0; // 连续无法对齐的帧数
+    // 以当前帧重新作为参考帧的次数 (ROI 尺寸变化或连续丢失过多), 每次重新开始时拼接画布也从当前帧重建
+    int restarts = 0;
+    // 重新开始前的画布已保留, 等待 TakeStitched 取走
+    bool canvasPending = false;
+    // 下次 TakeStitched 返回的画布因内存上限缺失了部分区域
+    bool canvasTruncated = false;
+    // 未被取走就被更新的画布替换而丢弃的画布数
+    int canvasResets = 0;
+};
+
+// 在帧监听线程中逐帧检测滚动; 对齐失败时保留上一参考帧, 等待后续帧重新对齐
+// 连续 maxLostFrames 帧无法对齐 (页面跳转等) 或 ROI 尺寸变化 (窗口缩放) 时以当前帧重新开始
+// 重新开始时已拼接的画布保留到被取走 (另占最多 maxStitchBytes); 其间再次重新开始则丢弃较旧的一张 (canvasResets 加 1)
+class ScrollTracker
+{
+public:
+    static constexpr int kDefaultMaxLostFrames = 30;
+
+    // maxLostFrames <= 0 取 kDefaultMaxLostFrames
+    ScrollTracker(const FrameRect& roi, int axes, bool stitch, size_t maxStitchBytes,
+        int maxLostFrames = kDefaultMaxLostFrames);
+
+    void Submit(const FrameView& frame, int64_t timestampMs);
+
+    ScrollState State() const;
+    // 当前画布; 尚无画布或未开启拼接时返回 false
+    bool CopyStitched(std::vector<uint8_t>& pixels, int* width, int* height) const;
+    // 有保留的画布时取走并释放它, 否则复制当前画布
+    bool TakeStitched(std::vector<uint8_t>& pixels, int* width, int* height);
+
+private:
+    // 调用方持锁; 累计偏移清零, restarts 保留
+    void Restart(const FrameView& frame, const FrameRect& roi, int64_t timestampMs);
+
+    FrameRect m_roi;
+    int m_axes;
+    bool m_stitch;
+    int m_maxLostFrames;
+
+    mutable std::mutex m_mutex;
+    ScrollStitcher m_stitcher;
+    ScrollStitcher m_finished;
+    ScrollState m_state;
+    FrameRect m_refRoi;
+    std::vector<uint64_t> m_refRows;
+    std::vector<uint64_t> m_refColumns;
+    std::vector<uint64_t> m_rows;
+    std::vector<uint64_t> m_columns;
+    bool m_hasReference = false;
+};
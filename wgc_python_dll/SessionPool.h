@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct SessionPoolBudget
+{
+    size_t maxSessions = 8;                  // 池中空闲会话数上限 (每个占用一套捕获句柄)
+    size_t maxBytes = 512u * 1024 * 1024;    // 池中空闲会话的显存估算上限
+};
+
+struct SessionPoolStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
+// 按窗口保存已预热的暂停会话, 切换目标时取出恢复即可, 无需重建捕获项/帧池/纹理
+// 超出预算时按最近最少使用淘汰; 活动会话由调用方持有, 不计入预算
+// Session 需提供 PauseCapture(), ResumeCapture(), EstimatedMemoryBytes();
+// 真实实现为 WGCWindowCapture, 测试时可替换为模拟会话
+// 池中会话可能已失效 (窗口关闭, 句柄被复用), 命中时先经 validator 检查, 失效则丢弃 (计为淘汰) 并重建
+template <typename Session>
+class SessionPool
+{
+public:
+    using Factory = std::function<std::unique_ptr<Session>(uint64_t key, std::string* outError)>;
+    using Validator = std::function<bool(uint64_t key, Session& session)>;
+
+    explicit SessionPool(Factory factory, Validator validator = nullptr)
+        : m_factory(std::move(factory)), m_validator(std::move(validator)) {}
+
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    // 创建 (或刷新) 暂停状态的会话
+    bool Prewarm(uint64_t key, std::string* outError = nullptr)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            if (IsValid(key, *it->second->session)) {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                return true;
+            }
+            Discard(it);
+        }
+
+        auto session = m_factory(key, outError);
+        if (!session) return false;
+        Put(key, std::move(session));
+        return true;
+    }
+
+    // 取出并恢复会话; 池中没有或已失效时现场创建 (计为未命中)
+    std::unique_ptr<Session> Take(uint64_t key, std::string* outError = nullptr)
+    {
+        std::unique_ptr<Session> session;
+        auto it = m_index.find(key);
+        if (it != m_index.end() && !IsValid(key, *it->second->session)) {
+            Discard(it);
+            it = m_index.end();
+        }
+        if (it != m_index.end()) {
+            session = std::move(it->second->session);
+            m_bytes -= it->second->bytes;
+            m_lru.erase(it->second);
+            m_index.erase(it);
+            m_stats.hits++;
+        } else {
+            session = m_factory(key, outError);
+            if (!session) return nullptr;
+            m_stats.misses++;
+        }
+
+        session->ResumeCapture();
+        return session;
+    }
+
+    // 暂停后放回池中 (最近使用), 同一 key 的旧会话被替换
+    void Put(uint64_t key, std::unique_ptr<Session> session)
+    {
+        if (!session) return;
+        Remove(key);
+
+        session->PauseCapture();
+        size_t bytes = session->EstimatedMemoryBytes();
+        m_lru.push_front({ key, bytes, std::move(session) });
+        m_index[key] = m_lru.begin();
+        m_bytes += bytes;
+        Evict();
+    }
+
+    bool Remove(uint64_t key)
+    {
+        auto it = m_index.find(key);
+        if (it == m_index.end()) return false;
+        m_bytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+        return true;
+    }
+
+    void Clear()
+    {
+        m_index.clear();
+        m_lru.clear();
+        m_bytes = 0;
+    }
+
+    void SetBudget(const SessionPoolBudget& budget)
+    {
+        m_budget = budget;
+        Evict();
+    }
+
+    bool Contains(uint64_t key) const { return m_index.count(key) != 0; }
+    size_t Size() const { return m_lru.size(); }
+    size_t MemoryUsage() const { return m_bytes; }
+    const SessionPoolBudget& Budget() const { return m_budget; }
+    SessionPoolStats Stats() const { return m_stats; }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        size_t bytes;
+        std::unique_ptr<Session> session;
+    };
+
+    using Index = std::unordered_map<uint64_t, typename std::list<Entry>::iterator>;
+
+    bool IsValid(uint64_t key, Session& session) const { return !m_validator || m_validator(key, session); }
+
+    void Discard(typename Index::iterator it)
+    {
+        m_bytes -= it->second->bytes;
+        m_lru.erase(it->second);
+        m_index.erase(it);
+        m_stats.evictions++;
+    }
+
+    void Evict()
+    {
+        while (!m_lru.empty() && (m_lru.size() > m_budget.maxSessions || m_bytes > m_budget.maxBytes)) {
+            Entry& victim = m_lru.back();
+            m_bytes -= victim.bytes;
+            m_index.erase(victim.key);
+            m_lru.pop_back();
+            m_stats.evictions++;
+        }
+    }
+
+    Factory m_factory;
+    Validator m_validator;
+    SessionPoolBudget m_budget;
+    SessionPoolStats m_stats;
+    std::list<Entry> m_lru;
+    Index m_index;
+    size_t m_bytes = 0;
+};
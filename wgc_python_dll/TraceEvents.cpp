@@ -0,0 +1,222 @@
+#include "TraceEvents.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> g_traceEnabled{ false };
+
+namespace
+{
+    constexpr size_t kEventsPerThread = 1 << 14;
+    // 已退出线程的缓冲保留到下次 ClearTrace 以便导出, 超出此数时回收最早注册的
+    // (FrameArrived 运行在系统线程池上, 读回线程随 Start/Stop 重建, 线程数没有上限)
+    constexpr size_t kMaxRetiredBuffers = 16;
+
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t startUs;
+        int64_t durationUs;
+    };
+
+    // 导出线程可能与写入线程同时访问同一槽位, 字段用 relaxed 原子量避免数据竞争;
+    // 读到的撕裂事件由导出时对 head 的二次校验丢弃
+    struct TraceSlot
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<int64_t> startUs{ 0 };
+        std::atomic<int64_t> durationUs{ 0 };
+    };
+
+    struct ThreadTraceBuffer
+    {
+        int tid = 0;
+        std::atomic<uint64_t> head{ 0 };    // 已写入的事件总数, 只由所属线程递增
+        std::atomic<uint64_t> cleared{ 0 }; // ClearTrace 时的 head, 之前的事件不再导出
+        std::atomic<bool> retired{ false }; // 所属线程已退出, 不会再写入
+        TraceSlot events[kEventsPerThread];
+    };
+
+    std::mutex g_registryMutex;
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> g_registry;
+    int g_nextTid = 1;
+
+    // 线程退出时标记缓冲为已退出; 只在注册时访问, 写事件的快速路径只读 t_buffer
+    struct ThreadBufferOwner
+    {
+        ThreadTraceBuffer* buffer = nullptr;
+
+        ~ThreadBufferOwner()
+        {
+            if (buffer) buffer->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    thread_local ThreadTraceBuffer* t_buffer = nullptr;
+    thread_local ThreadBufferOwner t_owner;
+
+    // 调用方持有 g_registryMutex; 已退出的缓冲超出上限时移出注册表, 无导出线程引用时返回以便复用
+    std::shared_ptr<ThreadTraceBuffer> EvictRetiredLocked()
+    {
+        size_t retired = 0;
+        for (auto& buffer : g_registry) {
+            if (buffer->retired.load(std::memory_order_acquire)) retired++;
+        }
+
+        std::shared_ptr<ThreadTraceBuffer> reusable;
+        for (auto it = g_registry.begin(); retired >= kMaxRetiredBuffers && it != g_registry.end();) {
+            if (!(*it)->retired.load(std::memory_order_acquire)) {
+                ++it;
+                continue;
+            }
+            if (!reusable && it->use_count() == 1) reusable = *it;
+            it = g_registry.erase(it);
+            retired--;
+        }
+        return reusable;
+    }
+
+    ThreadTraceBuffer* ThreadBuffer()
+    {
+        if (!t_buffer) {
+            // 每个线程只注册一次; 线程退出后缓冲仍保留以便导出
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            std::shared_ptr<ThreadTraceBuffer> buffer = EvictRetiredLocked();
+            if (buffer) {
+                // 已移出注册表且没有导出线程持有, 可以直接重置
+                buffer->head.store(0, std::memory_order_relaxed);
+                buffer->cleared.store(0, std::memory_order_relaxed);
+                buffer->retired.store(false, std::memory_order_relaxed);
+            } else {
+                buffer = std::make_shared<ThreadTraceBuffer>();
+            }
+            buffer->tid = g_nextTid++;
+            g_registry.push_back(buffer);
+            t_buffer = buffer.get();
+            t_owner.buffer = t_buffer;
+        }
+        return t_buffer;
+    }
+
+    void AppendJsonString(std::string& out, const char* s)
+    {
+        out += '"';
+        for (; *s; s++) {
+            char c = *s;
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+}
+
+void SetTraceEnabled(bool enable)
+{
+    g_traceEnabled.store(enable, std::memory_order_relaxed);
+}
+
+int64_t TraceNowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecord(const char* name, int64_t startUs, int64_t durationUs)
+{
+    ThreadTraceBuffer* buffer = ThreadBuffer();
+    uint64_t index = buffer->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = buffer->events[index % kEventsPerThread];
+    // 与导出端的 acquire fence 配对: 导出线程读到本次写入的字段时, 随后读 head 至少为 index
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startUs.store(startUs, std::memory_order_relaxed);
+    slot.durationUs.store(durationUs, std::memory_order_relaxed);
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+void ClearTrace()
+{
+    // 已退出线程的事件随清空一起丢弃, 缓冲也一并释放
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    auto retired = std::remove_if(g_registry.begin(), g_registry.end(), [](const auto& buffer) {
+        return buffer->retired.load(std::memory_order_acquire);
+    });
+    g_registry.erase(retired, g_registry.end());
+    for (auto& buffer : g_registry) {
+        buffer->cleared.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+size_t TraceThreadBufferCount()
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    return g_registry.size();
+}
+
+std::string SerializeChromeTrace()
+{
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffers = g_registry;
+    }
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&] {
+        if (!first) out += ",\n";
+        first = false;
+    };
+
+    std::vector<TraceEvent> events;
+    for (auto& buffer : buffers) {
+        // 先复制再校验: 复制期间被写入线程覆盖的旧事件丢弃
+        uint64_t end = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = buffer->cleared.load(std::memory_order_relaxed);
+        if (end - begin > kEventsPerThread) begin = end - kEventsPerThread;
+
+        events.clear();
+        for (uint64_t i = begin; i < end; i++) {
+            const TraceSlot& slot = buffer->events[i % kEventsPerThread];
+            events.push_back({ slot.name.load(std::memory_order_relaxed),
+                slot.startUs.load(std::memory_order_relaxed),
+                slot.durationUs.load(std::memory_order_relaxed) });
+        }
+
+        // 读到 head == after 时, 写入线程可能正在写第 after 个事件, 即覆盖第 after - kEventsPerThread 个槽位,
+        // 因此下标 <= after - kEventsPerThread 的事件都不可信
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer->head.load(std::memory_order_relaxed);
+        size_t skip = 0;
+        if (after + 1 - begin > kEventsPerThread) {
+            skip = static_cast<size_t>(after + 1 - kEventsPerThread - begin);
+            if (skip > events.size()) skip = events.size();
+        }
+
+        std::string tid = std::to_string(buffer->tid);
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid +
+            ",\"args\":{\"name\":\"thread " + tid + "\"}}";
+
+        for (size_t i = skip; i < events.size(); i++) {
+            const TraceEvent& e = events[i];
+            separator();
+            out += "{\"name\":";
+            AppendJsonString(out, e.name ? e.name : "?");
+            out += ",\"cat\":\"wgc\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid;
+            out += ",\"ts\":" + std::to_string(e.startUs);
+            out += ",\"dur\":" + std::to_string(e.durationUs) + "}";
+        }
+    }
+
+    out += "],\"displayTimeUnit\":\"ms\"}\n";
+    return out;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 捕获管线的时间线追踪, 导出为 Chrome/Perfetto trace JSON
+// 每个线程写自己的环形缓冲 (单写者, 无锁); 关闭时每个追踪点只有一次原子读和分支
+
+extern std::atomic<bool> g_traceEnabled;
+
+inline bool IsTraceEnabled()
+{
+    return g_traceEnabled.load(std::memory_order_relaxed);
+}
+
+void SetTraceEnabled(bool enable);
+int64_t TraceNowUs();
+// name 必须是静态存储期的字符串 (字面量或 __func__)
+void TraceRecord(const char* name, int64_t startUs, int64_t durationUs);
+// 同时释放已退出线程的缓冲
+void ClearTrace();
+// 注册表中的线程缓冲数, 包括已退出但尚未释放的
+size_t TraceThreadBufferCount();
+std::string SerializeChromeTrace();
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(name), m_startUs(IsTraceEnabled() ? TraceNowUs() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_startUs >= 0) TraceRecord(m_name, m_startUs, TraceNowUs() - m_startUs);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_startUs;
+};
+
+#define WGC_TRACE_CONCAT_INNER(a, b) a##b
+#define WGC_TRACE_CONCAT(a, b) WGC_TRACE_CONCAT_INNER(a, b)
+#define WGC_TRACE_SCOPE(name) TraceScope WGC_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define WGC_TRACE_FUNCTION() WGC_TRACE_SCOPE(__func__)
@@ -0,0 +1,335 @@
+#include "TriggerEngine.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#ifdef WGC_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr size_t kMaxQueuedEvents = 256;
+
+    void ToLuma(const uint8_t* bgra, size_t stride, int width, int height, std::vector<uint8_t>& out)
+    {
+        out.resize(static_cast<size_t>(width) * height);
+        for (int y = 0; y < height; y++) {
+            const uint8_t* src = bgra + y * stride;
+            uint8_t* dst = out.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; x++) {
+                dst[x] = static_cast<uint8_t>((src[x * 4] * 29 + src[x * 4 + 1] * 150 + src[x * 4 + 2] * 77) >> 8);
+            }
+        }
+    }
+
+    void CopyRegion(const uint8_t* origin, size_t stride, int width, int height, std::vector<uint8_t>& out)
+    {
+        size_t rowBytes = static_cast<size_t>(width) * 4;
+        out.resize(rowBytes * height);
+        for (int y = 0; y < height; y++) {
+            memcpy(out.data() + y * rowBytes, origin + y * stride, rowBytes);
+        }
+    }
+}
+
+double RegionMae(const uint8_t* a, size_t strideA, const uint8_t* b, size_t strideB, int width, int height)
+{
+    if (width <= 0 || height <= 0) return 0;
+
+    uint64_t total = 0;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* ra = a + y * strideA;
+        const uint8_t* rb = b + y * strideB;
+        int x = 0;
+#ifdef WGC_HAS_SSE2
+        // alpha 不参与比较
+        const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+        __m128i acc = _mm_setzero_si128();
+        for (; x + 4 <= width; x += 4) {
+            __m128i va = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ra + x * 4)), colorMask);
+            __m128i vb = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rb + x * 4)), colorMask);
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+        }
+        total += static_cast<uint64_t>(_mm_cvtsi128_si32(acc)) +
+            static_cast<uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#endif
+        for (; x < width; x++) {
+            for (int c = 0; c < 3; c++) {
+                total += static_cast<uint64_t>(std::abs(ra[x * 4 + c] - rb[x * 4 + c]));
+            }
+        }
+    }
+    return static_cast<double>(total) / (static_cast<double>(width) * height * 3);
+}
+
+double RegionSsim(const uint8_t* a, const uint8_t* b, int width, int height)
+{
+    if (width <= 0 || height <= 0) return 0;
+
+    const double c1 = (0.01 * 255) * (0.01 * 255);
+    const double c2 = (0.03 * 255) * (0.03 * 255);
+
+    // 8x8 不重叠块; 区域不足 8 像素时整体作为一块, 边缘余数忽略
+    int block = std::min({ 8, width, height });
+    int blocksX = width / block;
+    int blocksY = height / block;
+    double n = static_cast<double>(block) * block;
+    double total = 0;
+
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            uint32_t sa = 0, sb = 0;
+            uint64_t saa = 0, sbb = 0, sab = 0;
+            for (int y = 0; y < block; y++) {
+                size_t offset = static_cast<size_t>(by * block + y) * width + bx * block;
+                for (int x = 0; x < block; x++) {
+                    uint32_t va = a[offset + x];
+                    uint32_t vb = b[offset + x];
+                    sa += va;
+                    sb += vb;
+                    saa += va * va;
+                    sbb += vb * vb;
+                    sab += va * vb;
+                }
+            }
+            double ma = sa / n;
+            double mb = sb / n;
+            double va = saa / n - ma * ma;
+            double vb = sbb / n - mb * mb;
+            double cov = sab / n - ma * mb;
+            total += ((2 * ma * mb + c1) * (2 * cov + c2)) / ((ma * ma + mb * mb + c1) * (va + vb + c2));
+        }
+    }
+    return total / (static_cast<double>(blocksX) * blocksY);
+}
+
+int TriggerEngine::Add(const TriggerSpec& spec)
+{
+    if (spec.kind < TriggerMatch || spec.kind > TriggerStable) return 0;
+
+    Trigger trigger;
+    trigger.spec = spec;
+
+    if (spec.kind == TriggerMatch) {
+        int w = spec.referenceWidth;
+        int h = spec.referenceHeight;
+        if (w <= 0 || h <= 0 || spec.reference.size() < static_cast<size_t>(w) * h * 4) return 0;
+        if (spec.metric == TriggerMetricSsim) {
+            ToLuma(spec.reference.data(), static_cast<size_t>(w) * 4, w, h, trigger.referenceLuma);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int id = m_nextId++;
+    m_triggers.emplace(id, std::move(trigger));
+    return id;
+}
+
+bool TriggerEngine::Remove(int id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_triggers.erase(id)) return false;
+
+    m_events.erase(std::remove_if(m_events.begin(), m_events.end(),
+        [id](const TriggerEvent& e) { return e.id == id; }), m_events.end());
+    m_cv.notify_all();
+    return true;
+}
+
+void TriggerEngine::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_triggers.clear();
+    m_events.clear();
+    m_generation++;
+    m_cv.notify_all();
+}
+
+size_t TriggerEngine::Size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_triggers.size();
+}
+
+void TriggerEngine::CollectRegions(std::vector<FrameRect>& regions)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& [id, trigger] : m_triggers) {
+        regions.push_back(trigger.spec.roi);
+        trigger.collected = true;
+    }
+}
+
+void TriggerEngine::Evaluate(const FrameView& frame, int64_t timestampMs, int onlyId, bool collectedOnly)
+{
+    if (!frame.IsValid()) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t queued = m_events.size();
+
+    for (auto it = m_triggers.begin(); it != m_triggers.end();) {
+        if ((onlyId != 0 && it->first != onlyId) || (collectedOnly && !it->second.collected)) {
+            ++it;
+            continue;
+        }
+        EvaluateLocked(it->first, it->second, frame, timestampMs);
+        if (it->second.fired && it->second.spec.oneShot) {
+            it = m_triggers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_events.size() != queued) m_cv.notify_all();
+}
+
+void TriggerEngine::EvaluateLocked(int id, Trigger& trigger, const FrameView& frame, int64_t timestampMs)
+{
+    const TriggerSpec& spec = trigger.spec;
+    FrameRect r = spec.roi.ClampTo(frame.width, frame.height);
+    if (r.IsEmpty()) return;
+
+    const uint8_t* origin = frame.Row(r.y) + static_cast<size_t>(r.x) * 4;
+
+    if (spec.kind == TriggerMatch) {
+        if (r.width != spec.referenceWidth || r.height != spec.referenceHeight) {
+            trigger.matched = false;
+            return;
+        }
+
+        double score;
+        bool hit;
+        if (spec.metric == TriggerMetricSsim) {
+            ToLuma(origin, frame.stride, r.width, r.height, m_luma);
+            score = RegionSsim(m_luma.data(), trigger.referenceLuma.data(), r.width, r.height);
+            hit = score >= spec.threshold;
+        } else {
+            score = RegionMae(origin, frame.stride, spec.reference.data(),
+                static_cast<size_t>(r.width) * 4, r.width, r.height);
+            hit = score <= spec.threshold;
+        }
+
+        if (hit && !trigger.matched) FireLocked(id, trigger, timestampMs, score);
+        trigger.matched = hit;
+        return;
+    }
+
+    bool sameSize = !trigger.snapshot.empty() &&
+        trigger.snapshotWidth == r.width && trigger.snapshotHeight == r.height;
+
+    if (spec.kind == TriggerChanged) {
+        if (!sameSize) {
+            // 首帧作为基准; 尺寸变化视为内容变化
+            if (!trigger.snapshot.empty()) FireLocked(id, trigger, timestampMs, 255);
+        } else {
+            double score = RegionMae(origin, frame.stride, trigger.snapshot.data(),
+                static_cast<size_t>(r.width) * 4, r.width, r.height);
+            if (score <= spec.threshold) return;
+            FireLocked(id, trigger, timestampMs, score);
+        }
+    } else {
+        double score = 255;
+        if (sameSize) {
+            score = RegionMae(origin, frame.stride, trigger.snapshot.data(),
+                static_cast<size_t>(r.width) * 4, r.width, r.height);
+        }
+        if (!sameSize || score > spec.threshold) {
+            trigger.stableSinceMs = timestampMs;
+            trigger.fired = false;
+        }
+        if (!trigger.fired && timestampMs - trigger.stableSinceMs >= spec.durationMs) {
+            FireLocked(id, trigger, timestampMs, sameSize ? score : 0);
+        }
+    }
+
+    CopyRegion(origin, frame.stride, r.width, r.height, trigger.snapshot);
+    trigger.snapshotWidth = r.width;
+    trigger.snapshotHeight = r.height;
+}
+
+void TriggerEngine::FireLocked(int id, Trigger& trigger, int64_t timestampMs, double score)
+{
+    trigger.fired = true;
+    if (m_events.size() >= kMaxQueuedEvents) m_events.pop_front();
+    m_events.push_back({ id, timestampMs, score });
+}
+
+void TriggerEngine::Tick(int64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TickLocked(nowMs);
+}
+
+void TriggerEngine::TickLocked(int64_t nowMs)
+{
+    // 画面不变时不会有新帧, Stable 条件按时间判定
+    size_t queued = m_events.size();
+
+    for (auto it = m_triggers.begin(); it != m_triggers.end();) {
+        Trigger& trigger = it->second;
+        if (trigger.spec.kind == TriggerStable && !trigger.fired && !trigger.snapshot.empty() &&
+            nowMs - trigger.stableSinceMs >= trigger.spec.durationMs) {
+            FireLocked(it->first, trigger, nowMs, 0);
+        }
+        if (trigger.fired && trigger.spec.oneShot) {
+            it = m_triggers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_events.size() != queued) m_cv.notify_all();
+}
+
+int64_t TriggerEngine::NextDeadlineLocked() const
+{
+    int64_t deadline = INT64_MAX;
+    for (const auto& [id, trigger] : m_triggers) {
+        if (trigger.spec.kind == TriggerStable && !trigger.fired && !trigger.snapshot.empty()) {
+            deadline = std::min(deadline, trigger.stableSinceMs + trigger.spec.durationMs);
+        }
+    }
+    return deadline;
+}
+
+bool TriggerEngine::PopLocked(int id, TriggerEvent& event)
+{
+    for (auto it = m_events.begin(); it != m_events.end(); ++it) {
+        if (id == 0 || it->id == id) {
+            event = *it;
+            m_events.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TriggerEngine::Wait(int id, int timeoutMs, TriggerEvent& event)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t generation = m_generation;
+    int64_t deadline = timeoutMs < 0 ? INT64_MAX : CaptureClockMs() + timeoutMs;
+
+    for (;;) {
+        int64_t now = CaptureClockMs();
+        TickLocked(now);
+
+        if (PopLocked(id, event)) return true;
+        if (generation != m_generation) return false;
+        if (id != 0 && !m_triggers.count(id)) return false;
+        if (now >= deadline) return false;
+
+        int64_t wake = std::min(deadline, NextDeadlineLocked());
+        // 等待上限避免超长超时的溢出, 醒来后重新判定
+        int64_t waitMs = std::clamp<int64_t>(wake - now, 1, 1000);
+        m_cv.wait_for(lock, std::chrono::milliseconds(waitMs));
+    }
+}
+
+bool TriggerEngine::Poll(int id, TriggerEvent& event)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TickLocked(CaptureClockMs());
+    return PopLocked(id, event);
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "FrameView.h"
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+enum TriggerKind
+{
+    TriggerMatch = 0,   // 区域与参考图相符 (进入相符状态时触发)
+    TriggerChanged = 1, // 区域相对上次触发/登记时的内容变化超过阈值
+    TriggerStable = 2,  // 区域持续 durationMs 未变化 (相邻帧差不超过阈值)
+};
+
+enum TriggerMetric
+{
+    TriggerMetricMae = 0,  // BGR 平均绝对误差 (0-255), 越小越相似
+    TriggerMetricSsim = 1, // 亮度 SSIM (8x8 块均值), 越大越相似
+};
+
+struct TriggerSpec
+{
+    int kind = TriggerChanged;
+    FrameRect roi;
+    int metric = TriggerMetricMae;
+    double threshold = 0;
+    int64_t durationMs = 0;
+    bool oneShot = true;
+    // TriggerMatch 的参考图: 与 ROI 同尺寸的 BGRA (无行填充)
+    std::vector<uint8_t> reference;
+    int referenceWidth = 0;
+    int referenceHeight = 0;
+};
+
+struct TriggerEvent
+{
+    int id;
+    int64_t timestampMs;
+    double score; // Match: 相似度量值; Changed/Stable: MAE
+};
+
+double RegionMae(const uint8_t* a, size_t strideA, const uint8_t* b, size_t strideB, int width, int height);
+// 输入为紧凑亮度平面
+double RegionSsim(const uint8_t* a, const uint8_t* b, int width, int height);
+
+// 在帧到达时评估已登记的条件, 触发事件进入队列供 Wait/Poll 取出
+// Stable 条件在没有新帧时也需要按时间判定, 由 Tick 或 Wait 内部驱动
+class TriggerEngine
+{
+public:
+    // 失败 (参数无效) 返回 0
+    int Add(const TriggerSpec& spec);
+    bool Remove(int id);
+    // 清空条件与事件, 并唤醒所有等待者
+    void Clear();
+    size_t Size() const;
+
+    // 追加各条件的 ROI, 供读回线程只复制这些区域; 同时把这些条件标记为已收集
+    void CollectRegions(std::vector<FrameRect>& regions);
+    // onlyId 非 0 时只评估该条件 (登记后用当前最新帧初始化基准)
+    // collectedOnly 时帧只在已收集的 ROI 内有效, 收集之后才登记的条件跳过本帧
+    void Evaluate(const FrameView& frame, int64_t timestampMs, int onlyId = 0, bool collectedOnly = false);
+    void Tick(int64_t nowMs);
+
+    // id 为 0 表示任意条件; 超时/被取消/该条件已移除时返回 false
+    bool Wait(int id, int timeoutMs, TriggerEvent& event);
+    bool Poll(int id, TriggerEvent& event);
+
+private:
+    struct Trigger
+    {
+        TriggerSpec spec;
+        std::vector<uint8_t> referenceLuma;
+        // Changed: 基准内容; Stable: 上一帧内容
+        std::vector<uint8_t> snapshot;
+        int snapshotWidth = 0;
+        int snapshotHeight = 0;
+        int64_t stableSinceMs = 0;
+        bool matched = false;
+        bool fired = false;
+        bool collected = false;
+    };
+
+    void EvaluateLocked(int id, Trigger& trigger, const FrameView& frame, int64_t timestampMs);
+    void FireLocked(int id, Trigger& trigger, int64_t timestampMs, double score);
+    void TickLocked(int64_t nowMs);
+    int64_t NextDeadlineLocked() const;
+    bool PopLocked(int id, TriggerEvent& event);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<int, Trigger> m_triggers;
+    std::deque<TriggerEvent> m_events;
+    std::vector<uint8_t> m_luma;
+    int m_nextId = 1;
+    uint64_t m_generation = 0;
+};
@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "WGCCaptureScheduler.h"
+
+namespace
+{
+    constexpr int kTickIntervalMs = 5;
+}
+
+WGCCaptureScheduler::WGCCaptureScheduler() : m_scheduler(*this)
+{
+}
+
+WGCCaptureScheduler::~WGCCaptureScheduler()
+{
+    Stop();
+
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    m_sessions.clear();
+    m_device = nullptr;
+}
+
+ID3D11Device* WGCCaptureScheduler::EnsureDevice(std::string* outError)
+{
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    if (m_device) return m_device.get();
+
+    try {
+        auto device = util::CreateD3D11Device();
+        device.as<ID3D11Multithread>()->SetMultithreadProtected(TRUE);
+        m_device = device;
+        return m_device.get();
+    } catch (const winrt::hresult_error& e) {
+        if (outError) *outError = "Failed to create shared D3D11 device: " + winrt::to_string(e.message());
+        return nullptr;
+    }
+}
+
+int WGCCaptureScheduler::AddTarget(HWND hwnd, int intervalMs, int priority, std::string* outError)
+{
+    ID3D11Device* device = EnsureDevice(outError);
+    if (!device) return 0;
+
+    auto capture = std::make_unique<WGCWindowCapture>();
+    if (!capture->Initialize(outError, device)) return 0;
+    if (!capture->StartContinuousCapture(hwnd, outError)) return 0;
+
+    // 会话常驻, 平时处于暂停状态, 不产生 GPU 复制
+    capture->PauseCapture();
+
+    int targetId;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        targetId = m_nextTargetId++;
+        m_sessions[targetId] = std::move(capture);
+    }
+
+    m_scheduler.AddTarget(targetId, intervalMs, priority, CaptureClockMs());
+    return targetId;
+}
+
+void WGCCaptureScheduler::RemoveTarget(int targetId)
+{
+    m_scheduler.RemoveTarget(targetId);
+
+    std::unique_ptr<WGCWindowCapture> capture;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        auto it = m_sessions.find(targetId);
+        if (it == m_sessions.end()) return;
+        capture = std::move(it->second);
+        m_sessions.erase(it);
+    }
+    // 在锁外关闭会话, 避免阻塞调度线程
+    capture = nullptr;
+}
+
+void WGCCaptureScheduler::Start()
+{
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&WGCCaptureScheduler::RunLoop, this);
+}
+
+void WGCCaptureScheduler::Stop()
+{
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void WGCCaptureScheduler::RunLoop()
+{
+    while (m_running) {
+        m_scheduler.Tick(CaptureClockMs());
+        std::this_thread::sleep_for(std::chrono::milliseconds(kTickIntervalMs));
+    }
+}
+
+WGCWindowCapture* WGCCaptureScheduler::FindSession(int targetId)
+{
+    std::lock_guard<std::mutex> lock(m_sessionMutex);
+    auto it = m_sessions.find(targetId);
+    return it != m_sessions.end() ? it->second.get() : nullptr;
+}
+
+bool WGCCaptureScheduler::Resume(int targetId)
+{
+    WGCWindowCapture* capture = FindSession(targetId);
+    if (!capture || !capture->IsCapturing()) return false;
+    capture->ResumeCapture();
+    return true;
+}
+
+void WGCCaptureScheduler::Pause(int targetId)
+{
+    WGCWindowCapture* capture = FindSession(targetId);
+    if (capture) capture->PauseCapture();
+}
+
+bool WGCCaptureScheduler::TryGrab(int targetId, FrameSlot& slot)
+{
+    WGCWindowCapture* capture = FindSession(targetId);
+    if (!capture) return false;
+
+    // 暂停时可读帧已被清除, 恢复后能读到的一定是新到达的帧
+    return capture->ReadLatestFrame([&](const FrameView& frame) {
+        size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+        slot.data.resize(rowBytes * frame.height);
+        for (int y = 0; y < frame.height; y++) {
+            memcpy(slot.data.data() + y * rowBytes, frame.Row(y), rowBytes);
+        }
+        slot.width = frame.width;
+        slot.height = frame.height;
+    });
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "pch.h"
+#include "WGCWindowCapture.h"
+#include "CaptureScheduler.h"
+
+// 基于 WGCWindowCapture 的调度后端: 每个目标窗口一个常驻暂停的捕获会话,
+// 由后台线程按调度器的决策恢复/暂停; 所有会话共用一个 D3D11 设备
+class WGCCaptureScheduler : public ICaptureBackend
+{
+public:
+    WGCCaptureScheduler();
+    ~WGCCaptureScheduler();
+
+    int AddTarget(HWND hwnd, int intervalMs, int priority, std::string* outError = nullptr);
+    void RemoveTarget(int targetId);
+    void SetBudget(const SchedulerBudget& budget) { m_scheduler.SetBudget(budget); }
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return m_running; }
+
+    bool CopyFrame(int targetId, FrameSlot& out) const { return m_scheduler.CopyFrame(targetId, out); }
+    SchedulerStats Stats() const { return m_scheduler.Stats(); }
+
+    bool Resume(int targetId) override;
+    void Pause(int targetId) override;
+    bool TryGrab(int targetId, FrameSlot& slot) override;
+
+private:
+    CaptureScheduler m_scheduler;
+
+    std::mutex m_sessionMutex;
+    // 首次添加目标时创建, 开启多线程保护后各会话的帧回调与读回线程可共用即时上下文
+    winrt::com_ptr<ID3D11Device> m_device;
+    std::map<int, std::unique_ptr<WGCWindowCapture>> m_sessions;
+    int m_nextTargetId = 1;
+
+    std::atomic<bool> m_running{ false };
+    std::thread m_thread;
+
+    void RunLoop();
+    ID3D11Device* EnsureDevice(std::string* outError);
+    WGCWindowCapture* FindSession(int targetId);
+};
@@ -2,6 +2,16 @@
 #include "WGCExport.h"
 #include "WindowEnumerator.h"
 #include "WGCWindowCapture.h"
+#include "PerceptualHash.h"
+#include "FrameHistory.h"
+#include "WGCCaptureScheduler.h"
+#include "TraceEvents.h"
+#include "ColorSegmentation.h"
+#include "TriggerEngine.h"
+#include "SessionPool.h"
+#include "FrameSaver.h"
+#include "ScrollDetector.h"
+#include "IntegralImage.h"
 #include <memory>
 #include <atomic>
 
@@ -9,6 +19,40 @@ static std::unique_ptr<WGCWindowCapture> g_capture = nullptr;
 static std::mutex g_captureMutex;
 static std::string g_lastErrorMsg = "";
 static std::mutex g_errorMsgMutex;
+static HashIndex g_hashIndex;
+static std::mutex g_hashIndexMutex;
+static bool g_hdrCapture = false;
+static ToneMapParams g_toneMapParams;
+static std::unique_ptr<FrameHistory> g_frameHistory = nullptr;
+static int g_frameHistoryListener = 0;
+static std::mutex g_frameHistoryMutex;
+// 条件对象常驻, 等待者不持有任何全局锁; 没有条件时摘除帧监听以停止读回
+static TriggerEngine g_triggers;
+static int g_triggerListener = 0;
+static std::unique_ptr<WGCCaptureScheduler> g_scheduler = nullptr;
+static std::mutex g_schedulerMutex;
+// 预热会话池, 由 g_captureMutex 保护; 切换时与 g_capture 交换所有权
+static std::unique_ptr<SessionPool<WGCWindowCapture>> g_sessionPool = nullptr;
+static SessionPoolBudget g_sessionPoolBudget;
+// 池内会话共用一个多线程保护的设备, 预算只需计入各自的纹理
+static winrt::com_ptr<ID3D11Device> g_sessionPoolDevice = nullptr;
+// 入池时窗口的标题与类名, 命中时比对以识别被复用的句柄
+struct PooledWindowIdentity
+{
+    std::wstring title;
+    std::wstring className;
+};
+static std::unordered_map<uint64_t, PooledWindowIdentity> g_pooledWindows;
+static std::unique_ptr<FrameSaver> g_frameSaver = nullptr;
+static std::mutex g_frameSaverMutex;
+static std::unique_ptr<ScrollTracker> g_scrollTracker = nullptr;
+static int g_scrollListener = 0;
+static std::mutex g_scrollMutex;
+static std::unique_ptr<IntegralImage> g_integralImage = nullptr;
+static int64_t g_integralTimestampMs = 0;
+static int g_integralUpdatedBands = 0;
+static int g_integralListener = 0;
+static std::mutex g_integralMutex;
 static bool g_winrtInitialized = false;
 static std::mutex g_initMutex;
 
@@ -67,6 +111,30 @@ static HWND FindTargetWindow(const char* title, const char* className)
     return hwnd;
 }
 
+static int StatsFlagsFromOutputs(const void* histogram, const void* sums,
+    const void* minValues, const void* maxValues)
+{
+    int flags = 0;
+    if (histogram) flags |= FrameStatsHistogram;
+    if (sums) flags |= FrameStatsSums;
+    if (minValues || maxValues) flags |= FrameStatsMinMax;
+    return flags;
+}
+
+static void WriteStatsOutputs(const FrameStatistics& stats,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount)
+{
+    if (histogram) memcpy(histogram, stats.histogram, sizeof(stats.histogram));
+    for (int c = 0; c < 4; c++)
+    {
+        if (sums) sums[c] = stats.sum[c];
+        if (minValues) minValues[c] = stats.minValue[c];
+        if (maxValues) maxValues[c] = stats.maxValue[c];
+    }
+    if (pixelCount) *pixelCount = stats.pixelCount;
+}
+
 static bool EnsureCaptureInitialized()
 {
     if (!g_capture)
@@ -79,6 +147,7 @@ static bool EnsureCaptureInitialized()
             g_capture = nullptr;
             return false;
         }
+        g_capture->SetToneMapParams(g_toneMapParams);
     }
     return true;
 }
@@ -87,12 +156,14 @@ static bool EnsureCaptureInitialized()
 
 WGC_API const char* GetLastErrorMsg()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_errorMsgMutex);
     return g_lastErrorMsg.c_str();
 }
 
 WGC_API int EnumerateWindows(char*** titles, char*** classNames, int* count)
 {
+    WGC_TRACE_FUNCTION();
     try
     {
         WindowEnumerator enumerator;
@@ -132,6 +203,7 @@ WGC_API int EnumerateWindows(char*** titles, char*** classNames, int* count)
 
 WGC_API void FreeStringArray(char** array, int count)
 {
+    WGC_TRACE_FUNCTION();
     if (!array) return;
     for (int i = 0; i < count; i++)
     {
@@ -142,6 +214,7 @@ WGC_API void FreeStringArray(char** array, int count)
 
 WGC_API int StartContinuousCapture(const char* title, const char* className)
 {
+    WGC_TRACE_FUNCTION();
     try
     {
         std::lock_guard<std::mutex> lock(g_captureMutex);
@@ -168,6 +241,8 @@ WGC_API int StartContinuousCapture(const char* title, const char* className)
             return 0;
         }
 
+        g_capture->SetHdrCapture(g_hdrCapture);
+
         std::string err;
         if (!g_capture->StartContinuousCapture(hwnd, &err))
         {
@@ -186,6 +261,7 @@ WGC_API int StartContinuousCapture(const char* title, const char* className)
 
 WGC_API int GetLatestFrame(unsigned char** imageData, int* width, int* height)
 {
+    WGC_TRACE_FUNCTION();
     try
     {
         std::lock_guard<std::mutex> lock(g_captureMutex);
@@ -211,23 +287,27 @@ WGC_API int GetLatestFrame(unsigned char** imageData, int* width, int* height)
 
 WGC_API void FreeImageData(unsigned char* data)
 {
+    WGC_TRACE_FUNCTION();
     if (data) CoTaskMemFree(data);
 }
 
 WGC_API void StopContinuousCapture()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     if (g_capture) g_capture->StopContinuousCapture();
 }
 
 WGC_API int IsCapturing()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     return (g_capture && g_capture->IsCapturing()) ? 1 : 0;
 }
 
 WGC_API int GetFrameCount()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     return g_capture ? g_capture->GetFrameCount() : 0;
 }
@@ -235,18 +315,1559 @@ WGC_API int GetFrameCount()
 // 新增：暂停/恢复捕获
 WGC_API void PauseCapture()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     if (g_capture) g_capture->PauseCapture();
 }
 
 WGC_API void ResumeCapture()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     if (g_capture) g_capture->ResumeCapture();
 }
 
 WGC_API int IsPaused()
 {
+    WGC_TRACE_FUNCTION();
     std::lock_guard<std::mutex> lock(g_captureMutex);
     return (g_capture && g_capture->IsPaused()) ? 1 : 0;
-}
\ No newline at end of file
+}
+
+// 会话池
+static uint64_t WindowKey(HWND hwnd)
+{
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+}
+
+static PooledWindowIdentity QueryWindowIdentity(HWND hwnd)
+{
+    wchar_t title[256] = {};
+    wchar_t className[256] = {};
+    GetWindowTextW(hwnd, title, 256);
+    GetClassNameW(hwnd, className, 256);
+    return { title, className };
+}
+
+static ID3D11Device* EnsureSessionPoolDevice(std::string* outError)
+{
+    if (g_sessionPoolDevice) return g_sessionPoolDevice.get();
+
+    try
+    {
+        auto device = util::CreateD3D11Device();
+        device.as<ID3D11Multithread>()->SetMultithreadProtected(TRUE);
+        g_sessionPoolDevice = device;
+        return g_sessionPoolDevice.get();
+    }
+    catch (const winrt::hresult_error& e)
+    {
+        if (outError) *outError = "Failed to create shared D3D11 device: " + winrt::to_string(e.message());
+        return nullptr;
+    }
+}
+
+static std::unique_ptr<WGCWindowCapture> CreatePooledSession(uint64_t key, std::string* outError)
+{
+    ID3D11Device* device = EnsureSessionPoolDevice(outError);
+    if (!device) return nullptr;
+
+    auto capture = std::make_unique<WGCWindowCapture>();
+    if (!capture->Initialize(outError, device)) return nullptr;
+
+    capture->SetToneMapParams(g_toneMapParams);
+    capture->SetHdrCapture(g_hdrCapture);
+    capture->SetRetainWhilePaused(true);
+
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(key));
+    if (!capture->StartContinuousCapture(hwnd, outError)) return nullptr;
+    g_pooledWindows[key] = QueryWindowIdentity(hwnd);
+    return capture;
+}
+
+// 窗口已关闭, 捕获已停止, 或句柄被另一个窗口复用时, 池中会话作废
+static bool IsPooledSessionValid(uint64_t key, WGCWindowCapture& session)
+{
+    HWND hwnd = reinterpret_cast<HWND>(static_cast<uintptr_t>(key));
+    auto it = g_pooledWindows.find(key);
+    bool valid = it != g_pooledWindows.end() && IsWindow(hwnd) && session.IsCapturing()
+        && session.GetTargetWindow() == hwnd;
+    if (valid)
+    {
+        PooledWindowIdentity current = QueryWindowIdentity(hwnd);
+        valid = current.title == it->second.title && current.className == it->second.className;
+    }
+    if (!valid && it != g_pooledWindows.end()) g_pooledWindows.erase(it);
+    return valid;
+}
+
+static SessionPool<WGCWindowCapture>& EnsureSessionPool()
+{
+    if (!g_sessionPool)
+    {
+        g_sessionPool = std::make_unique<SessionPool<WGCWindowCapture>>(CreatePooledSession, IsPooledSessionValid);
+        g_sessionPool->SetBudget(g_sessionPoolBudget);
+    }
+    return *g_sessionPool;
+}
+
+static HWND FindVisibleTargetWindow(const char* title, const char* className)
+{
+    HWND hwnd = FindTargetWindow(title, className);
+    if (!hwnd)
+    {
+        SetLastErrorMsg("Window not found");
+        return nullptr;
+    }
+
+    if (!IsWindowVisible(hwnd))
+    {
+        SetLastErrorMsg("Window not visible");
+        return nullptr;
+    }
+    return hwnd;
+}
+
+WGC_API int PrewarmWindow(const char* title, const char* className)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        SetLastErrorMsg("");
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        HWND hwnd = FindVisibleTargetWindow(title, className);
+        if (!hwnd) return 0;
+
+        if (g_capture && g_capture->IsCapturing() && g_capture->GetTargetWindow() == hwnd) return 1;
+
+        std::string err;
+        if (!EnsureSessionPool().Prewarm(WindowKey(hwnd), &err))
+        {
+            SetLastErrorMsg("Prewarm failed: " + err);
+            return 0;
+        }
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int SwitchToWindow(const char* title, const char* className)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        SetLastErrorMsg("");
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        if (!EnsureCaptureInitialized()) return 0;
+
+        HWND hwnd = FindVisibleTargetWindow(title, className);
+        if (!hwnd) return 0;
+
+        if (g_capture->IsCapturing() && g_capture->GetTargetWindow() == hwnd)
+        {
+            g_capture->ResumeCapture();
+            return 1;
+        }
+
+        // 池中没有时现场创建, 与 StartContinuousCapture 开销相同
+        auto& pool = EnsureSessionPool();
+        std::string err;
+        auto next = pool.Take(WindowKey(hwnd), &err);
+        if (!next)
+        {
+            SetLastErrorMsg("Start capture failed: " + err);
+            return 0;
+        }
+
+        // 帧历史、触发条件等监听跟随活动会话
+        g_capture->TransferFrameListeners(*next);
+
+        if (g_capture->IsCapturing())
+        {
+            HWND previous = g_capture->GetTargetWindow();
+            g_capture->SetRetainWhilePaused(true);
+            g_pooledWindows[WindowKey(previous)] = QueryWindowIdentity(previous);
+            pool.Put(WindowKey(previous), std::move(g_capture));
+        }
+        g_capture = std::move(next);
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API void SetSessionPoolBudget(int maxSessions, int maxMemoryMB)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+
+    if (maxSessions >= 0) g_sessionPoolBudget.maxSessions = static_cast<size_t>(maxSessions);
+    if (maxMemoryMB >= 0) g_sessionPoolBudget.maxBytes = static_cast<size_t>(maxMemoryMB) * 1024 * 1024;
+    if (g_sessionPool) g_sessionPool->SetBudget(g_sessionPoolBudget);
+}
+
+WGC_API void ReleaseSessionPool()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    if (g_sessionPool) g_sessionPool->Clear();
+    g_pooledWindows.clear();
+}
+
+WGC_API int GetSessionPoolInfo(int* sessionCount, long long* memoryBytes,
+    unsigned long long* hits, unsigned long long* misses, unsigned long long* evictions)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+
+    if (!g_sessionPool) return 0;
+
+    SessionPoolStats stats = g_sessionPool->Stats();
+    if (sessionCount) *sessionCount = static_cast<int>(g_sessionPool->Size());
+    if (memoryBytes) *memoryBytes = static_cast<long long>(g_sessionPool->MemoryUsage());
+    if (hits) *hits = stats.hits;
+    if (misses) *misses = stats.misses;
+    if (evictions) *evictions = stats.evictions;
+    return 1;
+}
+
+// HDR 捕获
+WGC_API void SetHdrCapture(int enable)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    g_hdrCapture = enable != 0;
+}
+
+WGC_API int IsHdrCapture()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    return (g_capture && g_capture->IsCapturing() && g_capture->IsHdrCapture()) ? 1 : 0;
+}
+
+WGC_API void SetToneMapping(int toneMapOperator, float exposure, float whitePoint)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        g_toneMapParams.op = toneMapOperator;
+        g_toneMapParams.exposure = exposure;
+        g_toneMapParams.whitePoint = whitePoint;
+
+        if (g_capture) g_capture->SetToneMapParams(g_toneMapParams);
+    }
+    catch (...)
+    {
+    }
+}
+
+WGC_API int GetLatestFrameBGR(unsigned char** imageData, int* width, int* height)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        unsigned char* data = nullptr;
+        int w = 0, h = 0;
+
+        if (!g_capture->TryGetFrameBGR(&data, &w, &h)) return 0;
+
+        *imageData = data;
+        *width = w;
+        *height = h;
+
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 图像金字塔
+WGC_API int GetLatestFramePyramid(unsigned char** imageData, int levels, int includeFull,
+    int* widths, int* heights, long long* offsets, long long* totalBytes)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        unsigned char* data = nullptr;
+        PyramidLayout layout;
+
+        if (!g_capture->TryGetPyramid(&data, &layout, levels, includeFull != 0)) return 0;
+
+        for (int i = 0; i <= kMaxPyramidLevels; i++)
+        {
+            bool present = i <= layout.levels && (i > 0 || includeFull);
+            widths[i] = present ? layout.width[i] : 0;
+            heights[i] = present ? layout.height[i] : 0;
+            offsets[i] = present ? layout.offset[i] : -1;
+        }
+
+        *imageData = data;
+        if (totalBytes) *totalBytes = static_cast<long long>(layout.totalBytes);
+
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 帧统计
+WGC_API int GetFrameStats(int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        FrameRect roi{ roiX, roiY, roiWidth, roiHeight };
+        int flags = StatsFlagsFromOutputs(histogram, sums, minValues, maxValues);
+
+        auto stats = std::make_unique<FrameStatistics>();
+        if (!g_capture->ComputeFrameStats(roi, flags, stats.get())) return 0;
+
+        WriteStatsOutputs(*stats, histogram, sums, minValues, maxValues, pixelCount);
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+WGC_API int GetLatestFrameWithStats(unsigned char** imageData, int* width, int* height,
+    int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        FrameRect roi{ roiX, roiY, roiWidth, roiHeight };
+        auto acc = std::make_unique<FrameStatsAccumulator>(
+            StatsFlagsFromOutputs(histogram, sums, minValues, maxValues));
+
+        unsigned char* data = nullptr;
+        int w = 0, h = 0;
+
+        if (!g_capture->TryGetFrame(&data, &w, &h, acc.get(), roi)) return 0;
+
+        auto stats = std::make_unique<FrameStatistics>();
+        acc->Finalize(*stats);
+        WriteStatsOutputs(*stats, histogram, sums, minValues, maxValues, pixelCount);
+
+        *imageData = data;
+        *width = w;
+        *height = h;
+
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 融合读回
+WGC_API int GetLatestFrameProcessed(int cropX, int cropY, int cropWidth, int cropHeight, int format, int scale,
+    unsigned char** imageData, int* width, int* height, int* channels,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        if (format < PipelineBGRA || format > PipelineGray || (scale != 1 && scale != 2 && scale != 4))
+        {
+            SetLastErrorMsg("Invalid pipeline format or scale");
+            return 0;
+        }
+
+        PipelineRequest request;
+        request.crop = { cropX, cropY, cropWidth, cropHeight };
+        request.format = format;
+        request.scale = scale;
+        request.stats = StatsFlagsFromOutputs(histogram, sums, minValues, maxValues) != 0 || pixelCount;
+
+        auto stats = request.stats ? std::make_unique<FrameStatistics>() : nullptr;
+        unsigned char* data = nullptr;
+        PipelineLayout layout;
+
+        if (!g_capture->TryGetProcessed(request, &data, &layout, stats.get())) return 0;
+
+        *imageData = data;
+        *width = layout.width;
+        *height = layout.height;
+        if (channels) *channels = layout.channels;
+        if (stats) WriteStatsOutputs(*stats, histogram, sums, minValues, maxValues, pixelCount);
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 颜色分割
+static bool ParseColorRanges(int colorSpace, const unsigned char* ranges, int rangeCount,
+    std::vector<ColorRange>& out)
+{
+    if (colorSpace != ColorSpaceBGR && colorSpace != ColorSpaceHSV) {
+        SetLastErrorMsg("Invalid color space");
+        return false;
+    }
+    if (!ranges || rangeCount <= 0) {
+        SetLastErrorMsg("No color ranges");
+        return false;
+    }
+
+    out.resize(rangeCount);
+    for (int i = 0; i < rangeCount; i++) {
+        memcpy(out[i].lower, ranges + i * 6, 3);
+        memcpy(out[i].upper, ranges + i * 6 + 3, 3);
+    }
+    return true;
+}
+
+WGC_API int FindColorBlobs(int colorSpace, const unsigned char* ranges, int rangeCount,
+    int roiX, int roiY, int roiWidth, int roiHeight, int minArea, int connectivity,
+    int* boxes, float* centroids, int maxBlobs, int* blobCount)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::vector<ColorRange> parsed;
+        if (!ParseColorRanges(colorSpace, ranges, rangeCount, parsed)) return 0;
+
+        std::vector<ColorBlob> blobs;
+        {
+            std::lock_guard<std::mutex> lock(g_captureMutex);
+
+            if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+            FrameRect roi{ roiX, roiY, roiWidth, roiHeight };
+            bool ok = g_capture->ReadLatestFrame([&](const FrameView& frame) {
+                ::FindColorBlobs(frame, roi, colorSpace, parsed.data(), rangeCount,
+                    minArea, connectivity, blobs);
+            });
+            if (!ok) return 0;
+        }
+
+        int n = std::min(static_cast<int>(blobs.size()), std::max(maxBlobs, 0));
+        for (int i = 0; i < n; i++) {
+            const ColorBlob& b = blobs[i];
+            if (boxes) {
+                int* box = boxes + i * 5;
+                box[0] = b.x;
+                box[1] = b.y;
+                box[2] = b.width;
+                box[3] = b.height;
+                box[4] = b.area;
+            }
+            if (centroids) {
+                centroids[i * 2] = b.centroidX;
+                centroids[i * 2 + 1] = b.centroidY;
+            }
+        }
+        if (blobCount) *blobCount = static_cast<int>(blobs.size());
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+WGC_API int GetColorMask(int colorSpace, const unsigned char* ranges, int rangeCount,
+    int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned char** maskData, int* width, int* height)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::vector<ColorRange> parsed;
+        if (!ParseColorRanges(colorSpace, ranges, rangeCount, parsed)) return 0;
+
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        FrameRect roi{ roiX, roiY, roiWidth, roiHeight };
+        FrameRect clamped{};
+        std::vector<uint8_t> mask;
+        bool ok = g_capture->ReadLatestFrame([&](const FrameView& frame) {
+            clamped = roi.ClampTo(frame.width, frame.height);
+            if (clamped.IsEmpty()) return;
+            mask.resize(static_cast<size_t>(clamped.width) * clamped.height);
+            for (int y = 0; y < clamped.height; y++) {
+                ThresholdRow(frame.Row(clamped.y + y) + static_cast<size_t>(clamped.x) * 4,
+                    mask.data() + static_cast<size_t>(y) * clamped.width, clamped.width,
+                    colorSpace, parsed.data(), rangeCount);
+            }
+        });
+        if (!ok || mask.empty()) return 0;
+
+        *maskData = static_cast<unsigned char*>(CoTaskMemAlloc(mask.size()));
+        if (!*maskData) return 0;
+        memcpy(*maskData, mask.data(), mask.size());
+        *width = clamped.width;
+        *height = clamped.height;
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 感知哈希 / 画面识别
+WGC_API int ComputeFrameHash(unsigned long long* hash)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+        uint64_t h = 0;
+        if (!g_capture->ComputeFrameHash(&h)) return 0;
+
+        *hash = h;
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+WGC_API int ComputeImageHash(const unsigned char* imageData, int width, int height, unsigned long long* hash)
+{
+    WGC_TRACE_FUNCTION();
+    if (!imageData || width <= 0 || height <= 0 || !hash) return 0;
+
+    FrameView frame;
+    frame.data = imageData;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = static_cast<size_t>(width) * 4;
+
+    *hash = ComputeDHash(frame);
+    return 1;
+}
+
+WGC_API void AddReferenceHash(const char* label, unsigned long long hash)
+{
+    WGC_TRACE_FUNCTION();
+    if (!label) return;
+    std::lock_guard<std::mutex> lock(g_hashIndexMutex);
+    g_hashIndex.Add(label, hash);
+}
+
+WGC_API int RemoveReferenceHash(const char* label)
+{
+    WGC_TRACE_FUNCTION();
+    if (!label) return 0;
+    std::lock_guard<std::mutex> lock(g_hashIndexMutex);
+    return g_hashIndex.Remove(label);
+}
+
+WGC_API void ClearReferenceHashes()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_hashIndexMutex);
+    g_hashIndex.Clear();
+}
+
+WGC_API int GetReferenceHashCount()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_hashIndexMutex);
+    return static_cast<int>(g_hashIndex.Size());
+}
+
+WGC_API int ClassifyFrame(char* label, int labelSize, int* distance)
+{
+    WGC_TRACE_FUNCTION();
+    unsigned long long hash = 0;
+    if (!ComputeFrameHash(&hash)) return 0;
+
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_hashIndexMutex);
+
+        int d = -1;
+        int index = g_hashIndex.FindNearest(hash, &d);
+        if (index < 0) return 0;
+
+        if (label && labelSize > 0)
+        {
+            strncpy_s(label, labelSize, g_hashIndex.LabelAt(index).c_str(), _TRUNCATE);
+        }
+        if (distance) *distance = d;
+
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 帧历史
+WGC_API long long GetCaptureClockMs()
+{
+    WGC_TRACE_FUNCTION();
+    return CaptureClockMs();
+}
+
+WGC_API int EnableFrameHistory(int windowMs, int memoryBudgetMB, int keyframeInterval, int maxFps)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        if (!EnsureCaptureInitialized()) return 0;
+
+        std::lock_guard<std::mutex> historyLock(g_frameHistoryMutex);
+
+        if (g_frameHistoryListener)
+        {
+            g_capture->RemoveFrameListener(g_frameHistoryListener);
+            g_frameHistoryListener = 0;
+        }
+
+        FrameHistoryOptions options;
+        if (windowMs > 0) options.windowMs = windowMs;
+        if (memoryBudgetMB > 0) options.memoryBudget = static_cast<size_t>(memoryBudgetMB) * 1024 * 1024;
+        if (keyframeInterval > 0) options.keyframeInterval = keyframeInterval;
+        options.maxFps = maxFps;
+
+        g_frameHistory = std::make_unique<FrameHistory>(options);
+
+        FrameHistory* history = g_frameHistory.get();
+        g_frameHistoryListener = g_capture->AddFrameListener([history](const FrameView& frame, int64_t timestampMs) {
+            history->Submit(frame, timestampMs);
+        });
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API void DisableFrameHistory()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    std::lock_guard<std::mutex> historyLock(g_frameHistoryMutex);
+
+    if (g_capture && g_frameHistoryListener)
+    {
+        g_capture->RemoveFrameListener(g_frameHistoryListener);
+    }
+    g_frameHistoryListener = 0;
+    g_frameHistory = nullptr;
+}
+
+WGC_API int GetFrameHistoryInfo(int* frameCount, long long* oldestMs, long long* newestMs, long long* memoryBytes)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_frameHistoryMutex);
+
+    if (!g_frameHistory) return 0;
+
+    int64_t oldest = 0, newest = 0;
+    g_frameHistory->GetTimeRange(&oldest, &newest);
+
+    if (frameCount) *frameCount = static_cast<int>(g_frameHistory->FrameCount());
+    if (oldestMs) *oldestMs = oldest;
+    if (newestMs) *newestMs = newest;
+    if (memoryBytes) *memoryBytes = static_cast<long long>(g_frameHistory->MemoryUsage());
+
+    return 1;
+}
+
+WGC_API int ExtractFrameHistory(long long startMs, long long endMs, int maxFrames,
+    unsigned char** frames, long long** timestamps, int* count, int* width, int* height)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        // 只在取出条目引用时持锁, 解码期间压缩线程与 DisableFrameHistory 不受影响
+        FrameHistory::Range range;
+        {
+            std::lock_guard<std::mutex> lock(g_frameHistoryMutex);
+
+            if (!g_frameHistory) return 0;
+
+            size_t limit = maxFrames > 0 ? static_cast<size_t>(maxFrames) : FrameHistory::kDefaultChunkFrames;
+            if (!g_frameHistory->Snapshot(startMs, endMs, limit, range)) return 0;
+        }
+
+        size_t frameBytes = static_cast<size_t>(range.width) * range.height * 4;
+        size_t frameCount = range.FrameCount();
+
+        *frames = static_cast<unsigned char*>(CoTaskMemAlloc(frameBytes * frameCount));
+        *timestamps = static_cast<long long*>(CoTaskMemAlloc(sizeof(long long) * frameCount));
+        if (!*frames || !*timestamps)
+        {
+            if (*frames) CoTaskMemFree(*frames);
+            if (*timestamps) CoTaskMemFree(*timestamps);
+            *frames = nullptr;
+            *timestamps = nullptr;
+            SetLastErrorMsg("Out of memory");
+            return 0;
+        }
+
+        // 逐帧解码直接写入输出缓冲
+        size_t index = 0;
+        bool ok = FrameHistory::Decode(range, [&](const FrameView& frame, int64_t timestampMs) {
+            memcpy(*frames + index * frameBytes, frame.data, frameBytes);
+            (*timestamps)[index] = timestampMs;
+            index++;
+            return true;
+        });
+        if (!ok || index == 0)
+        {
+            CoTaskMemFree(*frames);
+            CoTaskMemFree(*timestamps);
+            *frames = nullptr;
+            *timestamps = nullptr;
+            SetLastErrorMsg("Frame history decode failed");
+            return 0;
+        }
+
+        *count = static_cast<int>(index);
+        *width = range.width;
+        *height = range.height;
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+// 触发条件
+static int RegisterTrigger(const TriggerSpec& spec)
+{
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+
+    if (!EnsureWinRTInitialized())
+    {
+        SetLastErrorMsg("WinRT init failed");
+        return 0;
+    }
+
+    if (!EnsureCaptureInitialized()) return 0;
+
+    int id = g_triggers.Add(spec);
+    if (!id)
+    {
+        SetLastErrorMsg("Invalid trigger parameters");
+        return 0;
+    }
+
+    if (!g_triggerListener)
+    {
+        // 读回线程只复制各条件的 ROI
+        g_triggerListener = g_capture->AddFrameListener(
+            [](const FrameView& frame, int64_t timestampMs) {
+                g_triggers.Evaluate(frame, timestampMs, 0, true);
+            },
+            [](std::vector<FrameRect>& regions) { g_triggers.CollectRegions(regions); });
+    }
+
+    // 画面静止时不会有新帧到达, 先用当前最新帧建立基准
+    if (g_capture->IsCapturing())
+    {
+        int64_t timestampMs = g_capture->GetLastFrameTimeMs();
+        g_capture->ReadLatestFrame([&](const FrameView& frame) {
+            g_triggers.Evaluate(frame, timestampMs, id);
+        });
+    }
+
+    return id;
+}
+
+static void DetachIdleTriggerListener()
+{
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+
+    if (g_capture && g_triggerListener && g_triggers.Size() == 0)
+    {
+        g_capture->RemoveFrameListener(g_triggerListener);
+        g_triggerListener = 0;
+    }
+}
+
+static void WriteTriggerEvent(const TriggerEvent& event, int* firedId, long long* timestampMs, double* score)
+{
+    if (firedId) *firedId = event.id;
+    if (timestampMs) *timestampMs = event.timestampMs;
+    if (score) *score = event.score;
+}
+
+WGC_API int AddMatchTrigger(int roiX, int roiY, int roiWidth, int roiHeight,
+    const unsigned char* reference, int referenceWidth, int referenceHeight,
+    int metric, double threshold, int oneShot)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        if (!reference || referenceWidth <= 0 || referenceHeight <= 0)
+        {
+            SetLastErrorMsg("Invalid reference image");
+            return 0;
+        }
+
+        TriggerSpec spec;
+        spec.kind = TriggerMatch;
+        spec.roi = { roiX, roiY, roiWidth, roiHeight };
+        spec.metric = metric;
+        spec.threshold = threshold;
+        spec.oneShot = oneShot != 0;
+        spec.reference.assign(reference, reference + static_cast<size_t>(referenceWidth) * referenceHeight * 4);
+        spec.referenceWidth = referenceWidth;
+        spec.referenceHeight = referenceHeight;
+        return RegisterTrigger(spec);
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int AddChangeTrigger(int roiX, int roiY, int roiWidth, int roiHeight, double threshold, int oneShot)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        TriggerSpec spec;
+        spec.kind = TriggerChanged;
+        spec.roi = { roiX, roiY, roiWidth, roiHeight };
+        spec.threshold = threshold;
+        spec.oneShot = oneShot != 0;
+        return RegisterTrigger(spec);
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int AddStableTrigger(int roiX, int roiY, int roiWidth, int roiHeight,
+    double threshold, int durationMs, int oneShot)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        TriggerSpec spec;
+        spec.kind = TriggerStable;
+        spec.roi = { roiX, roiY, roiWidth, roiHeight };
+        spec.threshold = threshold;
+        spec.durationMs = durationMs;
+        spec.oneShot = oneShot != 0;
+        return RegisterTrigger(spec);
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int RemoveTrigger(int triggerId)
+{
+    WGC_TRACE_FUNCTION();
+    bool removed = g_triggers.Remove(triggerId);
+    DetachIdleTriggerListener();
+    return removed ? 1 : 0;
+}
+
+WGC_API void ClearTriggers()
+{
+    WGC_TRACE_FUNCTION();
+    g_triggers.Clear();
+    DetachIdleTriggerListener();
+}
+
+WGC_API int WaitForTrigger(int triggerId, int timeoutMs, int* firedId, long long* timestampMs, double* score)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        TriggerEvent event;
+        bool fired = g_triggers.Wait(triggerId, timeoutMs, event);
+        // 一次性条件触发后已移除
+        DetachIdleTriggerListener();
+        if (!fired) return 0;
+
+        WriteTriggerEvent(event, firedId, timestampMs, score);
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+WGC_API int PollTrigger(int triggerId, int* firedId, long long* timestampMs, double* score)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        TriggerEvent event;
+        bool fired = g_triggers.Poll(triggerId, event);
+        DetachIdleTriggerListener();
+        if (!fired) return 0;
+
+        WriteTriggerEvent(event, firedId, timestampMs, score);
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+// 多窗口分时调度
+WGC_API int SchedulerAddTarget(const char* title, const char* className, int intervalMs, int priority)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_schedulerMutex);
+        SetLastErrorMsg("");
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        HWND hwnd = FindTargetWindow(title, className);
+        if (!hwnd)
+        {
+            SetLastErrorMsg("Window not found");
+            return 0;
+        }
+
+        if (!g_scheduler) g_scheduler = std::make_unique<WGCCaptureScheduler>();
+
+        std::string err;
+        int targetId = g_scheduler->AddTarget(hwnd, intervalMs, priority, &err);
+        if (!targetId)
+        {
+            SetLastErrorMsg("Add target failed: " + err);
+            return 0;
+        }
+
+        return targetId;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API void SchedulerRemoveTarget(int targetId)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    if (g_scheduler) g_scheduler->RemoveTarget(targetId);
+}
+
+WGC_API void SchedulerSetBudget(double maxCopiesPerSec, double maxBytesPerSec, int maxConcurrent, int grabTimeoutMs)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    if (!g_scheduler) g_scheduler = std::make_unique<WGCCaptureScheduler>();
+
+    SchedulerBudget budget;
+    budget.maxCopiesPerSec = maxCopiesPerSec;
+    budget.maxBytesPerSec = maxBytesPerSec;
+    if (maxConcurrent > 0) budget.maxConcurrent = maxConcurrent;
+    if (grabTimeoutMs > 0) budget.grabTimeoutMs = grabTimeoutMs;
+    g_scheduler->SetBudget(budget);
+}
+
+WGC_API int SchedulerStart()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    if (!g_scheduler) return 0;
+    g_scheduler->Start();
+    return 1;
+}
+
+WGC_API void SchedulerStop()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    if (g_scheduler) g_scheduler->Stop();
+}
+
+WGC_API void SchedulerRelease()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+    g_scheduler = nullptr;
+}
+
+WGC_API int SchedulerGetFrame(int targetId, unsigned char** imageData, int* width, int* height,
+    long long* timestampMs, unsigned long long* sequence)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_schedulerMutex);
+
+        if (!g_scheduler) return 0;
+
+        FrameSlot slot;
+        if (!g_scheduler->CopyFrame(targetId, slot)) return 0;
+
+        *imageData = static_cast<unsigned char*>(CoTaskMemAlloc(slot.data.size()));
+        if (!*imageData) return 0;
+        memcpy(*imageData, slot.data.data(), slot.data.size());
+
+        *width = slot.width;
+        *height = slot.height;
+        if (timestampMs) *timestampMs = slot.timestampMs;
+        if (sequence) *sequence = slot.sequence;
+
+        return 1;
+    }
+    catch (...)
+    {
+        return 0;
+    }
+}
+
+WGC_API int SchedulerGetStats(unsigned long long* grabs, unsigned long long* timeouts,
+    unsigned long long* bytes, unsigned long long* throttled)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_schedulerMutex);
+
+    if (!g_scheduler) return 0;
+
+    SchedulerStats stats = g_scheduler->Stats();
+    if (grabs) *grabs = stats.grabs;
+    if (timeouts) *timeouts = stats.timeouts;
+    if (bytes) *bytes = stats.bytes;
+    if (throttled) *throttled = stats.throttled;
+
+    return 1;
+}
+
+// 异步截图保存
+static FrameSaver& EnsureFrameSaver()
+{
+    std::lock_guard<std::mutex> lock(g_frameSaverMutex);
+    if (!g_frameSaver) g_frameSaver = std::make_unique<FrameSaver>();
+    return *g_frameSaver;
+}
+
+WGC_API int SaveFrameAsync(const char* path, int format)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        if (!path || !*path)
+        {
+            SetLastErrorMsg("Invalid path");
+            return 0;
+        }
+
+        if (format != ImageFormatQoi && format != ImageFormatPng)
+        {
+            SetLastErrorMsg("Invalid image format");
+            return 0;
+        }
+
+        FrameSaver& saver = EnsureFrameSaver();
+        std::vector<uint8_t> pixels;
+        int w = 0, h = 0;
+        {
+            std::lock_guard<std::mutex> lock(g_captureMutex);
+
+            if (!g_capture || !g_capture->IsCapturing()) return 0;
+
+            bool ok = g_capture->ReadLatestFrame([&](const FrameView& frame) {
+                WGC_TRACE_SCOPE("SnapshotCopy");
+                size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+                pixels = saver.AcquireBuffer(rowBytes * frame.height);
+                for (int y = 0; y < frame.height; y++)
+                {
+                    memcpy(pixels.data() + y * rowBytes, frame.Row(y), rowBytes);
+                }
+                w = frame.width;
+                h = frame.height;
+            });
+            if (!ok) return 0;
+        }
+
+        return saver.Submit(std::move(pixels), w, h, path, format, false);
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int GetSaveStatus(int jobId)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_frameSaverMutex);
+        return g_frameSaver ? g_frameSaver->Status(jobId) : SaveStatusUnknown;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return SaveStatusUnknown;
+    }
+}
+
+WGC_API int WaitForSave(int jobId, int timeoutMs)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        FrameSaver* saver = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(g_frameSaverMutex);
+            saver = g_frameSaver.get();
+        }
+        // 保存器创建后常驻, 等待时不持有全局锁
+        return saver ? saver->Wait(jobId, timeoutMs) : SaveStatusUnknown;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return SaveStatusUnknown;
+    }
+}
+
+WGC_API void SetSaveCallback(WGCSaveCallback callback)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        FrameSaver::Callback wrapped;
+        if (callback)
+        {
+            wrapped = [callback](int jobId, bool success) { callback(jobId, success ? 1 : 0); };
+        }
+        // 首次调用会创建保存器及其线程, 可能抛出 std::system_error
+        EnsureFrameSaver().SetCallback(std::move(wrapped));
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Failed to set save callback");
+    }
+}
+
+// 滚动检测与长图拼接
+static void WriteScrollBand(const FrameRect& band, int* out)
+{
+    if (!out) return;
+    out[0] = band.x;
+    out[1] = band.y;
+    out[2] = band.width;
+    out[3] = band.height;
+}
+
+WGC_API int EnableScrollTracking(int roiX, int roiY, int roiWidth, int roiHeight, int axes, int stitch, int maxStitchMB,
+    int maxLostFrames)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        if (axes < ScrollAxisVertical || axes > ScrollAxisBoth)
+        {
+            SetLastErrorMsg("Invalid scroll axes");
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        if (!EnsureCaptureInitialized()) return 0;
+
+        std::lock_guard<std::mutex> scrollLock(g_scrollMutex);
+
+        if (g_scrollListener)
+        {
+            g_capture->RemoveFrameListener(g_scrollListener);
+            g_scrollListener = 0;
+        }
+
+        size_t maxBytes = maxStitchMB > 0 ? static_cast<size_t>(maxStitchMB) * 1024 * 1024 : 256ull * 1024 * 1024;
+        g_scrollTracker = std::make_unique<ScrollTracker>(FrameRect{ roiX, roiY, roiWidth, roiHeight },
+            axes, stitch != 0, maxBytes, maxLostFrames);
+
+        ScrollTracker* tracker = g_scrollTracker.get();
+        FrameRect roi{ roiX, roiY, roiWidth, roiHeight };
+        g_scrollListener = g_capture->AddFrameListener(
+            [tracker](const FrameView& frame, int64_t timestampMs) {
+                WGC_TRACE_SCOPE("ScrollTrack");
+                tracker->Submit(frame, timestampMs);
+            },
+            [roi](std::vector<FrameRect>& regions) { regions.push_back(roi); });
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API void DisableScrollTracking()
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_captureMutex);
+    std::lock_guard<std::mutex> scrollLock(g_scrollMutex);
+
+    if (g_capture && g_scrollListener)
+    {
+        g_capture->RemoveFrameListener(g_scrollListener);
+    }
+    g_scrollListener = 0;
+    g_scrollTracker = nullptr;
+}
+
+WGC_API int GetScrollState(int* dx, int* dy, float* confidence, int* band,
+    long long* totalX, long long* totalY, long long* timestampMs, int* lostFrames, int* restarts,
+    int* canvasPending, int* canvasTruncated, int* canvasResets)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_scrollMutex);
+
+    if (!g_scrollTracker) return 0;
+
+    ScrollState state = g_scrollTracker->State();
+    if (dx) *dx = state.last.dx;
+    if (dy) *dy = state.last.dy;
+    if (confidence) *confidence = state.last.confidence;
+    WriteScrollBand(state.last.newBand, band);
+    if (totalX) *totalX = state.totalX;
+    if (totalY) *totalY = state.totalY;
+    if (timestampMs) *timestampMs = state.timestampMs;
+    if (lostFrames) *lostFrames = state.lostFrames;
+    if (restarts) *restarts = state.restarts;
+    if (canvasPending) *canvasPending = state.canvasPending ? 1 : 0;
+    if (canvasTruncated) *canvasTruncated = state.canvasTruncated ? 1 : 0;
+    if (canvasResets) *canvasResets = state.canvasResets;
+
+    return 1;
+}
+
+WGC_API int GetStitchedImage(unsigned char** imageData, int* width, int* height)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_scrollMutex);
+
+        if (!g_scrollTracker) return 0;
+
+        std::vector<uint8_t> pixels;
+        int w = 0, h = 0;
+        if (!g_scrollTracker->TakeStitched(pixels, &w, &h)) return 0;
+
+        *imageData = static_cast<unsigned char*>(CoTaskMemAlloc(pixels.size()));
+        if (!*imageData)
+        {
+            SetLastErrorMsg("Out of memory");
+            return 0;
+        }
+
+        memcpy(*imageData, pixels.data(), pixels.size());
+        *width = w;
+        *height = h;
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int DetectScrollOffset(const unsigned char* previous, const unsigned char* current, int width, int height,
+    int roiX, int roiY, int roiWidth, int roiHeight, int axes, int* dx, int* dy, float* confidence, int* band)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        if (!previous || !current || width <= 0 || height <= 0) return 0;
+
+        FrameView prevFrame;
+        prevFrame.data = previous;
+        prevFrame.width = width;
+        prevFrame.height = height;
+        prevFrame.stride = static_cast<size_t>(width) * 4;
+
+        FrameView curFrame = prevFrame;
+        curFrame.data = current;
+
+        FrameRect roi = FrameRect{ roiX, roiY, roiWidth, roiHeight }.ClampTo(width, height);
+        ScrollResult result = DetectScroll(prevFrame, curFrame, roi, axes);
+
+        if (dx) *dx = result.dx;
+        if (dy) *dy = result.dy;
+        if (confidence) *confidence = result.confidence;
+        WriteScrollBand(result.newBand, band);
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+// 积分图
+static void UpdateIntegralImage(const FrameView& frame, int64_t timestampMs)
+{
+    WGC_TRACE_SCOPE("IntegralImage");
+    std::lock_guard<std::mutex> lock(g_integralMutex);
+    if (!g_integralImage) return;
+
+    g_integralUpdatedBands = g_integralImage->Update(frame);
+    g_integralTimestampMs = timestampMs;
+}
+
+WGC_API int EnableIntegralImage()
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+
+        if (!EnsureWinRTInitialized())
+        {
+            SetLastErrorMsg("WinRT init failed");
+            return 0;
+        }
+
+        if (!EnsureCaptureInitialized()) return 0;
+
+        if (g_integralListener) return 1;
+
+        {
+            std::lock_guard<std::mutex> integralLock(g_integralMutex);
+            g_integralImage = std::make_unique<IntegralImage>();
+            g_integralTimestampMs = 0;
+            g_integralUpdatedBands = 0;
+        }
+
+        // 监听者在持有 g_integralMutex 时被调用, 增删监听者时不能持有该锁
+        g_integralListener = g_capture->AddFrameListener(UpdateIntegralImage);
+
+        // 画面静止时不会有新帧到达, 先用当前最新帧建立积分图
+        if (g_capture->IsCapturing())
+        {
+            int64_t timestampMs = g_capture->GetLastFrameTimeMs();
+            g_capture->ReadLatestFrame([&](const FrameView& frame) {
+                UpdateIntegralImage(frame, timestampMs);
+            });
+        }
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API void DisableIntegralImage()
+{
+    WGC_TRACE_FUNCTION();
+    {
+        std::lock_guard<std::mutex> lock(g_captureMutex);
+        if (g_capture && g_integralListener)
+        {
+            g_capture->RemoveFrameListener(g_integralListener);
+        }
+        g_integralListener = 0;
+    }
+
+    std::lock_guard<std::mutex> integralLock(g_integralMutex);
+    g_integralImage = nullptr;
+}
+
+WGC_API int QueryRegionStats(const int* rects, int count, float* means, float* variances, long long* timestampMs)
+{
+    WGC_TRACE_FUNCTION();
+    try
+    {
+        if (!rects || count < 0) return 0;
+
+        std::vector<FrameRect> regions(count);
+        for (int i = 0; i < count; i++)
+        {
+            const int* r = rects + static_cast<size_t>(i) * 4;
+            regions[i] = FrameRect{ r[0], r[1], r[2], r[3] };
+        }
+
+        std::lock_guard<std::mutex> lock(g_integralMutex);
+
+        if (!g_integralImage || g_integralImage->IsEmpty()) return 0;
+
+        g_integralImage->QueryBatch(regions.data(), regions.size(), means, variances);
+
+        if (timestampMs) *timestampMs = g_integralTimestampMs;
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
+
+WGC_API int GetIntegralImageInfo(int* width, int* height, int* updatedBands, long long* timestampMs)
+{
+    WGC_TRACE_FUNCTION();
+    std::lock_guard<std::mutex> lock(g_integralMutex);
+
+    if (!g_integralImage || g_integralImage->IsEmpty()) return 0;
+
+    if (width) *width = g_integralImage->Width();
+    if (height) *height = g_integralImage->Height();
+    if (updatedBands) *updatedBands = g_integralUpdatedBands;
+    if (timestampMs) *timestampMs = g_integralTimestampMs;
+
+    return 1;
+}
+
+// 时间线追踪
+WGC_API void EnableTracing(int enable)
+{
+    SetTraceEnabled(enable != 0);
+}
+
+WGC_API int IsTracing()
+{
+    return IsTraceEnabled() ? 1 : 0;
+}
+
+WGC_API void ResetTrace()
+{
+    ClearTrace();
+}
+
+WGC_API int DumpTrace(const char* path)
+{
+    try
+    {
+        if (!path) return 0;
+
+        std::string json = SerializeChromeTrace();
+
+        FILE* file = nullptr;
+        if (_wfopen_s(&file, UTF8ToWString(path).c_str(), L"wb") != 0 || !file)
+        {
+            SetLastErrorMsg("Failed to open trace file");
+            return 0;
+        }
+
+        size_t written = fwrite(json.data(), 1, json.size(), file);
+        fclose(file);
+
+        if (written != json.size())
+        {
+            SetLastErrorMsg("Failed to write trace file");
+            return 0;
+        }
+
+        return 1;
+    }
+    catch (...)
+    {
+        SetLastErrorMsg("Unknown exception");
+        return 0;
+    }
+}
@@ -27,6 +27,145 @@ WGC_API void PauseCapture();
 WGC_API void ResumeCapture();
 WGC_API int IsPaused();
 
+// 预热会话池: 按窗口保留暂停的捕获会话, SwitchToWindow 只需恢复 (未预热时现场创建)
+// 切换时原活动会话放回池中, 帧历史/触发条件随活动会话转移; 超出预算按 LRU 淘汰
+// 命中时若窗口已关闭或句柄已属于另一窗口 (标题/类名不同), 丢弃旧会话 (计为淘汰) 并重建
+// maxSessions/maxMemoryMB 小于 0 表示保持原值; 预算只统计池中空闲会话
+WGC_API int PrewarmWindow(const char* title, const char* className);
+WGC_API int SwitchToWindow(const char* title, const char* className);
+WGC_API void SetSessionPoolBudget(int maxSessions, int maxMemoryMB);
+WGC_API void ReleaseSessionPool();
+WGC_API int GetSessionPoolInfo(int* sessionCount, long long* memoryBytes,
+    unsigned long long* hits, unsigned long long* misses, unsigned long long* evictions);
+
+// HDR 捕获 (R16G16B16A16Float), 下次启动捕获时生效; 读回时色调映射为 8 位
+// toneMapOperator: 0 截断, 1 Reinhard, 2 ACES
+WGC_API void SetHdrCapture(int enable);
+WGC_API int IsHdrCapture();
+WGC_API void SetToneMapping(int toneMapOperator, float exposure, float whitePoint);
+WGC_API int GetLatestFrameBGR(unsigned char** imageData, int* width, int* height);
+
+// 图像金字塔: 原图 (可选) + 1/2, 1/4, 1/8 连续存放, 用 FreeImageData 释放
+// widths/heights/offsets 长度为 4, 下标 0 为原图 (不包含原图时 offsets[0] 为 -1)
+WGC_API int GetLatestFramePyramid(unsigned char** imageData, int levels, int includeFull,
+    int* widths, int* heights, long long* offsets, long long* totalBytes);
+
+// 帧统计 (直方图/总和/最值), 输出数组为 NULL 时跳过对应统计量
+// histogram: 4x256 (BGRA), sums/minValues/maxValues: 4; roiWidth/roiHeight <= 0 表示整帧
+WGC_API int GetFrameStats(int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount);
+WGC_API int GetLatestFrameWithStats(unsigned char** imageData, int* width, int* height,
+    int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount);
+
+// 颜色分割: ranges 每 6 字节为一个区间 (lower[3], upper[3]), 多个区间取并集
+// colorSpace: 0 BGR, 1 HSV (H 0-179, lower H > upper H 表示跨越 0)
+// boxes 每个连通域 5 个 int (x, y, width, height, area), centroids 每个 2 个 float; 按面积降序
+// blobCount 返回满足 minArea 的总数, 可能大于 maxBlobs; connectivity 为 4 或 8
+WGC_API int FindColorBlobs(int colorSpace, const unsigned char* ranges, int rangeCount,
+    int roiX, int roiY, int roiWidth, int roiHeight, int minArea, int connectivity,
+    int* boxes, float* centroids, int maxBlobs, int* blobCount);
+WGC_API int GetColorMask(int colorSpace, const unsigned char* ranges, int rangeCount,
+    int roiX, int roiY, int roiWidth, int roiHeight,
+    unsigned char** maskData, int* width, int* height);
+
+// 融合读回: 裁剪 -> 格式转换 -> 缩小 -> 统计一遍完成, 用 FreeImageData 释放
+// format: 0 BGRA, 1 BGR, 2 灰度; scale: 1, 2, 4; 统计输出全为 NULL 时不计算统计量
+// 统计量针对输出图像, 按输出通道顺序填写, 其余通道为 0
+WGC_API int GetLatestFrameProcessed(int cropX, int cropY, int cropWidth, int cropHeight, int format, int scale,
+    unsigned char** imageData, int* width, int* height, int* channels,
+    unsigned int* histogram, unsigned long long* sums,
+    unsigned char* minValues, unsigned char* maxValues, unsigned long long* pixelCount);
+
+// 感知哈希 / 画面识别
+WGC_API int ComputeFrameHash(unsigned long long* hash);
+WGC_API int ComputeImageHash(const unsigned char* imageData, int width, int height, unsigned long long* hash);
+WGC_API void AddReferenceHash(const char* label, unsigned long long hash);
+WGC_API int RemoveReferenceHash(const char* label);
+WGC_API void ClearReferenceHashes();
+WGC_API int GetReferenceHashCount();
+WGC_API int ClassifyFrame(char* label, int labelSize, int* distance);
+
+// 帧历史 (最近 N 秒的压缩帧环), 时间戳单位为毫秒, 与 GetCaptureClockMs 同一时钟
+WGC_API long long GetCaptureClockMs();
+WGC_API int EnableFrameHistory(int windowMs, int memoryBudgetMB, int keyframeInterval, int maxFps);
+WGC_API void DisableFrameHistory();
+WGC_API int GetFrameHistoryInfo(int* frameCount, long long* oldestMs, long long* newestMs, long long* memoryBytes);
+// 每次最多解码 maxFrames 帧 (<= 0 取默认 8), count 等于上限时从最后一帧时间戳 + 1 继续读取
+WGC_API int ExtractFrameHistory(long long startMs, long long endMs, int maxFrames,
+    unsigned char** frames, long long** timestamps, int* count, int* width, int* height);
+
+// 帧到达时评估的触发条件, 替代 Python 端轮询; 成功返回条件 ID (> 0), 失败返回 0
+// Match: reference 为与 ROI 同尺寸的 BGRA; metric 0 为 MAE (<= threshold), 1 为亮度 SSIM (>= threshold)
+// Changed: ROI 相对基准的 MAE 超过 threshold; Stable: 相邻帧 MAE 不超过 threshold 持续 durationMs
+// oneShot 非 0 时触发一次后自动移除
+WGC_API int AddMatchTrigger(int roiX, int roiY, int roiWidth, int roiHeight,
+    const unsigned char* reference, int referenceWidth, int referenceHeight,
+    int metric, double threshold, int oneShot);
+WGC_API int AddChangeTrigger(int roiX, int roiY, int roiWidth, int roiHeight, double threshold, int oneShot);
+WGC_API int AddStableTrigger(int roiX, int roiY, int roiWidth, int roiHeight,
+    double threshold, int durationMs, int oneShot);
+WGC_API int RemoveTrigger(int triggerId);
+WGC_API void ClearTriggers();
+// triggerId 为 0 表示任意条件; timeoutMs < 0 表示一直等待; 超时/被 ClearTriggers 取消时返回 0
+WGC_API int WaitForTrigger(int triggerId, int timeoutMs, int* firedId, long long* timestampMs, double* score);
+WGC_API int PollTrigger(int triggerId, int* firedId, long long* timestampMs, double* score);
+
+// 多窗口分时调度: 每个目标常驻一个暂停的会话, 按优先级/截止时间轮流恢复取帧
+WGC_API int SchedulerAddTarget(const char* title, const char* className, int intervalMs, int priority);
+WGC_API void SchedulerRemoveTarget(int targetId);
+WGC_API void SchedulerSetBudget(double maxCopiesPerSec, double maxBytesPerSec, int maxConcurrent, int grabTimeoutMs);
+WGC_API int SchedulerStart();
+// Stop 只停止调度线程, 目标与已取到的帧保留, 可再次 Start; Release 关闭全部会话并清空目标
+WGC_API void SchedulerStop();
+WGC_API void SchedulerRelease();
+WGC_API int SchedulerGetFrame(int targetId, unsigned char** imageData, int* width, int* height,
+    long long* timestampMs, unsigned long long* sequence);
+WGC_API int SchedulerGetStats(unsigned long long* grabs, unsigned long long* timeouts,
+    unsigned long long* bytes, unsigned long long* throttled);
+
+// 异步截图保存: 拷贝最新帧后立即返回任务 ID (失败返回 0), 编码与写盘在后台线程池完成
+// format: 0 QOI, 1 PNG (按行条带并行压缩); 状态: 0 未知, 1 进行中, 2 完成, 3 失败
+// 回调在后台线程上调用
+typedef void (*WGCSaveCallback)(int jobId, int success);
+WGC_API int SaveFrameAsync(const char* path, int format);
+WGC_API int GetSaveStatus(int jobId);
+WGC_API int WaitForSave(int jobId, int timeoutMs);
+WGC_API void SetSaveCallback(WGCSaveCallback callback);
+
+// 滚动检测: 行/列哈希投票求相邻帧的偏移, 当前帧 (x, y) 对应上一帧 (x + dx, y + dy)
+// axes: 1 垂直, 2 水平, 3 两者; band 输出新露出区域 (x, y, width, height)
+// ROI 应只覆盖滚动区域; stitch 非 0 时增量拼接长图, maxStitchMB <= 0 取默认 256MB
+// 连续 maxLostFrames 帧无法对齐时以当前帧重新开始 (累计偏移与画布重置, restarts 加 1), <= 0 取默认 30
+// 重新开始前的画布保留到 GetStitchedImage 取走 (canvasPending 为 1); 未取走又被替换时 canvasResets 加 1
+// canvasTruncated 为 1 表示下次取得的画布因 maxStitchMB 上限缺失了部分区域
+WGC_API int EnableScrollTracking(int roiX, int roiY, int roiWidth, int roiHeight, int axes, int stitch, int maxStitchMB,
+    int maxLostFrames);
+WGC_API void DisableScrollTracking();
+WGC_API int GetScrollState(int* dx, int* dy, float* confidence, int* band,
+    long long* totalX, long long* totalY, long long* timestampMs, int* lostFrames, int* restarts,
+    int* canvasPending, int* canvasTruncated, int* canvasResets);
+// 有保留的画布时返回并释放它, 否则返回当前画布
+WGC_API int GetStitchedImage(unsigned char** imageData, int* width, int* height);
+// 两张同尺寸 BGRA 图之间的偏移; 无法对齐时 confidence 为 0
+WGC_API int DetectScrollOffset(const unsigned char* previous, const unsigned char* current, int width, int height,
+    int roiX, int roiY, int roiWidth, int roiHeight, int axes, int* dx, int* dy, float* confidence, int* band);
+
+// 积分图: 随帧增量维护最新帧亮度的和与平方和 (只重算变化的条带), 区域均值/方差为 O(1) 查询
+// rects 为 count 组 (x, y, width, height), 宽高 <= 0 表示整帧; 完全在帧外的区域输出 0
+WGC_API int EnableIntegralImage();
+WGC_API void DisableIntegralImage();
+WGC_API int QueryRegionStats(const int* rects, int count, float* means, float* variances, long long* timestampMs);
+WGC_API int GetIntegralImageInfo(int* width, int* height, int* updatedBands, long long* timestampMs);
+
+// 时间线追踪 (Chrome/Perfetto trace JSON)
+WGC_API void EnableTracing(int enable);
+WGC_API int IsTracing();
+WGC_API void ResetTrace();
+WGC_API int DumpTrace(const char* path);
+
 // 错误信息
 WGC_API const char* GetLastErrorMsg();
 
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "WGCWindowCapture.h"
+#include "PerceptualHash.h"
+#include "TraceEvents.h"
 #include <sstream>
 
 namespace
@@ -22,7 +24,7 @@ WGCWindowCapture::~WGCWindowCapture()
     Cleanup();
 }
 
-bool WGCWindowCapture::Initialize(std::string* outError)
+bool WGCWindowCapture::Initialize(std::string* outError, ID3D11Device* sharedDevice)
 {
     auto setError = [&](const std::string& msg) {
         if (outError) *outError = msg;
@@ -33,7 +35,12 @@ bool WGCWindowCapture::Initialize(std::string* outError)
     }
 
     try {
-        auto d3dDevice = util::CreateD3D11Device();
+        winrt::com_ptr<ID3D11Device> d3dDevice;
+        if (sharedDevice) {
+            d3dDevice.copy_from(sharedDevice);
+        } else {
+            d3dDevice = util::CreateD3D11Device();
+        }
         if (!d3dDevice) {
             setError("Failed to create D3D11 device");
             return false;
@@ -93,7 +100,7 @@ bool WGCWindowCapture::CreateTextures(UINT width, UINT height)
     desc.Height = height;
     desc.MipLevels = 1;
     desc.ArraySize = 1;
-    desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    desc.Format = m_hdrActive ? DXGI_FORMAT_R16G16B16A16_FLOAT : DXGI_FORMAT_B8G8R8A8_UNORM;
     desc.SampleDesc.Count = 1;
     desc.Usage = D3D11_USAGE_STAGING;
     desc.BindFlags = 0;
@@ -141,6 +148,12 @@ bool WGCWindowCapture::StartContinuousCapture(HWND hwnd, std::string* outError)
             return false;
         }
 
+        m_hdrActive = m_hdrRequested;
+        if (m_hdrActive) {
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            if (!m_hdrConverter) m_hdrConverter = std::make_unique<HdrConverter>();
+        }
+
         if (!CreateTextures(size.Width, size.Height)) {
             setError("Failed to create textures");
             return false;
@@ -148,7 +161,7 @@ bool WGCWindowCapture::StartContinuousCapture(HWND hwnd, std::string* outError)
 
         m_framePool = winrt::Direct3D11CaptureFramePool::CreateFreeThreaded(
             m_device,
-            winrt::DirectXPixelFormat::B8G8R8A8UIntNormalized,
+            m_hdrActive ? winrt::DirectXPixelFormat::R16G16B16A16Float : winrt::DirectXPixelFormat::B8G8R8A8UIntNormalized,
             2,
             size);
         
@@ -166,6 +179,7 @@ bool WGCWindowCapture::StartContinuousCapture(HWND hwnd, std::string* outError)
         }
 
         m_framePool.FrameArrived([this](winrt::Direct3D11CaptureFramePool const& sender, winrt::IInspectable const&) {
+            WGC_TRACE_SCOPE("FrameArrived");
             winrt::Direct3D11CaptureFrame frame = sender.TryGetNextFrame();
             if (!frame) return;
 
@@ -177,21 +191,40 @@ bool WGCWindowCapture::StartContinuousCapture(HWND hwnd, std::string* outError)
 
             std::lock_guard<std::mutex> lock(m_frameMutex);
             
-            if (m_isPaused) return;
+            if (m_isPaused) {
+                if (m_retainWhilePaused) {
+                    // 替换后旧帧归还帧池
+                    m_pausedFrame = frame;
+                    m_pausedTexture = surfaceTexture;
+                    m_pausedFrameTimeMs = CaptureClockMs();
+                }
+                return;
+            }
             
             int idx = m_currentStagingIndex;
             if (m_stagingTextures[idx]) {
+                WGC_TRACE_SCOPE("CopyResource");
                 m_d3dContext->CopyResource(m_stagingTextures[idx].get(), surfaceTexture.get());
                 m_readableStagingIndex = idx;
                 m_currentStagingIndex = 1 - idx;
             }
             
             m_frameCount++;
+            m_lastFrameTimeMs = CaptureClockMs();
+            m_frameCv.notify_one();
         });
 
         m_session.StartCapture();
+        m_hwnd = hwnd;
         m_isCapturing = true;
         m_isPaused = false;
+
+        {
+            // 读回线程只在有监听者时启动, 调度器持有的大量暂停会话不额外占用线程
+            std::lock_guard<std::mutex> listenerLock(m_listenerMutex);
+            m_stopReadback = false;
+            if (!m_listeners.empty()) StartReadbackThreadLocked();
+        }
         return true;
     } catch (const winrt::hresult_error& e) {
         std::stringstream ss;
@@ -212,7 +245,8 @@ void WGCWindowCapture::PauseCapture()
     if (m_isPaused) return;
 
     m_isPaused = true;
-    m_readableStagingIndex = -1;
+    // 保留模式下暂停前的最后一帧仍在暂存纹理中, 静止窗口恢复后无需等待新帧即可读取
+    if (!m_retainWhilePaused) m_readableStagingIndex = -1;
 }
 
 void WGCWindowCapture::ResumeCapture()
@@ -223,6 +257,20 @@ void WGCWindowCapture::ResumeCapture()
     if (!m_isPaused) return;
 
     m_isPaused = false;
+
+    if (m_pausedTexture) {
+        int idx = m_currentStagingIndex;
+        if (m_stagingTextures[idx]) {
+            m_d3dContext->CopyResource(m_stagingTextures[idx].get(), m_pausedTexture.get());
+            m_readableStagingIndex = idx;
+            m_currentStagingIndex = 1 - idx;
+            m_frameCount++;
+            m_lastFrameTimeMs = m_pausedFrameTimeMs;
+            m_frameCv.notify_one();
+        }
+        m_pausedTexture = nullptr;
+        m_pausedFrame = nullptr;
+    }
 }
 
 void WGCWindowCapture::StopContinuousCapture()
@@ -232,6 +280,15 @@ void WGCWindowCapture::StopContinuousCapture()
     m_isCapturing = false;
     m_isPaused = false;
 
+    {
+        std::lock_guard<std::mutex> listenerLock(m_listenerMutex);
+        m_stopReadback = true;
+    }
+    m_frameCv.notify_all();
+    if (m_readbackThread.joinable()) {
+        m_readbackThread.join();
+    }
+
     if (m_session) {
         try { m_session.Close(); } catch (...) {}
         m_session = nullptr;
@@ -245,6 +302,9 @@ void WGCWindowCapture::StopContinuousCapture()
     m_captureItem = nullptr;
 
     std::lock_guard<std::mutex> lock(m_frameMutex);
+    m_pausedTexture = nullptr;
+    m_pausedFrame = nullptr;
+    m_hwnd = nullptr;
     for (int i = 0; i < 2; i++) {
         m_stagingTextures[i] = nullptr;
     }
@@ -254,7 +314,14 @@ void WGCWindowCapture::StopContinuousCapture()
     m_readableStagingIndex = -1;
 }
 
-bool WGCWindowCapture::TryGetFrame(unsigned char** outData, int* outWidth, int* outHeight)
+void WGCWindowCapture::SetToneMapParams(const ToneMapParams& params)
+{
+    auto converter = std::make_unique<HdrConverter>(params);
+    std::lock_guard<std::mutex> lock(m_frameMutex);
+    m_hdrConverter = std::move(converter);
+}
+
+bool WGCWindowCapture::ReadMappedFrame(const std::function<void(const FrameView&)>& reader)
 {
     if (m_isPaused) return false;
     
@@ -267,28 +334,280 @@ bool WGCWindowCapture::TryGetFrame(unsigned char** outData, int* outWidth, int*
     auto& stagingTexture = m_stagingTextures[m_readableStagingIndex];
     
     D3D11_MAPPED_SUBRESOURCE mapped = {};
-    HRESULT hr = m_d3dContext->Map(stagingTexture.get(), 0, D3D11_MAP_READ, 0, &mapped);
+    HRESULT hr;
+    {
+        WGC_TRACE_SCOPE("Map");
+        hr = m_d3dContext->Map(stagingTexture.get(), 0, D3D11_MAP_READ, 0, &mapped);
+    }
     if (FAILED(hr)) return false;
 
-    size_t dataSize = m_textureWidth * m_textureHeight * 4;
+    FrameView view;
+    view.data = static_cast<const uint8_t*>(mapped.pData);
+    view.width = m_textureWidth;
+    view.height = m_textureHeight;
+    view.stride = mapped.RowPitch;
 
-    *outData = static_cast<unsigned char*>(CoTaskMemAlloc(dataSize));
-    if (!*outData) {
+    try {
+        reader(view);
+    } catch (...) {
         m_d3dContext->Unmap(stagingTexture.get(), 0);
-        return false;
+        throw;
+    }
+
+    WGC_TRACE_SCOPE("Unmap");
+    m_d3dContext->Unmap(stagingTexture.get(), 0);
+    return true;
+}
+
+bool WGCWindowCapture::ReadLatestFrame(const std::function<void(const FrameView&)>& reader)
+{
+    if (!m_hdrActive) return ReadMappedFrame(reader);
+
+    // HDR 帧先色调映射为 BGRA, 算法模块统一按 8 位 BGRA 读取
+    return ReadMappedFrame([&](const FrameView& raw) {
+        WGC_TRACE_SCOPE("ToneMap");
+        size_t rowBytes = static_cast<size_t>(raw.width) * 4;
+        m_hdrFrame.resize(rowBytes * raw.height);
+        for (int y = 0; y < raw.height; y++) {
+            m_hdrConverter->ConvertRow(reinterpret_cast<const uint16_t*>(raw.Row(y)),
+                m_hdrFrame.data() + y * rowBytes, raw.width, 4);
+        }
+
+        FrameView view;
+        view.data = m_hdrFrame.data();
+        view.width = raw.width;
+        view.height = raw.height;
+        view.stride = rowBytes;
+        reader(view);
+    });
+}
+
+bool WGCWindowCapture::CopyFrame(unsigned char** outData, int* outWidth, int* outHeight, int channels,
+    FrameStatsAccumulator* stats, const FrameRect& statsRoi)
+{
+    bool copied = false;
+    bool mapped = ReadMappedFrame([&](const FrameView& frame) {
+        size_t dstRowBytes = static_cast<size_t>(frame.width) * channels;
+
+        *outData = static_cast<unsigned char*>(CoTaskMemAlloc(dstRowBytes * frame.height));
+        if (!*outData) return;
+
+        WGC_TRACE_SCOPE("RowCopy");
+        FrameRect roi = statsRoi.ClampTo(frame.width, frame.height);
+        for (int y = 0; y < frame.height; y++) {
+            unsigned char* dst = *outData + y * dstRowBytes;
+            const uint8_t* src = frame.Row(y);
+
+            if (m_hdrActive) {
+                m_hdrConverter->ConvertRow(reinterpret_cast<const uint16_t*>(src), dst, frame.width, channels);
+            } else if (channels == 4) {
+                memcpy(dst, src, dstRowBytes);
+            } else {
+                for (int x = 0; x < frame.width; x++) {
+                    dst[x * 3 + 0] = src[x * 4 + 0];
+                    dst[x * 3 + 1] = src[x * 4 + 1];
+                    dst[x * 3 + 2] = src[x * 4 + 2];
+                }
+            }
+
+            if (stats && channels == 4 && y >= roi.y && y < roi.y + roi.height) {
+                stats->AddRow(dst + static_cast<size_t>(roi.x) * 4, roi.width);
+            }
+        }
+
+        *outWidth = frame.width;
+        *outHeight = frame.height;
+        copied = true;
+    });
+
+    return mapped && copied;
+}
+
+bool WGCWindowCapture::TryGetFrame(unsigned char** outData, int* outWidth, int* outHeight,
+    FrameStatsAccumulator* stats, const FrameRect& statsRoi)
+{
+    return CopyFrame(outData, outWidth, outHeight, 4, stats, statsRoi);
+}
+
+bool WGCWindowCapture::TryGetFrameBGR(unsigned char** outData, int* outWidth, int* outHeight)
+{
+    return CopyFrame(outData, outWidth, outHeight, 3, nullptr, FrameRect());
+}
+
+bool WGCWindowCapture::TryGetProcessed(const PipelineRequest& request, unsigned char** outData,
+    PipelineLayout* outLayout, FrameStatistics* stats)
+{
+    bool processed = false;
+    bool mapped = ReadMappedFrame([&](const FrameView& frame) {
+        WGC_TRACE_SCOPE("PipelinePass");
+        PipelineLayout layout;
+        if (!ComputePipelineLayout(frame.width, frame.height, request, layout)) return;
+
+        *outData = static_cast<unsigned char*>(CoTaskMemAlloc(layout.bytes));
+        if (!*outData) return;
+
+        RunPipeline(frame, m_hdrActive ? m_hdrConverter.get() : nullptr, request, layout, *outData, stats);
+        *outLayout = layout;
+        processed = true;
+    });
+
+    return mapped && processed;
+}
+
+bool WGCWindowCapture::TryGetPyramid(unsigned char** outData, PyramidLayout* outLayout, int levels, bool includeFull)
+{
+    bool built = false;
+    bool mapped = ReadMappedFrame([&](const FrameView& frame) {
+        WGC_TRACE_SCOPE("PyramidPass");
+        PyramidLayout layout = ComputePyramidLayout(frame.width, frame.height, levels, includeFull);
+        if (layout.totalBytes == 0) return;
+
+        *outData = static_cast<unsigned char*>(CoTaskMemAlloc(layout.totalBytes));
+        if (!*outData) return;
+
+        PyramidBuilder builder(layout, *outData);
+        size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+        if (m_hdrActive) m_pyramidRows.resize(rowBytes * 2);
+
+        for (int y = 0; y < frame.height; y++) {
+            const uint8_t* row = frame.Row(y);
+            if (m_hdrActive) {
+                // 构建器需要上一行保持有效, 两行暂存区交替使用
+                uint8_t* scratch = m_pyramidRows.data() + (y & 1) * rowBytes;
+                m_hdrConverter->ConvertRow(reinterpret_cast<const uint16_t*>(row), scratch, frame.width, 4);
+                row = scratch;
+            }
+            builder.AddRow(row);
+        }
+
+        *outLayout = layout;
+        built = true;
+    });
+
+    return mapped && built;
+}
+
+bool WGCWindowCapture::ComputeFrameHash(uint64_t* outHash)
+{
+    return ReadLatestFrame([&](const FrameView& frame) {
+        *outHash = ComputeDHash(frame);
+    });
+}
+
+bool WGCWindowCapture::ComputeFrameStats(const FrameRect& roi, int flags, FrameStatistics* outStats)
+{
+    return ReadLatestFrame([&](const FrameView& frame) {
+        ::ComputeFrameStats(frame, roi, flags, *outStats);
+    });
+}
+
+int WGCWindowCapture::AddFrameListener(FrameListener listener, RegionQuery regions)
+{
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    int id = m_nextListenerId++;
+    m_listeners[id] = ListenerEntry{ std::move(listener), std::move(regions) };
+    if (m_isCapturing && !m_stopReadback) StartReadbackThreadLocked();
+    return id;
+}
+
+void WGCWindowCapture::RemoveFrameListener(int id)
+{
+    // 读回线程回调期间持有 m_listenerMutex, 返回后不会再收到该监听者的回调
+    std::lock_guard<std::mutex> lock(m_listenerMutex);
+    m_listeners.erase(id);
+}
+
+void WGCWindowCapture::TransferFrameListeners(WGCWindowCapture& target)
+{
+    if (&target == this) return;
+
+    std::scoped_lock lock(m_listenerMutex, target.m_listenerMutex);
+    for (auto& [id, entry] : m_listeners) {
+        target.m_listeners[id] = std::move(entry);
     }
+    m_listeners.clear();
+    target.m_nextListenerId = std::max(target.m_nextListenerId, m_nextListenerId);
 
-    size_t rowPitch = mapped.RowPitch;
-    for (int y = 0; y < m_textureHeight; y++) {
-        unsigned char* src = static_cast<unsigned char*>(mapped.pData) + y * rowPitch;
-        unsigned char* dst = *outData + y * m_textureWidth * 4;
-        memcpy(dst, src, m_textureWidth * 4);
+    if (!target.m_listeners.empty() && target.m_isCapturing && !target.m_stopReadback) {
+        target.StartReadbackThreadLocked();
     }
+}
 
-    m_d3dContext->Unmap(stagingTexture.get(), 0);
+size_t WGCWindowCapture::EstimatedMemoryBytes() const
+{
+    size_t bytesPerPixel = m_hdrActive ? 8 : 4;
+    // 两张暂存纹理 + 帧池的两块缓冲
+    return static_cast<size_t>(m_textureWidth) * m_textureHeight * bytesPerPixel * 4;
+}
 
-    *outWidth = m_textureWidth;
-    *outHeight = m_textureHeight;
-    
-    return true;
-}
\ No newline at end of file
+void WGCWindowCapture::StartReadbackThreadLocked()
+{
+    if (!m_readbackThread.joinable()) {
+        m_readbackThread = std::thread(&WGCWindowCapture::ReadbackLoop, this);
+    }
+}
+
+void WGCWindowCapture::ReadbackLoop()
+{
+    int lastFrame = m_frameCount.load();
+
+    std::unique_lock<std::mutex> lock(m_listenerMutex);
+    while (!m_stopReadback) {
+        // FrameArrived 不持有 m_listenerMutex 发通知, 用超时兜底丢失的唤醒
+        m_frameCv.wait_for(lock, std::chrono::milliseconds(50), [&] {
+            return m_stopReadback || m_frameCount.load() != lastFrame;
+        });
+        if (m_stopReadback) break;
+        if (m_listeners.empty() || m_frameCount.load() == lastFrame) continue;
+
+        lastFrame = m_frameCount.load();
+        int64_t timestampMs = m_lastFrameTimeMs.load();
+
+        // 只读回监听者需要的区域 (如触发条件的 ROI), 持有帧锁的时间随之缩短; 任一监听者需要整帧时读回整帧
+        bool wholeFrame = false;
+        m_listenerRegions.clear();
+        for (auto& [id, entry] : m_listeners) {
+            if (entry.regions) {
+                entry.regions(m_listenerRegions);
+            } else {
+                wholeFrame = true;
+            }
+        }
+        if (wholeFrame) m_listenerRegions.assign(1, FrameRect{});
+        if (m_listenerRegions.empty()) continue;
+
+        WGC_TRACE_SCOPE("ListenerReadback");
+        FrameView copy;
+        bool ok = ReadMappedFrame([&](const FrameView& raw) {
+            size_t rowBytes = static_cast<size_t>(raw.width) * 4;
+            m_listenerFrame.resize(rowBytes * raw.height);
+            for (const FrameRect& region : m_listenerRegions) {
+                FrameRect r = region.ClampTo(raw.width, raw.height);
+                if (r.IsEmpty()) continue;
+                for (int y = r.y; y < r.y + r.height; y++) {
+                    uint8_t* dst = m_listenerFrame.data() + y * rowBytes + static_cast<size_t>(r.x) * 4;
+                    if (m_hdrActive) {
+                        // HDR 帧只色调映射需要的列
+                        m_hdrConverter->ConvertRow(reinterpret_cast<const uint16_t*>(raw.Row(y)) + static_cast<size_t>(r.x) * 4,
+                            dst, r.width, 4);
+                    } else {
+                        memcpy(dst, raw.Row(y) + static_cast<size_t>(r.x) * 4, static_cast<size_t>(r.width) * 4);
+                    }
+                }
+            }
+            copy.data = m_listenerFrame.data();
+            copy.width = raw.width;
+            copy.height = raw.height;
+            copy.stride = rowBytes;
+        });
+        if (!ok) continue;
+
+        WGC_TRACE_SCOPE("FrameListeners");
+        for (auto& [id, entry] : m_listeners) {
+            try {
+                entry.callback(copy, timestampMs);
+            } catch (...) {
+            }
+        }
+    }
+}
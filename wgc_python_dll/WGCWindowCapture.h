@@ -1,5 +1,10 @@
 #pragma once
 #include "pch.h"
+#include "FrameView.h"
+#include "FrameStats.h"
+#include "HdrConvert.h"
+#include "ImagePyramid.h"
+#include "ReadbackPipeline.h"
 
 namespace winrt
 {
@@ -16,20 +21,58 @@ public:
     WGCWindowCapture();
     ~WGCWindowCapture();
 
-    bool Initialize(std::string* outError = nullptr);
+    // sharedDevice 非空时复用该设备 (需已开启多线程保护), 否则创建独立设备
+    bool Initialize(std::string* outError = nullptr, ID3D11Device* sharedDevice = nullptr);
     void Cleanup();
 
     bool StartContinuousCapture(HWND hwnd, std::string* outError = nullptr);
     void StopContinuousCapture();
-    bool TryGetFrame(unsigned char** outData, int* outWidth, int* outHeight);
+    // stats 非空时在逐行拷贝的同一遍内累加 statsRoi 区域的统计量
+    bool TryGetFrame(unsigned char** outData, int* outWidth, int* outHeight,
+        FrameStatsAccumulator* stats = nullptr, const FrameRect& statsRoi = {});
+    bool TryGetFrameBGR(unsigned char** outData, int* outWidth, int* outHeight);
+    // 读回原图的同一遍内生成 1/2, 1/4, 1/8 金字塔, 连续存放于一块内存
+    bool TryGetPyramid(unsigned char** outData, PyramidLayout* outLayout, int levels, bool includeFull);
+    // 裁剪/转换/缩小/统计融合为一遍读回, stats 仅在 request.stats 时写入
+    bool TryGetProcessed(const PipelineRequest& request, unsigned char** outData, PipelineLayout* outLayout,
+        FrameStatistics* stats);
+    
+    // 持锁映射最新帧并直接读取, 避免整帧复制
+    bool ReadLatestFrame(const std::function<void(const FrameView&)>& reader);
+    bool ComputeFrameHash(uint64_t* outHash);
+    bool ComputeFrameStats(const FrameRect& roi, int flags, FrameStatistics* outStats);
+    
+    // 帧监听: 有监听者时, 后台读回线程在每帧到达后复制一份 BGRA 数据并依次回调
+    // 回调在读回线程上执行, 不持有帧锁, 但应尽快返回
+    using FrameListener = std::function<void(const FrameView&, int64_t timestampMs)>;
+    // 监听者需要的帧区域, 每帧读回前查询; 只复制全部监听者所需区域, 回调收到的帧在这些区域外内容未定义
+    // 未提供查询的监听者需要整帧; 查询结果为空表示本帧不需要数据
+    using RegionQuery = std::function<void(std::vector<FrameRect>& regions)>;
+    int AddFrameListener(FrameListener listener, RegionQuery regions = nullptr);
+    void RemoveFrameListener(int id);
+    // 把全部监听者 (连同 ID) 移交给另一个会话, 切换活动会话时使用
+    void TransferFrameListeners(WGCWindowCapture& target);
     
     bool IsCapturing() const { return m_isCapturing; }
     int GetFrameCount() const { return m_frameCount.load(); }
+    int64_t GetLastFrameTimeMs() const { return m_lastFrameTimeMs.load(); }
     
     // 新增：暂停/恢复捕获
     void PauseCapture();
     void ResumeCapture();
     bool IsPaused() const { return m_isPaused; }
+    // 暂停期间保留最后一帧 (暂停前已复制的帧, 或暂停后最新到达的帧: 只持有帧池缓冲, 不复制), 恢复时立即可读
+    void SetRetainWhilePaused(bool enable) { m_retainWhilePaused = enable; }
+
+    HWND GetTargetWindow() const { return m_hwnd; }
+    // 暂存纹理 + 帧池缓冲的显存估算
+    size_t EstimatedMemoryBytes() const;
+    
+    // HDR 捕获: 下次 StartContinuousCapture 时生效, 帧池使用 R16G16B16A16Float,
+    // 读回时在去行填充的同一遍内色调映射为 8 位
+    void SetHdrCapture(bool enable) { m_hdrRequested = enable; }
+    bool IsHdrCapture() const { return m_hdrActive; }
+    void SetToneMapParams(const ToneMapParams& params);
 
     winrt::com_ptr<ID3D11Device> m_d3dDevice;
 
@@ -54,6 +97,37 @@ private:
     std::atomic<int> m_frameCount{0};
     bool m_isCapturing = false;
     bool m_isPaused = false; // 新增：暂停状态
+    bool m_retainWhilePaused = false;
+    winrt::Direct3D11CaptureFrame m_pausedFrame{ nullptr };
+    winrt::com_ptr<ID3D11Texture2D> m_pausedTexture;
+    int64_t m_pausedFrameTimeMs = 0;
+    HWND m_hwnd = nullptr;
+    bool m_hdrRequested = false;
+    bool m_hdrActive = false;
+    std::unique_ptr<HdrConverter> m_hdrConverter;
+    std::vector<uint8_t> m_hdrFrame;
+    std::vector<uint8_t> m_pyramidRows;
+    
+    std::atomic<int64_t> m_lastFrameTimeMs{0};
+    
+    std::mutex m_listenerMutex;
+    std::condition_variable m_frameCv;
+    struct ListenerEntry
+    {
+        FrameListener callback;
+        RegionQuery regions;
+    };
+    std::map<int, ListenerEntry> m_listeners;
+    int m_nextListenerId = 1;
+    bool m_stopReadback = false;
+    std::thread m_readbackThread;
+    std::vector<uint8_t> m_listenerFrame;
+    std::vector<FrameRect> m_listenerRegions;
     
     bool CreateTextures(UINT width, UINT height);
+    bool ReadMappedFrame(const std::function<void(const FrameView&)>& reader);
+    bool CopyFrame(unsigned char** outData, int* outWidth, int* outHeight, int channels,
+        FrameStatsAccumulator* stats, const FrameRect& statsRoi);
+    void StartReadbackThreadLocked();
+    void ReadbackLoop();
 };
\ No newline at end of file
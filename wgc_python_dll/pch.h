@@ -38,6 +38,10 @@
 #include <optional>
 #include <future>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <map>
+#include <functional>
 #include <string>
 
 #include <wincodec.h>